@@ -0,0 +1,109 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "trajectoryOptimization/cost.hpp"
+#include "trajectoryOptimization/dynamic.hpp"
+#include "trajectoryOptimization/problem.hpp"
+
+// Problems shared by the benchmarks: the sample's block problem in any world dimension and a
+// cart-pole swing-up, whose dynamics are nonlinear. Inline, every benchmark executable and the
+// regression harness include it; it does not need Google Benchmark.
+namespace trajectoryOptimization::benchmarkProblems {
+	using namespace trajectoryOptimization::optimizer;
+
+	const double cartMass = 1;
+	const double poleMass = 0.1;
+	const double poleHalfLength = 0.5;
+	const double gravity = 9.81;
+
+	// Position is [cart position, pole angle from hanging down], control is the force on the cart
+	inline const double* CartPoleDynamics(const double* position,
+									const unsigned positionDimension,
+									const double* velocity,
+									const unsigned velocityDimension,
+									const double* control,
+									const unsigned controlDimension) {
+		thread_local std::array<double, 2> acceleration;
+		const double sinAngle = std::sin(position[1]);
+		const double cosAngle = std::cos(position[1]);
+		const double totalMass = cartMass + poleMass;
+		const double push = (control[0] + poleMass * poleHalfLength * velocity[1] * velocity[1] * sinAngle) / totalMass;
+		acceleration[1] = (-gravity * sinAngle - cosAngle * push)
+							/ (poleHalfLength * (4.0 / 3.0 - poleMass * cosAngle * cosAngle / totalMass));
+		acceleration[0] = push - poleMass * poleHalfLength * acceleration[1] * cosAngle / totalMass;
+		return acceleration.data();
+	}
+
+	struct ProblemSize {
+		unsigned numberOfPoints;
+		unsigned positionDimension;
+		unsigned controlDimension;
+
+		unsigned getPointDimension() const {
+			return 2 * positionDimension + controlDimension;
+		}
+
+		unsigned getNumberVariables() const {
+			return numberOfPoints * getPointDimension();
+		}
+	};
+
+	using ControlCost = cost::WeightedCostSum<cost::GetControlSquareSum>;
+
+	inline ControlCost makeControlCost(const ProblemSize& size) {
+		return ControlCost(size.numberOfPoints,
+							cost::WeightedCostTerm("control", 1,
+													cost::GetControlSquareSum(size.numberOfPoints,
+																				size.getPointDimension(),
+																				size.controlDimension)));
+	}
+
+	// From rest at the origin to rest at (10, 20, 30, ...) in one time unit per interval. Each entry of
+	// waypoints is a time index the trajectory passes (-10, 20, -30, ...) at.
+	inline problem::TrajectoryProblem makeBlockProblem(const unsigned numberOfPoints,
+												const unsigned worldDimension,
+												const std::vector<unsigned>& waypoints = {}) {
+		const ProblemSize size = {numberOfPoints, worldDimension, worldDimension};
+		std::vector<double> goal(2 * worldDimension, 0);
+		std::vector<double> waypoint(worldDimension, 0);
+		for (unsigned index = 0; index < worldDimension; index++) {
+			goal[index] = 10.0 * (index + 1);
+			waypoint[index] = (index % 2 ? 10.0 : -10.0) * (index + 1);
+		}
+
+		problem::TrajectoryProblem trajectoryProblem(numberOfPoints, worldDimension, worldDimension, 1,
+														dynamic::BlockDynamics);
+		trajectoryProblem.addKinematicGoal(0, 2 * worldDimension, std::vector<double>(2 * worldDimension, 0))
+						.addKinematicGoal(numberOfPoints - 1, 2 * worldDimension, goal);
+		for (const unsigned timeIndex: waypoints) {
+			trajectoryProblem.addKinematicGoal(timeIndex, worldDimension, waypoint);
+		}
+		trajectoryProblem.setObjective(makeControlCost(size), true)
+						.setPointBounds(numberVector(size.getPointDimension(), -1000),
+										numberVector(size.getPointDimension(), 1000));
+		return trajectoryProblem;
+	}
+
+	// Swings the pole up from hanging down within the horizon; the dynamics are nonlinear, so Ipopt
+	// approximates the Hessian.
+	inline problem::TrajectoryProblem makeCartPoleProblem(const unsigned numberOfPoints, const double horizon = 2) {
+		const ProblemSize size = {numberOfPoints, 2, 1};
+		const double pi = std::acos(-1);
+
+		problem::TrajectoryProblem trajectoryProblem(numberOfPoints, 2, 1, horizon / (numberOfPoints - 1),
+														CartPoleDynamics);
+		trajectoryProblem.addKinematicGoal(0, 4, {0, 0, 0, 0})
+						.addKinematicGoal(numberOfPoints - 1, 4, {0, pi, 0, 0})
+						.setObjective(makeControlCost(size), false)
+						.setPointBounds({-2, -100, -100, -100, -20}, {2, 100, 100, 100, 20});
+
+		numberVector startingPoint(size.getNumberVariables(), 0);
+		for (unsigned timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
+			startingPoint[timeIndex * size.getPointDimension() + 1] = pi * timeIndex / (numberOfPoints - 1);
+		}
+		trajectoryProblem.setStartingPoint(startingPoint);
+		return trajectoryProblem;
+	}
+}
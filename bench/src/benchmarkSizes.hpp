@@ -0,0 +1,31 @@
+#pragma once
+#include <benchmark/benchmark.h>
+#include "benchmarkProblems.hpp"
+
+// Problem sizes as Google Benchmark arguments and counters, for the micro-benchmarks
+namespace trajectoryOptimization::benchmarkProblems {
+	// Arguments (numberOfPoints, worldDimension) of block problems, knot counts 10 to 10000 and world
+	// dimensions 1 to 12, as far as they stay within maxNumberVariables
+	template<int maxNumberVariables>
+	void sweepBlockProblems(benchmark::internal::Benchmark* benchmark) {
+		for (const int worldDimension: {1, 3, 6, 12}) {
+			for (int numberOfPoints = 10; numberOfPoints <= 10000; numberOfPoints *= 10) {
+				if (numberOfPoints * 3 * worldDimension <= maxNumberVariables) {
+					benchmark->Args({numberOfPoints, worldDimension});
+				}
+			}
+		}
+	}
+
+	inline ProblemSize getBlockSize(const benchmark::State& state) {
+		return {(unsigned) state.range(0), (unsigned) state.range(1), (unsigned) state.range(1)};
+	}
+
+	// Knots, world dimension and variables go into the output for plotting the scaling curves
+	inline void setSizeCounters(benchmark::State& state, const ProblemSize& size) {
+		state.counters["knots"] = size.numberOfPoints;
+		state.counters["worldDimension"] = size.positionDimension;
+		state.counters["variables"] = size.getNumberVariables();
+		state.SetComplexityN(size.getNumberVariables());
+	}
+}
@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "trajectoryOptimization/constraint.hpp"
+#include "benchmarkSizes.hpp"
+
+using namespace trajectoryOptimization;
+using namespace trajectoryOptimization::benchmarkProblems;
+
+static void BM_KinematicViolation(benchmark::State& state) {
+	const auto size = getBlockSize(state);
+	constraint::GetKinematicViolation getKinematicViolation(dynamic::BlockDynamics, size.getPointDimension(),
+															size.positionDimension, size.numberOfPoints / 2, 1.0);
+	const std::vector<double> x(size.getNumberVariables(), 1);
+	for (auto _: state) {
+		benchmark::DoNotOptimize(getKinematicViolation(x.data()));
+	}
+	setSizeCounters(state, size);
+}
+BENCHMARK(BM_KinematicViolation)->Apply(sweepBlockProblems<360000>);
+
+// Dynamics of every interval and both goals, stacked into Ipopt's g
+static void BM_StackConstriants(benchmark::State& state) {
+	const auto size = getBlockSize(state);
+	auto constraints = constraint::applyKinematicViolationConstraints({}, dynamic::BlockDynamics, size.getPointDimension(),
+																		size.positionDimension, 0, size.numberOfPoints - 1, 1.0);
+	for (const unsigned timeIndex: {0u, size.numberOfPoints - 1}) {
+		constraints.push_back(constraint::GetToKinematicGoal(size.numberOfPoints, size.getPointDimension(),
+																2 * size.positionDimension, timeIndex,
+																std::vector<double>(2 * size.positionDimension, 0)));
+	}
+	constraint::StackConstriants stackConstraints(size.getNumberVariables(), constraints);
+	const std::vector<double> x(size.getNumberVariables(), 1);
+	std::vector<double> g(stackConstraints.size());
+	for (auto _: state) {
+		stackConstraints(x.data(), g.data());
+		benchmark::DoNotOptimize(g.data());
+	}
+	setSizeCounters(state, size);
+	state.counters["constraints"] = g.size();
+}
+BENCHMARK(BM_StackConstriants)->Apply(sweepBlockProblems<360000>)->Complexity(benchmark::oN);
+
+static void BM_CartPoleKinematicViolation(benchmark::State& state) {
+	const ProblemSize size = {2, 2, 1};
+	constraint::GetKinematicViolation getKinematicViolation(CartPoleDynamics, size.getPointDimension(),
+															size.positionDimension, 0, 0.01);
+	const std::vector<double> x = {0, 1, 0.5, -0.5, 2, 0.1, 1.1, 0.4, -0.6, 2};
+	for (auto _: state) {
+		benchmark::DoNotOptimize(getKinematicViolation(x.data()));
+	}
+}
+BENCHMARK(BM_CartPoleKinematicViolation);
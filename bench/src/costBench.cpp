@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "trajectoryOptimization/cost.hpp"
+#include "trajectoryOptimization/derivative.hpp"
+#include "benchmarkSizes.hpp"
+
+using namespace trajectoryOptimization;
+using namespace trajectoryOptimization::benchmarkProblems;
+
+static void BM_CostValue(benchmark::State& state) {
+	const auto size = getBlockSize(state);
+	const auto controlCost = makeControlCost(size);
+	const std::vector<double> x(size.getNumberVariables(), 1);
+	for (auto _: state) {
+		benchmark::DoNotOptimize(controlCost(x.data()));
+	}
+	setSizeCounters(state, size);
+}
+BENCHMARK(BM_CostValue)->Apply(sweepBlockProblems<360000>)->Complexity(benchmark::oN);
+
+// The analytic gradient WeightedCostSum hands to Ipopt
+static void BM_CostGradient(benchmark::State& state) {
+	const auto size = getBlockSize(state);
+	const auto controlCost = makeControlCost(size);
+	const std::vector<double> x(size.getNumberVariables(), 1);
+	std::vector<double> gradient(size.getNumberVariables());
+	for (auto _: state) {
+		controlCost.gradient(x.data(), size.getNumberVariables(), gradient.data());
+		benchmark::DoNotOptimize(gradient.data());
+	}
+	setSizeCounters(state, size);
+}
+BENCHMARK(BM_CostGradient)->Apply(sweepBlockProblems<360000>)->Complexity(benchmark::oN);
+
+// Central differences over the cost's footprint, for comparison with the analytic gradient
+static void BM_NumericalCostGradient(benchmark::State& state) {
+	const auto size = getBlockSize(state);
+	const auto controlCost = makeControlCost(size);
+	const derivative::GetGradientOfVectorToDoubleFunction getGradient([&controlCost](const double* x) { return controlCost(x); },
+																		size.getNumberVariables(),
+																		controlCost.footprint());
+	const std::vector<double> x(size.getNumberVariables(), 1);
+	std::vector<double> gradient(size.getNumberVariables());
+	for (auto _: state) {
+		getGradient(x.data(), gradient.data());
+		benchmark::DoNotOptimize(gradient.data());
+	}
+	setSizeCounters(state, size);
+}
+// Quadratic: every partial evaluates the whole cost
+BENCHMARK(BM_NumericalCostGradient)->Apply(sweepBlockProblems<36000>)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "trajectoryOptimization/constraint.hpp"
+#include "trajectoryOptimization/derivative.hpp"
+#include "benchmarkSizes.hpp"
+
+using namespace trajectoryOptimization;
+using namespace trajectoryOptimization::benchmarkProblems;
+
+namespace {
+	derivative::VectorToVectorFunction makeDynamicsConstraints(const ProblemSize& size) {
+		const auto constraints = std::make_shared<std::vector<constraint::ConstraintFunction>>(
+			constraint::applyKinematicViolationConstraints({}, dynamic::BlockDynamics, size.getPointDimension(),
+															size.positionDimension, 0, size.numberOfPoints - 1, 1.0));
+		const auto stack = std::make_shared<constraint::StackConstriants>(size.getNumberVariables(), *constraints);
+		return [constraints, stack](const double* x) { return (*stack)(x); };
+	}
+}
+
+static void BM_PartialDerivativeOfVectorToDoubleFunction(benchmark::State& state) {
+	const auto size = getBlockSize(state);
+	const auto controlCost = makeControlCost(size);
+	const derivative::GetPartialDerivativeOfVectorToDoubleFunction getPartialDerivative(
+		[&controlCost](const double* x) { return controlCost(x); }, size.getNumberVariables());
+	const std::vector<double> x(size.getNumberVariables(), 1);
+	const unsigned partialIndex = size.getPointDimension() - 1;
+	for (auto _: state) {
+		benchmark::DoNotOptimize(getPartialDerivative(x.data(), partialIndex));
+	}
+	setSizeCounters(state, size);
+}
+BENCHMARK(BM_PartialDerivativeOfVectorToDoubleFunction)->Apply(sweepBlockProblems<360000>);
+
+static void BM_PartialDerivativeOfVectorToVectorFunction(benchmark::State& state) {
+	const auto size = getBlockSize(state);
+	const derivative::GetPartialDerivativeOfVectorToVectorFunction getPartialDerivative(makeDynamicsConstraints(size),
+																						size.getNumberVariables());
+	const std::vector<double> x(size.getNumberVariables(), 1);
+	for (auto _: state) {
+		benchmark::DoNotOptimize(getPartialDerivative(x.data(), 0));
+	}
+	setSizeCounters(state, size);
+}
+BENCHMARK(BM_PartialDerivativeOfVectorToVectorFunction)->Apply(sweepBlockProblems<360000>);
+
+// Sparsity detection and the Jacobian evaluate all constraints once per column, quadratic in the
+// number of variables, so the sweep stops at a few thousand of them.
+static void BM_SparsityDetection(benchmark::State& state) {
+	const auto size = getBlockSize(state);
+	const derivative::GetSparsityPatternOfVectorToVectorFunction getSparsityPattern(makeDynamicsConstraints(size),
+																					size.getNumberVariables());
+	for (auto _: state) {
+		benchmark::DoNotOptimize(getSparsityPattern());
+	}
+	setSizeCounters(state, size);
+}
+BENCHMARK(BM_SparsityDetection)->Apply(sweepBlockProblems<3000>)->Unit(benchmark::kMillisecond);
+
+static void BM_Jacobian(benchmark::State& state) {
+	const auto size = getBlockSize(state);
+	const auto constraints = makeDynamicsConstraints(size);
+	const auto [jacobianRows, jacobianCols] =
+		derivative::GetSparsityPatternOfVectorToVectorFunction(constraints, size.getNumberVariables())();
+	const derivative::GetJacobianOfVectorToVectorFunctionUsingSparsityPattern getJacobian(constraints,
+																							size.getNumberVariables(),
+																							jacobianRows,
+																							jacobianCols);
+	const std::vector<double> x(size.getNumberVariables(), 1);
+	std::vector<double> jacobian(jacobianRows.size());
+	for (auto _: state) {
+		getJacobian(x.data(), jacobian.data());
+		benchmark::DoNotOptimize(jacobian.data());
+	}
+	setSizeCounters(state, size);
+	state.counters["nonzeros"] = jacobianRows.size();
+}
+BENCHMARK(BM_Jacobian)->Apply(sweepBlockProblems<3000>)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,336 @@
+#include "coin/IpIpoptApplication.hpp"
+#include "coin/IpSolveStatistics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+#include "trajectoryOptimization/instrumentation.hpp"
+#include "trajectoryOptimization/problem.hpp"
+#include "benchmarkProblems.hpp"
+
+using namespace Ipopt;
+using namespace trajectoryOptimization;
+using namespace trajectoryOptimization::benchmarkProblems;
+
+// Solves a fixed set of problems, records wall time, Ipopt iterations, callback counts and peak
+// memory per problem, and compares them with a baseline. Exits with 1 if any problem got slower,
+// needs more iterations or callbacks, uses more memory than the tolerances allow or stops solving,
+// otherwise with skipReturnCode if a problem has no baseline row yet, which CTest reports as skipped.
+//
+//   regressionHarness --baseline <csv> [--output <csv>] [--problem <name>] [--repetitions <n>]
+//                     [--time-tolerance <fraction>] [--count-tolerance <fraction>]
+//                     [--memory-tolerance <fraction>] [--write-baseline]
+//
+// --write-baseline writes the measurements to the baseline file instead of comparing, on the
+// machine the baseline is meant for. They replace the rows of the measured problems, so with
+// --problem the other rows and the file's comments stay as they were.
+
+namespace {
+	// Matches SKIP_RETURN_CODE of the regression tests in bench/CMakeLists.txt
+	const int skipReturnCode = 77;
+
+	const std::vector<std::string> columns = {"problem", "status", "wallSeconds", "iterations", "eval_f", "eval_grad_f",
+												"eval_g", "eval_jac_g", "eval_h", "peakRssKilobytes"};
+
+	struct Measurement {
+		std::string problem;
+		int status;
+		double wallSeconds;
+		double iterations;
+		double evalF;
+		double evalGradF;
+		double evalG;
+		double evalJacG;
+		double evalH;
+		double peakRssKilobytes;
+	};
+
+	struct RegressionProblem {
+		std::string name;
+		std::function<problem::TrajectoryProblem()> makeProblem;
+	};
+
+	const std::vector<RegressionProblem> regressionProblems = {
+		{"block", []() { return makeBlockProblem(50, 3, {25}); }},
+		{"blockWaypoints", []() { return makeBlockProblem(60, 3, {15, 30, 45}); }},
+		{"blockLongHorizon", []() { return makeBlockProblem(300, 3); }},
+		{"blockLongHorizonOneDimension", []() { return makeBlockProblem(1000, 1); }},
+		{"cartPole", []() { return makeCartPoleProblem(50); }},
+	};
+
+	// Linux keeps the high-water mark of the resident set in VmHWM and resets it through clear_refs,
+	// which gives a peak per problem; elsewhere it is the peak of the whole process so far.
+	void resetPeakRss() {
+		std::ofstream clearRefs("/proc/self/clear_refs");
+		clearRefs << "5";
+	}
+
+	double getPeakRssKilobytes() {
+		std::ifstream status("/proc/self/status");
+		std::string line;
+		while (std::getline(status, line)) {
+			if (line.rfind("VmHWM:", 0) == 0) {
+				return std::atof(line.c_str() + 6);
+			}
+		}
+		struct rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return usage.ru_maxrss;
+	}
+
+	// Wall time is the fastest of the repetitions, everything else comes from the last one
+	Measurement measure(const RegressionProblem& regressionProblem, const unsigned repetitions) {
+		const FinalizerFunction ignoreSolution = [](SolverReturn status, Index n, const Number* x,
+													const Number* zLower, const Number* zUpper,
+													Index m, const Number* g, const Number* lambda,
+													Number objValue, const IpoptData* ipData,
+													IpoptCalculatedQuantities* ipCalculatedQuantities) {};
+		SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
+		app->Options()->SetIntegerValue("print_level", 0);
+		app->Options()->SetStringValue("mu_strategy", "adaptive");
+		app->Options()->SetNumericValue("tol", 1e-8);
+		app->Initialize();
+
+		resetPeakRss();
+		Measurement measurement = {regressionProblem.name, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+		for (unsigned repetition = 0; repetition < repetitions; repetition++) {
+			// A fresh cache, so building the structure is part of every measurement
+			problem::StructureCache structureCache;
+			const auto instrumentation = std::make_shared<instrumentation::Instrumentation>();
+
+			const auto start = std::chrono::steady_clock::now();
+			SmartPtr<TrajectoryOptimizer> trajectoryOptimizer = regressionProblem.makeProblem().build(ignoreSolution,
+																										structureCache);
+			trajectoryOptimizer->setInstrumentation(instrumentation);
+			setHessianApproximation(app, trajectoryOptimizer->getSparsityStructure());
+			measurement.status = app->OptimizeTNLP(trajectoryOptimizer);
+			const std::chrono::duration<double> wallTime = std::chrono::steady_clock::now() - start;
+
+			measurement.wallSeconds = repetition ? std::min(measurement.wallSeconds, wallTime.count()) : wallTime.count();
+			measurement.iterations = IsValid(app->Statistics()) ? app->Statistics()->IterationCount() : 0;
+			measurement.evalF = instrumentation->getCallback(instrumentation::EVAL_F).calls;
+			measurement.evalGradF = instrumentation->getCallback(instrumentation::EVAL_GRAD_F).calls;
+			measurement.evalG = instrumentation->getCallback(instrumentation::EVAL_G).calls;
+			measurement.evalJacG = instrumentation->getCallback(instrumentation::EVAL_JAC_G).calls;
+			measurement.evalH = instrumentation->getCallback(instrumentation::EVAL_H).calls;
+		}
+		measurement.peakRssKilobytes = getPeakRssKilobytes();
+		return measurement;
+	}
+
+	void writeCsv(std::ostream& stream, const std::vector<Measurement>& measurements) {
+		for (unsigned column = 0; column < columns.size(); column++) {
+			stream << (column ? "," : "") << columns[column];
+		}
+		stream << '\n';
+		for (const auto& m: measurements) {
+			stream << m.problem << ',' << m.status << ',' << m.wallSeconds << ',' << m.iterations << ','
+					<< m.evalF << ',' << m.evalGradF << ',' << m.evalG << ',' << m.evalJacG << ',' << m.evalH << ','
+					<< m.peakRssKilobytes << '\n';
+		}
+	}
+
+	// Rows by problem; lines starting with # are comments
+	bool readCsv(const std::string& filename, std::map<std::string, Measurement>& measurements) {
+		std::ifstream file(filename);
+		if (!file) {
+			return false;
+		}
+		std::string line;
+		bool header = true;
+		while (std::getline(file, line)) {
+			if (line.empty() || line[0] == '#') {
+				continue;
+			}
+			if (header) {
+				header = false;
+				continue;
+			}
+			std::istringstream fields(line);
+			Measurement m;
+			std::string field;
+			std::getline(fields, m.problem, ',');
+			double* values[] = {&m.wallSeconds, &m.iterations, &m.evalF, &m.evalGradF, &m.evalG, &m.evalJacG, &m.evalH,
+								&m.peakRssKilobytes};
+			std::getline(fields, field, ',');
+			m.status = std::atoi(field.c_str());
+			for (double* value: values) {
+				if (!std::getline(fields, field, ',')) {
+					return false;
+				}
+				*value = std::atof(field.c_str());
+			}
+			measurements[m.problem] = m;
+		}
+		return true;
+	}
+
+	std::vector<std::string> readComments(const std::string& filename) {
+		std::ifstream file(filename);
+		std::vector<std::string> comments;
+		std::string line;
+		while (std::getline(file, line)) {
+			if (!line.empty() && line[0] == '#') {
+				comments.push_back(line);
+			}
+		}
+		return comments;
+	}
+
+	// Those of regressionProblems in their order, then any others
+	std::vector<Measurement> orderRows(std::map<std::string, Measurement> rows) {
+		std::vector<Measurement> orderedRows;
+		for (const auto& regressionProblem: regressionProblems) {
+			const auto row = rows.find(regressionProblem.name);
+			if (row != rows.end()) {
+				orderedRows.push_back(row->second);
+				rows.erase(row);
+			}
+		}
+		for (const auto& row: rows) {
+			orderedRows.push_back(row.second);
+		}
+		return orderedRows;
+	}
+
+	struct Tolerances {
+		double time = 0.25;
+		double count = 0.1;
+		double memory = 0.2;
+		// Below these absolute differences timer and allocator noise dominate
+		double timeSlackSeconds = 0.005;
+		double memorySlackKilobytes = 2048;
+	};
+
+	bool isSolved(const Measurement& measurement) {
+		return measurement.status == Solve_Succeeded || measurement.status == Solved_To_Acceptable_Level;
+	}
+
+	// Prints a line per metric that is out of tolerance, true if there is none
+	bool compare(const Measurement& current, const Measurement& baseline, const Tolerances& tolerances) {
+		bool withinTolerance = true;
+		const auto check = [&](const char* metric, const double value, const double baselineValue,
+								const double tolerance, const double slack) {
+			if (value > baselineValue * (1 + tolerance) + slack) {
+				std::cout << "REGRESSION " << current.problem << ' ' << metric << ": " << value
+							<< " (baseline " << baselineValue << ", tolerance " << tolerance * 100 << "%)" << std::endl;
+				withinTolerance = false;
+			}
+		};
+		check("wallSeconds", current.wallSeconds, baseline.wallSeconds, tolerances.time, tolerances.timeSlackSeconds);
+		check("iterations", current.iterations, baseline.iterations, tolerances.count, 0);
+		check("eval_f", current.evalF, baseline.evalF, tolerances.count, 0);
+		check("eval_grad_f", current.evalGradF, baseline.evalGradF, tolerances.count, 0);
+		check("eval_g", current.evalG, baseline.evalG, tolerances.count, 0);
+		check("eval_jac_g", current.evalJacG, baseline.evalJacG, tolerances.count, 0);
+		check("eval_h", current.evalH, baseline.evalH, tolerances.count, 0);
+		check("peakRssKilobytes", current.peakRssKilobytes, baseline.peakRssKilobytes, tolerances.memory,
+				tolerances.memorySlackKilobytes);
+		return withinTolerance;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+  std::string baselineFilename;
+  std::string outputFilename = "regressionResults.csv";
+  std::string problemName;
+  unsigned repetitions = 3;
+  bool writeBaseline = false;
+  Tolerances tolerances;
+
+  for (int argument = 1; argument < argc; argument++) {
+    const bool hasValue = argument + 1 < argc;
+    if (!std::strcmp(argv[argument], "--baseline") && hasValue) {
+      baselineFilename = argv[++argument];
+    } else if (!std::strcmp(argv[argument], "--output") && hasValue) {
+      outputFilename = argv[++argument];
+    } else if (!std::strcmp(argv[argument], "--problem") && hasValue) {
+      problemName = argv[++argument];
+    } else if (!std::strcmp(argv[argument], "--repetitions") && hasValue) {
+      repetitions = std::max(1, std::atoi(argv[++argument]));
+    } else if (!std::strcmp(argv[argument], "--time-tolerance") && hasValue) {
+      tolerances.time = std::atof(argv[++argument]);
+    } else if (!std::strcmp(argv[argument], "--count-tolerance") && hasValue) {
+      tolerances.count = std::atof(argv[++argument]);
+    } else if (!std::strcmp(argv[argument], "--memory-tolerance") && hasValue) {
+      tolerances.memory = std::atof(argv[++argument]);
+    } else if (!std::strcmp(argv[argument], "--write-baseline")) {
+      writeBaseline = true;
+    } else {
+      std::cerr << "unknown argument " << argv[argument] << std::endl;
+      return 2;
+    }
+  }
+  if (baselineFilename.empty()) {
+    std::cerr << "usage: " << argv[0] << " --baseline <csv> [--output <csv>] [--problem <name>] [--repetitions <n>]"
+              << " [--time-tolerance <fraction>] [--count-tolerance <fraction>] [--memory-tolerance <fraction>]"
+              << " [--write-baseline]" << std::endl;
+    return 2;
+  }
+
+  std::vector<Measurement> measurements;
+  for (const auto& regressionProblem: regressionProblems) {
+    if (problemName.empty() || problemName == regressionProblem.name) {
+      measurements.push_back(measure(regressionProblem, repetitions));
+    }
+  }
+  if (measurements.empty()) {
+    std::cerr << "no problem named " << problemName << std::endl;
+    return 2;
+  }
+
+  writeCsv(std::cout, measurements);
+  std::map<std::string, Measurement> baselines;
+  const bool hasBaseline = static_cast<bool>(std::ifstream(baselineFilename));
+  if ((hasBaseline || !writeBaseline) && !readCsv(baselineFilename, baselines)) {
+    std::cerr << "cannot read baseline " << baselineFilename << std::endl;
+    return 2;
+  }
+
+  if (writeBaseline) {
+    const auto comments = readComments(baselineFilename);
+    for (const auto& measurement: measurements) {
+      baselines[measurement.problem] = measurement;
+    }
+    std::ofstream output(baselineFilename, std::ios::out | std::ios::trunc);
+    for (const auto& comment: comments) {
+      output << comment << '\n';
+    }
+    writeCsv(output, orderRows(baselines));
+    return std::all_of(measurements.begin(), measurements.end(), isSolved) ? 0 : 1;
+  }
+
+  std::ofstream output(outputFilename, std::ios::out | std::ios::trunc);
+  writeCsv(output, measurements);
+  bool withinTolerance = true;
+  bool missingBaseline = false;
+  for (const auto& measurement: measurements) {
+    if (!isSolved(measurement)) {
+      std::cout << "REGRESSION " << measurement.problem << " not solved, status " << measurement.status << std::endl;
+      withinTolerance = false;
+      continue;
+    }
+    const auto baseline = baselines.find(measurement.problem);
+    if (baseline == baselines.end()) {
+      std::cout << "SKIPPED " << measurement.problem << " has no baseline row" << std::endl;
+      missingBaseline = true;
+      continue;
+    }
+    withinTolerance = compare(measurement, baseline->second, tolerances) && withinTolerance;
+  }
+  if (!withinTolerance) {
+    return 1;
+  }
+  return missingBaseline ? skipReturnCode : 0;
+}
@@ -0,0 +1,65 @@
+#include "coin/IpIpoptApplication.hpp"
+#include "coin/IpSolveStatistics.hpp"
+#include <benchmark/benchmark.h>
+#include "trajectoryOptimization/problem.hpp"
+#include "benchmarkSizes.hpp"
+
+using namespace Ipopt;
+using namespace trajectoryOptimization;
+using namespace trajectoryOptimization::benchmarkProblems;
+
+namespace {
+	// The stacked structure is built once per problem size, outside of the timed solves
+	problem::StructureCache structureCache;
+
+	// Problems without an exact Hessian, like the cart-pole, get Ipopt's limited-memory approximation
+	SmartPtr<IpoptApplication> makeApplication(const SparsityStructure& sparsityStructure) {
+		SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
+		setHessianApproximation(app, sparsityStructure);
+		app->Options()->SetIntegerValue("print_level", 0);
+		app->Options()->SetStringValue("mu_strategy", "adaptive");
+		app->Options()->SetNumericValue("tol", 1e-8);
+		app->Initialize();
+		return app;
+	}
+
+	void solve(benchmark::State& state, const problem::TrajectoryProblem& trajectoryProblem) {
+		const FinalizerFunction ignoreSolution = [](SolverReturn status, Index n, const Number* x,
+													const Number* zLower, const Number* zUpper,
+													Index m, const Number* g, const Number* lambda,
+													Number objValue, const IpoptData* ipData,
+													IpoptCalculatedQuantities* ipCalculatedQuantities) {};
+		const auto functions = trajectoryProblem.getFunctions(structureCache);
+		const auto app = makeApplication(*functions.structure->sparsityStructure);
+
+		ApplicationReturnStatus status = Solve_Succeeded;
+		for (auto _: state) {
+			state.PauseTiming();
+			SmartPtr<TrajectoryOptimizer> trajectoryOptimizer = trajectoryProblem.build(ignoreSolution, structureCache);
+			state.ResumeTiming();
+			status = app->OptimizeTNLP(trajectoryOptimizer);
+		}
+		// An acceptable point stops early, its time is not comparable to a full solve
+		if (status != Solve_Succeeded) {
+			state.SkipWithError("Ipopt did not converge");
+			return;
+		}
+		state.counters["iterations"] = app->Statistics()->IterationCount();
+	}
+}
+
+// The sample's problem with block dynamics, linear constraints and an exact Hessian
+static void BM_BlockSolve(benchmark::State& state) {
+	const auto size = getBlockSize(state);
+	solve(state, makeBlockProblem(size.numberOfPoints, size.positionDimension));
+	setSizeCounters(state, size);
+}
+// Each Ipopt iteration evaluates the finite-difference Jacobian, quadratic in the number of variables
+BENCHMARK(BM_BlockSolve)->Apply(sweepBlockProblems<12000>)->Unit(benchmark::kMillisecond);
+
+static void BM_CartPoleSolve(benchmark::State& state) {
+	const ProblemSize size = {(unsigned) state.range(0), 2, 1};
+	solve(state, makeCartPoleProblem(size.numberOfPoints));
+	setSizeCounters(state, size);
+}
+BENCHMARK(BM_CartPoleSolve)->Arg(10)->Arg(20)->Arg(50)->Arg(100)->Arg(200)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,153 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace trajectoryOptimization::arena {
+	const std::size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+	struct ArenaStatistics {
+		unsigned long allocations;
+		unsigned long bytesAllocated;
+		// Most bytes handed out and not yet released at any one time
+		unsigned long peakBytes;
+		// Heap allocations the arena made itself; none once it has grown to a callback's working set
+		unsigned long blockAllocations;
+		unsigned long releases;
+	};
+
+	// Monotonic memory for temporaries: allocating moves a pointer, nothing is freed on its own and
+	// release hands back everything allocated after a mark at once. Releasing down to empty after
+	// the arena overflowed into several blocks merges them into one, so the next round of the same
+	// allocations stays in one block without touching the heap. Not thread safe, one per thread.
+	class Arena {
+		struct Block {
+			std::unique_ptr<std::byte[]> memory;
+			std::size_t size;
+		};
+
+		std::vector<Block> blocks;
+		std::size_t blockIndex;
+		std::size_t offset;
+		std::size_t bytesInUse;
+		ArenaStatistics statistics;
+
+		void addBlock(const std::size_t size) {
+			blocks.push_back({std::make_unique<std::byte[]>(size), size});
+			statistics.blockAllocations++;
+		}
+
+		public:
+			struct Marker {
+				std::size_t blockIndex;
+				std::size_t offset;
+				std::size_t bytesInUse;
+			};
+
+			explicit Arena(const std::size_t initialBlockSize = DEFAULT_BLOCK_SIZE):
+				blockIndex(0),
+				offset(0),
+				bytesInUse(0),
+				statistics({0, 0, 0, 0, 0}) {
+					addBlock(std::max<std::size_t>(initialBlockSize, 1));
+				}
+
+			Arena(const Arena&) = delete;
+			Arena& operator=(const Arena&) = delete;
+
+			void* allocate(const std::size_t bytes, const std::size_t alignment = alignof(std::max_align_t)) {
+				assert(alignment && !(alignment & (alignment - 1)));
+				for (;;) {
+					const Block& block = blocks[blockIndex];
+					const auto address = reinterpret_cast<std::uintptr_t>(block.memory.get()) + offset;
+					const std::size_t padding = (alignment - address % alignment) % alignment;
+					if (offset + padding + bytes <= block.size) {
+						offset += padding + bytes;
+						bytesInUse += padding + bytes;
+						statistics.allocations++;
+						statistics.bytesAllocated += bytes;
+						statistics.peakBytes = std::max<unsigned long>(statistics.peakBytes, bytesInUse);
+						return block.memory.get() + offset - bytes;
+					}
+					// The rest of this block is skipped, it counts as in use until released
+					bytesInUse += block.size - offset;
+					const std::size_t nextBlockSize = std::max(2 * block.size, bytes + alignment);
+					if (++blockIndex == blocks.size()) {
+						addBlock(nextBlockSize);
+					}
+					offset = 0;
+				}
+			}
+
+			// Uninitialized room for count values of T
+			template <typename T>
+			T* allocate(const std::size_t count) {
+				return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+			}
+
+			Marker mark() const {
+				return {blockIndex, offset, bytesInUse};
+			}
+
+			void release(const Marker& marker) {
+				assert(marker.blockIndex < blockIndex || (marker.blockIndex == blockIndex && marker.offset <= offset));
+				blockIndex = marker.blockIndex;
+				offset = marker.offset;
+				bytesInUse = marker.bytesInUse;
+				statistics.releases++;
+				if (!bytesInUse && blocks.size() > 1) {
+					const std::size_t mergedSize = capacity();
+					blocks.clear();
+					addBlock(mergedSize);
+				}
+			}
+
+			void reset() {
+				release({0, 0, 0});
+			}
+
+			std::size_t capacity() const {
+				std::size_t capacity = 0;
+				for (const auto& block: blocks) {
+					capacity += block.size;
+				}
+				return capacity;
+			}
+
+			const ArenaStatistics& getStatistics() const { return statistics; }
+
+			void resetStatistics() {
+				statistics = {0, 0, bytesInUse, 0, 0};
+			}
+	};
+
+	// The calling thread's arena, what the derivative, constraint and cost layers take temporaries from
+	Arena& getThreadArena();
+
+	// Releases everything allocated within its lifetime, e.g. around an Ipopt callback. Scopes nest,
+	// an inner one only hands back its own allocations.
+	class ArenaScope {
+		Arena& arena;
+		const Arena::Marker marker;
+
+		public:
+			explicit ArenaScope(Arena& arena = getThreadArena()):
+				arena(arena),
+				marker(arena.mark()) {}
+
+			~ArenaScope() {
+				arena.release(marker);
+			}
+
+			ArenaScope(const ArenaScope&) = delete;
+			ArenaScope& operator=(const ArenaScope&) = delete;
+
+			template <typename T>
+			T* allocate(const std::size_t count) {
+				return arena.allocate<T>(count);
+			}
+	};
+}
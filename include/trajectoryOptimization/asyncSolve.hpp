@@ -0,0 +1,116 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include "coin/IpIpoptApplication.hpp"
+#include "optimizer.hpp"
+
+namespace trajectoryOptimization::async {
+	using namespace trajectoryOptimization::optimizer;
+	using Clock = std::chrono::steady_clock;
+
+	struct Iterate {
+		Index iteration;
+		Number objectiveValue;
+		Number primalInfeasibility;
+		numberVector x;
+	};
+
+	// Feasible iterates beat infeasible ones; among feasible ones the lower objective wins, among
+	// infeasible ones the lower infeasibility.
+	bool isBetterIterate(const Iterate& candidate, const Iterate& incumbent, const Number feasibilityTolerance);
+
+	enum StopReason {
+		FINISHED,
+		CANCELLED,
+		DEADLINE_REACHED
+	};
+
+	struct AsyncResult {
+		ApplicationReturnStatus status;
+		StopReason stopReason;
+		// What finalize_solution received, on an early stop the last iterate
+		PrimalDualPoint solution;
+		std::optional<Iterate> bestIterate;
+		double seconds;
+	};
+
+	namespace detail {
+		struct SharedState {
+			const Clock::time_point deadline;
+			const Number feasibilityTolerance;
+			std::atomic<bool> cancelRequested;
+			std::atomic<bool> deadlineReached;
+			mutable std::mutex mutex;
+			std::optional<Iterate> bestIterate;
+
+			SharedState(const Clock::time_point deadline, const Number feasibilityTolerance):
+				deadline(deadline),
+				feasibilityTolerance(feasibilityTolerance),
+				cancelRequested(false),
+				deadlineReached(false) {}
+		};
+	}
+
+	// Owns a running solve. Destroying it cancels the solve and waits for the worker to return.
+	class SolveHandle {
+		std::shared_ptr<detail::SharedState> state;
+		std::future<AsyncResult> result;
+
+		public:
+			SolveHandle(const std::shared_ptr<detail::SharedState> state, std::future<AsyncResult>&& result):
+				state(state),
+				result(std::move(result)) {}
+
+			SolveHandle(SolveHandle&&) = default;
+			SolveHandle& operator=(SolveHandle&&) = delete;
+
+			~SolveHandle() {
+				if (state) {
+					cancel();
+				}
+			}
+
+			// Ipopt stops at the next intermediate_callback, i.e. within one iteration
+			void cancel() {
+				state->cancelRequested = true;
+			}
+
+			bool isFinished() const {
+				return result.wait_for(Clock::duration::zero()) == std::future_status::ready;
+			}
+
+			bool waitFor(const Clock::duration timeout) const {
+				return result.wait_for(timeout) == std::future_status::ready;
+			}
+
+			// Safe to call while the solve runs
+			std::optional<Iterate> getBestIterate() const {
+				std::lock_guard<std::mutex> lock(state->mutex);
+				return state->bestIterate;
+			}
+
+			// Blocks until the solve has returned, only once
+			AsyncResult get() {
+				return result.get();
+			}
+	};
+
+	// Runs OptimizeTNLP on a worker thread. The deadline and cancellation are checked in
+	// intermediate_callback, so they take effect after the iteration in progress. An intermediate
+	// function already set on the optimizer keeps being called and is restored afterwards.
+	// app has to be initialized; neither app nor trajectoryOptimizer may be used, copied or released
+	// by anyone else until the solve has finished (Ipopt's reference counts are not thread safe).
+	SolveHandle solveAsync(const SmartPtr<IpoptApplication>& app,
+							const SmartPtr<TrajectoryOptimizer>& trajectoryOptimizer,
+							const Clock::time_point deadline = Clock::time_point::max(),
+							const Number feasibilityTolerance = 1e-6);
+
+	SolveHandle solveAsync(const SmartPtr<IpoptApplication>& app,
+							const SmartPtr<TrajectoryOptimizer>& trajectoryOptimizer,
+							const Clock::duration budget,
+							const Number feasibilityTolerance = 1e-6);
+}
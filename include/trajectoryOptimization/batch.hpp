@@ -0,0 +1,129 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "coin/IpIpoptApplication.hpp"
+#include "coin/IpSolveStatistics.hpp"
+#include "optimizer.hpp"
+
+namespace trajectoryOptimization::batch {
+	using namespace trajectoryOptimization::optimizer;
+
+	using ConfigureApplicationFunction = std::function<void(const SmartPtr<IpoptApplication>& app)>;
+
+	// MUMPS, the linear solver every Ipopt build has, is only safe in concurrent solves from Ipopt 3.14 on,
+	// which serializes the calls into it. With an older Ipopt use MA27/MA57 or a single worker.
+#if IPOPT_VERSION_MAJOR > 3 || (IPOPT_VERSION_MAJOR == 3 && IPOPT_VERSION_MINOR >= 14)
+	const bool MUMPS_IS_THREAD_SAFE = true;
+#else
+	const bool MUMPS_IS_THREAD_SAFE = false;
+#endif
+
+	// Structurally identical problems should point at the same sparsity structure, it is only ever read.
+	struct BatchProblem {
+		numberVector xLowerBounds;
+		numberVector xUpperBounds;
+		numberVector gLowerBounds;
+		numberVector gUpperBounds;
+		numberVector xStartingPoint;
+		EvaluateObjectiveFunction objectiveFunction;
+		EvaluateGradientFunction gradientFunction;
+		EvaluateConstraintFunction constraintFunction;
+		GetJacobianValueFunction jacobianValueFunction;
+		GetHessianValueFunction hessianValueFunction;
+		std::shared_ptr<const SparsityStructure> sparsityStructure;
+	};
+
+	struct BatchResult {
+		ApplicationReturnStatus status;
+		SolverReturn solverStatus;
+		Number objectiveValue;
+		Index iterationCount;
+		double seconds;
+		PrimalDualPoint solution;
+	};
+
+	// Solves independent problems on a fixed number of worker threads. Every worker owns its
+	// IpoptApplication and creates a TrajectoryOptimizer per problem; nothing mutable is shared.
+	// Ipopt has to be built with a thread safe linear solver (e.g. MA27/MA57, or MUMPS from Ipopt 3.14 on).
+	class SolveBatch {
+		const unsigned numberOfWorkers;
+		const ConfigureApplicationFunction configureApplication;
+
+		BatchResult solveProblem(const SmartPtr<IpoptApplication>& app, const BatchProblem& problem) const {
+			BatchResult result = {Internal_Error, INTERNAL_ERROR, 0, 0, 0, {}};
+			const auto start = std::chrono::steady_clock::now();
+
+			FinalizerFunction finalizerFunction = [&result](SolverReturn status, Index n, const Number* x,
+																const Number* zLower, const Number* zUpper,
+																Index m, const Number* g, const Number* lambda,
+																Number objValue, const IpoptData* ipData,
+																IpoptCalculatedQuantities* ipCalculatedQuantities) {
+				result.solverStatus = status;
+				result.objectiveValue = objValue;
+			};
+
+			SmartPtr<TrajectoryOptimizer> trajectoryOptimizer = new TrajectoryOptimizer(problem.xLowerBounds,
+																						problem.xUpperBounds,
+																						problem.gLowerBounds,
+																						problem.gUpperBounds,
+																						problem.xStartingPoint,
+																						problem.objectiveFunction,
+																						problem.gradientFunction,
+																						problem.constraintFunction,
+																						problem.jacobianValueFunction,
+																						problem.hessianValueFunction,
+																						finalizerFunction,
+																						problem.sparsityStructure);
+			setHessianApproximation(app, *problem.sparsityStructure);
+			result.status = app->OptimizeTNLP(trajectoryOptimizer);
+
+			if (IsValid(app->Statistics())) {
+				result.iterationCount = app->Statistics()->IterationCount();
+			}
+			result.solution = trajectoryOptimizer->getSolution();
+			const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			result.seconds = elapsed.count();
+			return result;
+		}
+
+		public:
+			SolveBatch(const unsigned numberOfWorkers, const ConfigureApplicationFunction configureApplication):
+				numberOfWorkers(numberOfWorkers > 0 ? numberOfWorkers : 1),
+				configureApplication(configureApplication) {}
+
+			std::vector<BatchResult> operator()(const std::vector<BatchProblem>& problems) const {
+				std::vector<BatchResult> results(problems.size());
+				std::atomic<size_t> nextProblemIndex(0);
+
+				const auto work = [&]() {
+					SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
+					configureApplication(app);
+					const ApplicationReturnStatus initializeStatus = app->Initialize();
+
+					for (size_t problemIndex = nextProblemIndex++; problemIndex < problems.size(); problemIndex = nextProblemIndex++) {
+						if (initializeStatus != Solve_Succeeded) {
+							results[problemIndex] = {initializeStatus, INTERNAL_ERROR, 0, 0, 0, {}};
+							continue;
+						}
+						results[problemIndex] = solveProblem(app, problems[problemIndex]);
+					}
+				};
+
+				std::vector<std::thread> workers;
+				const size_t numberOfThreads = std::min<size_t>(numberOfWorkers, problems.size());
+				for (size_t workerIndex = 0; workerIndex < numberOfThreads; workerIndex++) {
+					workers.emplace_back(work);
+				}
+				for (auto& worker: workers) {
+					worker.join();
+				}
+
+				return results;
+			}
+	};
+}
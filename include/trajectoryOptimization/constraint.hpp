@@ -4,7 +4,6 @@
 #include <cmath>
 #include <iterator>
 #include <functional>
-#include <range/v3/all.hpp>
 #include "dynamic.hpp"
 #include "derivative.hpp"
 #include "utilities.hpp"
@@ -36,7 +35,7 @@ namespace trajectoryOptimization::constraint {
 									goalTimeIndex(goalTimeIndex),
 									kinematicGoal(kinematicGoal),
 									kinematicStartIndex(goalTimeIndex * pointDimension),
-									kinematicDimensionRange(ranges::view::ints((unsigned) 0, kinematicDimension)) {}
+									kinematicDimensionRange(utilities::indexRange(0u, kinematicDimension)) {}
 
 		std::vector<double> operator()(const double* trajectoryPtr) const {
 
@@ -56,6 +55,38 @@ namespace trajectoryOptimization::constraint {
 		}
 	};
 
+	// Linear counterpart of GetToKinematicGoalSquare, keeps a constraint Jacobian of full rank at the goal
+	class GetToKinematicGoal {
+		const unsigned pointDimension;
+		const unsigned kinematicDimension;
+		const unsigned goalTimeIndex;
+		const std::vector<double> kinematicGoal;
+		const unsigned kinematicStartIndex;
+		public:
+		GetToKinematicGoal(const unsigned numberOfPoints,
+							const unsigned pointDimension,
+							const unsigned kinematicDimension,
+							const unsigned goalTimeIndex,
+							const std::vector<double> kinematicGoal):
+								pointDimension(pointDimension),
+								kinematicDimension(kinematicDimension),
+								goalTimeIndex(goalTimeIndex),
+								kinematicGoal(kinematicGoal),
+								kinematicStartIndex(goalTimeIndex * pointDimension) {
+									assert(goalTimeIndex < numberOfPoints);
+									assert(kinematicGoal.size() >= kinematicDimension);
+								}
+
+		std::vector<double> operator()(const double* trajectoryPtr) const {
+			const auto currentKinematicsStartPtr = trajectoryPtr + kinematicStartIndex;
+			std::vector<double> toKinematicGoal(kinematicDimension);
+			for (unsigned kinematicIndex = 0; kinematicIndex < kinematicDimension; kinematicIndex++) {
+				toKinematicGoal[kinematicIndex] = currentKinematicsStartPtr[kinematicIndex] - kinematicGoal[kinematicIndex];
+			}
+			return toKinematicGoal;
+		}
+	};
+
 	class GetKinematicViolation {
 		const DynamicFunction dynamics;
 		const unsigned pointDimension;
@@ -64,9 +95,6 @@ namespace trajectoryOptimization::constraint {
 		const double dt;
 		const unsigned velocityDimension;
 		const unsigned controlDimension;
-		const int currentKinematicsStartIndex;
-		const int nextKinematicsStartIndex;
-		const std::vector<unsigned> positionDimensionRange;
 
 		public:
 			GetKinematicViolation(const DynamicFunction dynamics,
@@ -80,54 +108,39 @@ namespace trajectoryOptimization::constraint {
 										timeIndex(timeIndex),
 										dt(dt),
 										velocityDimension(positionDimension),
-										controlDimension(pointDimension - positionDimension - velocityDimension),
-										currentKinematicsStartIndex(timeIndex * pointDimension),
-										nextKinematicsStartIndex((timeIndex+1) * pointDimension),
-										positionDimensionRange(ranges::view::ints((unsigned) 0, positionDimension)) {
+										controlDimension(pointDimension - positionDimension - velocityDimension) {
 											assert(positionDimension == velocityDimension);
 										}
 
 			std::vector<double> operator() (const double* trajectoryPointer) {
+				// Only the knots up to timeIndex + 1 are read
+				const trajectoryView::TrajectoryView trajectory(trajectoryPointer, timeIndex + 2, positionDimension, controlDimension);
+				const auto now = trajectory.knot(timeIndex);
+				const auto next = trajectory.knot(timeIndex + 1);
 
-				const auto nowPosition = trajectoryPointer + currentKinematicsStartIndex;
-				const auto nextPosition = trajectoryPointer + nextKinematicsStartIndex;
-
-				const auto nowVelocity = nowPosition + positionDimension;
-				const auto nextVelocity = nextPosition + positionDimension;
-
-				const auto nowControl = nowVelocity + velocityDimension;
-				const auto nextControl = nextVelocity + velocityDimension;
-
-				const auto nowAcceleration = dynamics(nowPosition,
+				const auto nowAcceleration = dynamics(now.position.data(),
 														positionDimension,
-														nowVelocity,
+														now.velocity.data(),
 														velocityDimension,
-														nowControl,
+														now.control.data(),
 														controlDimension);
-				const auto nextAcceleration = dynamics(nextPosition,
+				const auto nextAcceleration = dynamics(next.position.data(),
 														positionDimension,
-														nextVelocity,
+														next.velocity.data(),
 														velocityDimension,
-														nextControl,
+														next.control.data(),
 														controlDimension);
 
-				const auto average = [](const auto val1, const auto val2) { return 0.5 * (val1 + val2); };
-				const auto getViolation = [&](const auto now, const auto next, const auto dNow, const auto dNext)
-						{ return (next - now) - average(dNow, dNext)*dt; };
+				const auto getViolation = [this](const double nowValue, const double nextValue, const double nowRate, const double nextRate)
+						{ return (nextValue - nowValue) - 0.5 * (nowRate + nextRate) * dt; };
 
 				std::vector<double> kinematicViolation(positionDimension+velocityDimension);
-
-				std::transform(positionDimensionRange.begin(), positionDimensionRange.end(),
-								kinematicViolation.begin(),
-								[nowPosition, nextPosition, nowVelocity, nextVelocity, getViolation](const auto index) {
-									return getViolation(nowPosition[index], nextPosition[index], nowVelocity[index], nextVelocity[index]);
-								});
-
-				std::transform(positionDimensionRange.begin(), positionDimensionRange.end(),
-								kinematicViolation.begin() + positionDimension,
-								[nowVelocity, nextVelocity, nowAcceleration, nextAcceleration, getViolation](const auto index) {
-									return getViolation(nowVelocity[index], nextVelocity[index], nowAcceleration[index], nextAcceleration[index]);
-								});
+				for (unsigned index = 0; index < positionDimension; index++) {
+					kinematicViolation[index] = getViolation(now.position[index], next.position[index],
+																now.velocity[index], next.velocity[index]);
+					kinematicViolation[positionDimension + index] = getViolation(now.velocity[index], next.velocity[index],
+																					nowAcceleration[index], nextAcceleration[index]);
+				}
 
 				return kinematicViolation;
 			};
@@ -159,6 +172,19 @@ namespace trajectoryOptimization::constraint {
 				}
 				return stackedConstriants;
 			}
+
+			void operator()(const double* trajectoryPtr, double* stackedConstriants) {
+				for (auto const &aFunction: constraintFunctions) {
+					const auto constraints = aFunction(trajectoryPtr);
+					stackedConstriants = std::copy(constraints.begin(),
+													constraints.end(),
+													stackedConstriants);
+				}
+			}
+
+			unsigned size() const {
+				return numConstraints;
+			}
 	};
 
 	std::vector<ConstraintFunction> applyKinematicViolationConstraints(std::vector<ConstraintFunction> constraints,
@@ -167,16 +193,15 @@ namespace trajectoryOptimization::constraint {
 							                                            const unsigned worldDimension,
 							                                            const unsigned timeIndexStart,
 							                                            const unsigned timeIndexEndExclusive,
-							                                            const double timeStepSize) {
-			for (int timeIndex = timeIndexStart; timeIndex < timeIndexEndExclusive; timeIndex++) {
-			    constraints.push_back(constraint::GetKinematicViolation(blockDynamics,
-			                                                            timePointDimension,
-			                                                            worldDimension,
-			                                                            timeIndex,
-			                                                            timeStepSize));
-			}
+							                                            const double timeStepSize);
 
-			return constraints;
-		}
+	// Non-uniform mesh: interval timeIndexStart + k, between points timeIndexStart + k and + k + 1, is timeStepSizes[k] long
+	std::vector<ConstraintFunction> applyKinematicViolationConstraints(std::vector<ConstraintFunction> constraints,
+																		const DynamicFunction blockDynamics,
+																		const unsigned timePointDimension,
+																		const unsigned worldDimension,
+																		const unsigned timeIndexStart,
+																		const unsigned timeIndexEndExclusive,
+																		const std::vector<double>& timeStepSizes);
 }
 
@@ -1,8 +1,15 @@
 #pragma once
 #include <cmath>
 #include <cassert>
-#include <range/v3/view.hpp> 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <string>
+#include <tuple>
+#include <utility>
 
+#include "sparsity.hpp"
+#include "trajectoryView.hpp"
 #include "utilities.hpp"
 
 
@@ -17,6 +24,7 @@ namespace trajectoryOptimization::cost{
 		const int trajectoryDimension;
 		const int controlStartIndex; 
 		const int controlEndIndex;
+		const unsigned positionDimension;
 		std::vector<unsigned> controlIndices;
 		public:
 			GetControlSquareSum(const unsigned numberOfPoints,
@@ -27,9 +35,11 @@ namespace trajectoryOptimization::cost{
 									controlDimension(controlDimension),
 									trajectoryDimension(numberOfPoints * pointDimension),
 									controlStartIndex(pointDimension - controlDimension),
-									controlEndIndex(pointDimension)
+									controlEndIndex(pointDimension),
+									positionDimension((pointDimension - controlDimension) / 2)
 								{
 									assert(controlDimension<pointDimension);
+									assert(2 * positionDimension + controlDimension == pointDimension);
 
 									auto isControlIndex = [&](unsigned trajectoryIndex) {
 										auto indexInPoint = (trajectoryIndex % pointDimension);
@@ -52,8 +62,410 @@ namespace trajectoryOptimization::cost{
 
 				return controlSquareSum;
 			}  
+
+			std::vector<int> footprint() const {
+				return std::vector<int>(controlIndices.begin(), controlIndices.end());
+			}
+
+			double atPoint(const double* trajectoryPointer, const unsigned timeIndex) const {
+				const trajectoryView::TrajectoryView trajectory(trajectoryPointer, numberOfPoints, positionDimension, controlDimension);
+				double controlSquareSum = 0;
+				for (const double control: trajectory.control(timeIndex)) {
+					controlSquareSum += control * control;
+				}
+				return controlSquareSum;
+			}
+
+			void addGradientAtPoint(const double* trajectoryPointer,
+									const unsigned timeIndex,
+									const double weight,
+									double* gradient) const {
+				const auto control = trajectoryView::TrajectoryView(trajectoryPointer, numberOfPoints, positionDimension, controlDimension)
+										.control(timeIndex);
+				const auto controlGradient = trajectoryView::MutableTrajectoryView(gradient, numberOfPoints, positionDimension, controlDimension)
+												.control(timeIndex);
+				for (unsigned controlIndex = 0; controlIndex < controlDimension; controlIndex++) {
+					controlGradient[controlIndex] += weight * 2 * control[controlIndex];
+				}
+			}
+
+			template<typename AddHessianEntry>
+			void addHessianAtPoint(const unsigned timeIndex,
+									const double weight,
+									AddHessianEntry& addHessianEntry) const {
+				const int controlIndexStart = timeIndex * pointDimension + controlStartIndex;
+				for (unsigned controlIndex = 0; controlIndex < controlDimension; controlIndex++) {
+					addHessianEntry(controlIndexStart + controlIndex, controlIndexStart + controlIndex, weight * 2);
+				}
+			}
 	};
-}//namespace
 
+	class GetControlRateSquareSum {
+		const unsigned numberOfPoints;
+		const unsigned pointDimension;
+		const unsigned controlDimension;
+		const unsigned controlStartIndex;
+		const unsigned positionDimension;
+		public:
+			GetControlRateSquareSum(const unsigned numberOfPoints,
+									const unsigned pointDimension,
+									const unsigned controlDimension):
+										numberOfPoints(numberOfPoints),
+										pointDimension(pointDimension),
+										controlDimension(controlDimension),
+										controlStartIndex(pointDimension - controlDimension),
+										positionDimension((pointDimension - controlDimension) / 2) {
+											assert(controlDimension<pointDimension);
+											assert(2 * positionDimension + controlDimension == pointDimension);
+										}
+
+			double operator()(const double* trajectoryPointer) const {
+				double controlRateSquareSum = 0;
+				for (unsigned timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
+					controlRateSquareSum += atPoint(trajectoryPointer, timeIndex);
+				}
+				return controlRateSquareSum;
+			}
+
+			std::vector<int> footprint() const {
+				std::vector<int> controlIndices;
+				for (unsigned timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
+					for (unsigned controlIndex = 0; controlIndex < controlDimension; controlIndex++) {
+						controlIndices.push_back(timeIndex * pointDimension + controlStartIndex + controlIndex);
+					}
+				}
+				return controlIndices;
+			}
+
+			double atPoint(const double* trajectoryPointer, const unsigned timeIndex) const {
+				if (timeIndex + 1 >= numberOfPoints) {
+					return 0;
+				}
+				const trajectoryView::TrajectoryView trajectory(trajectoryPointer, numberOfPoints, positionDimension, controlDimension);
+				const auto nowControl = trajectory.control(timeIndex);
+				const auto nextControl = trajectory.control(timeIndex + 1);
+				double controlRateSquareSum = 0;
+				for (unsigned controlIndex = 0; controlIndex < controlDimension; controlIndex++) {
+					const auto controlRate = nextControl[controlIndex] - nowControl[controlIndex];
+					controlRateSquareSum += controlRate * controlRate;
+				}
+				return controlRateSquareSum;
+			}
+
+			void addGradientAtPoint(const double* trajectoryPointer,
+									const unsigned timeIndex,
+									const double weight,
+									double* gradient) const {
+				if (timeIndex + 1 >= numberOfPoints) {
+					return;
+				}
+				const trajectoryView::TrajectoryView trajectory(trajectoryPointer, numberOfPoints, positionDimension, controlDimension);
+				const trajectoryView::MutableTrajectoryView trajectoryGradient(gradient, numberOfPoints, positionDimension, controlDimension);
+				const auto nowControl = trajectory.control(timeIndex);
+				const auto nextControl = trajectory.control(timeIndex + 1);
+				const auto nowControlGradient = trajectoryGradient.control(timeIndex);
+				const auto nextControlGradient = trajectoryGradient.control(timeIndex + 1);
+				for (unsigned controlIndex = 0; controlIndex < controlDimension; controlIndex++) {
+					const auto controlRate = nextControl[controlIndex] - nowControl[controlIndex];
+					nowControlGradient[controlIndex] -= weight * 2 * controlRate;
+					nextControlGradient[controlIndex] += weight * 2 * controlRate;
+				}
+			}
 
+			template<typename AddHessianEntry>
+			void addHessianAtPoint(const unsigned timeIndex,
+									const double weight,
+									AddHessianEntry& addHessianEntry) const {
+				if (timeIndex + 1 >= numberOfPoints) {
+					return;
+				}
+				const int nowControlIndex = timeIndex * pointDimension + controlStartIndex;
+				const int nextControlIndex = nowControlIndex + pointDimension;
+				for (unsigned controlIndex = 0; controlIndex < controlDimension; controlIndex++) {
+					addHessianEntry(nowControlIndex + controlIndex, nowControlIndex + controlIndex, weight * 2);
+					addHessianEntry(nextControlIndex + controlIndex, nextControlIndex + controlIndex, weight * 2);
+					addHessianEntry(nextControlIndex + controlIndex, nowControlIndex + controlIndex, -weight * 2);
+				}
+			}
+	};
+
+	class GetKinematicTrackingSquareSum {
+		const unsigned numberOfPoints;
+		const unsigned pointDimension;
+		const unsigned kinematicDimension;
+		const std::vector<double> referenceKinematics;
+		public:
+			GetKinematicTrackingSquareSum(const unsigned numberOfPoints,
+											const unsigned pointDimension,
+											const unsigned kinematicDimension,
+											const std::vector<double> referenceKinematics):
+												numberOfPoints(numberOfPoints),
+												pointDimension(pointDimension),
+												kinematicDimension(kinematicDimension),
+												referenceKinematics(referenceKinematics) {
+													assert(kinematicDimension<=pointDimension);
+													assert(referenceKinematics.size() == numberOfPoints * kinematicDimension);
+												}
+
+			double operator()(const double* trajectoryPointer) const {
+				double trackingSquareSum = 0;
+				for (unsigned timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
+					trackingSquareSum += atPoint(trajectoryPointer, timeIndex);
+				}
+				return trackingSquareSum;
+			}
+
+			std::vector<int> footprint() const {
+				std::vector<int> kinematicIndices;
+				for (unsigned timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
+					for (unsigned kinematicIndex = 0; kinematicIndex < kinematicDimension; kinematicIndex++) {
+						kinematicIndices.push_back(timeIndex * pointDimension + kinematicIndex);
+					}
+				}
+				return kinematicIndices;
+			}
+
+			double atPoint(const double* trajectoryPointer, const unsigned timeIndex) const {
+				const auto kinematics = trajectoryPointer + timeIndex * pointDimension;
+				const auto reference = referenceKinematics.data() + timeIndex * kinematicDimension;
+				double trackingSquareSum = 0;
+				for (unsigned kinematicIndex = 0; kinematicIndex < kinematicDimension; kinematicIndex++) {
+					const auto trackingError = kinematics[kinematicIndex] - reference[kinematicIndex];
+					trackingSquareSum += trackingError * trackingError;
+				}
+				return trackingSquareSum;
+			}
+
+			void addGradientAtPoint(const double* trajectoryPointer,
+									const unsigned timeIndex,
+									const double weight,
+									double* gradient) const {
+				const int kinematicIndexStart = timeIndex * pointDimension;
+				const auto reference = referenceKinematics.data() + timeIndex * kinematicDimension;
+				for (unsigned kinematicIndex = 0; kinematicIndex < kinematicDimension; kinematicIndex++) {
+					const auto trackingError = trajectoryPointer[kinematicIndexStart + kinematicIndex] - reference[kinematicIndex];
+					gradient[kinematicIndexStart + kinematicIndex] += weight * 2 * trackingError;
+				}
+			}
+
+			template<typename AddHessianEntry>
+			void addHessianAtPoint(const unsigned timeIndex,
+									const double weight,
+									AddHessianEntry& addHessianEntry) const {
+				const int kinematicIndexStart = timeIndex * pointDimension;
+				for (unsigned kinematicIndex = 0; kinematicIndex < kinematicDimension; kinematicIndex++) {
+					addHessianEntry(kinematicIndexStart + kinematicIndex, kinematicIndexStart + kinematicIndex, weight * 2);
+				}
+			}
+	};
+
+	// Penalizes every point that has not reached the goal yet, so trajectories that arrive earlier cost less.
+	class GetToKinematicGoalSquareSum {
+		const unsigned numberOfPoints;
+		const unsigned pointDimension;
+		const unsigned kinematicDimension;
+		const std::vector<double> kinematicGoal;
+		const GetKinematicTrackingSquareSum getTrackingSquareSum;
+		public:
+			GetToKinematicGoalSquareSum(const unsigned numberOfPoints,
+										const unsigned pointDimension,
+										const unsigned kinematicDimension,
+										const std::vector<double> kinematicGoal):
+											numberOfPoints(numberOfPoints),
+											pointDimension(pointDimension),
+											kinematicDimension(kinematicDimension),
+											kinematicGoal(kinematicGoal),
+											getTrackingSquareSum(numberOfPoints,
+																	pointDimension,
+																	kinematicDimension,
+																	utilities::createTrajectoryWithIdenticalPoints(numberOfPoints, kinematicGoal)) {
+												assert(kinematicGoal.size() == kinematicDimension);
+											}
 
+			double operator()(const double* trajectoryPointer) const {
+				return getTrackingSquareSum(trajectoryPointer);
+			}
+
+			std::vector<int> footprint() const {
+				return getTrackingSquareSum.footprint();
+			}
+
+			double atPoint(const double* trajectoryPointer, const unsigned timeIndex) const {
+				return getTrackingSquareSum.atPoint(trajectoryPointer, timeIndex);
+			}
+
+			void addGradientAtPoint(const double* trajectoryPointer,
+									const unsigned timeIndex,
+									const double weight,
+									double* gradient) const {
+				getTrackingSquareSum.addGradientAtPoint(trajectoryPointer, timeIndex, weight, gradient);
+			}
+
+			template<typename AddHessianEntry>
+			void addHessianAtPoint(const unsigned timeIndex,
+									const double weight,
+									AddHessianEntry& addHessianEntry) const {
+				getTrackingSquareSum.addHessianAtPoint(timeIndex, weight, addHessianEntry);
+			}
+	};
+
+	template<typename CostTerm>
+	struct WeightedCostTerm {
+		const std::string name;
+		const double weight;
+		const CostTerm term;
+
+		WeightedCostTerm(const std::string name, const double weight, const CostTerm term):
+			name(name), weight(weight), term(term) {}
+	};
+
+	struct CostTermReport {
+		std::string name;
+		double weight;
+		double value;
+		double seconds;
+	};
+
+	// Sum of weighted cost terms, evaluated point by point in a single pass over the trajectory.
+	// Every term provides footprint, atPoint, addGradientAtPoint and addHessianAtPoint; the Hessian of a term
+	// must add its entries in an order that does not depend on the trajectory values.
+	template<typename... CostTerms>
+	class WeightedCostSum {
+		const unsigned numberOfPoints;
+		const std::tuple<WeightedCostTerm<CostTerms>...> weightedTerms;
+		std::vector<int> hessianRows;
+		std::vector<int> hessianCols;
+		std::vector<int> hessianEntryPositions;
+
+		template<typename PointFunction>
+		void forEachTerm(PointFunction&& pointFunction) const {
+			std::apply([&](const auto&... weightedTerm) { (pointFunction(weightedTerm), ...); }, weightedTerms);
+		}
+
+		public:
+			WeightedCostSum(const unsigned numberOfPoints, const WeightedCostTerm<CostTerms>... weightedTerms):
+				numberOfPoints(numberOfPoints),
+				weightedTerms(weightedTerms...) {
+					std::vector<int> entryRows;
+					std::vector<int> entryCols;
+					auto recordHessianEntry = [&](const int row, const int col, const double) {
+						entryRows.push_back(row);
+						entryCols.push_back(col);
+					};
+					for (unsigned timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
+						forEachTerm([&](const auto& weightedTerm) {
+							weightedTerm.term.addHessianAtPoint(timeIndex, weightedTerm.weight, recordHessianEntry);
+						});
+					}
+
+					// Sized by the entries the terms add, the cost does not know the number of variables
+					int dimension = 0;
+					for (unsigned entry = 0; entry < entryRows.size(); entry++) {
+						dimension = std::max({dimension, entryRows[entry] + 1, entryCols[entry] + 1});
+					}
+					const sparsity::SparsityPattern hessianPattern =
+						sparsity::getLowerTriangle(sparsity::SparsityPattern(dimension, dimension, entryRows, entryCols));
+					hessianRows = hessianPattern.getRows();
+					hessianCols = hessianPattern.getCols();
+					hessianEntryPositions = sparsity::getIndexMap(entryRows, entryCols, hessianPattern, 0, 0, true);
+				}
+
+			double operator()(const double* trajectoryPointer) const {
+				double costSum = 0;
+				for (unsigned timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
+					forEachTerm([&](const auto& weightedTerm) {
+						costSum += weightedTerm.weight * weightedTerm.term.atPoint(trajectoryPointer, timeIndex);
+					});
+				}
+				return costSum;
+			}
+
+			double atPoint(const double* trajectoryPointer, const unsigned timeIndex) const {
+				double costAtPoint = 0;
+				forEachTerm([&](const auto& weightedTerm) {
+					costAtPoint += weightedTerm.weight * weightedTerm.term.atPoint(trajectoryPointer, timeIndex);
+				});
+				return costAtPoint;
+			}
+
+			void gradient(const double* trajectoryPointer, const unsigned numberVariables, double* gradient) const {
+				std::fill(gradient, gradient + numberVariables, 0);
+				for (unsigned timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
+					forEachTerm([&](const auto& weightedTerm) {
+						weightedTerm.term.addGradientAtPoint(trajectoryPointer, timeIndex, weightedTerm.weight, gradient);
+					});
+				}
+			}
+
+			std::vector<double> gradient(const double* trajectoryPointer, const unsigned numberVariables) const {
+				std::vector<double> costGradient(numberVariables);
+				gradient(trajectoryPointer, numberVariables, costGradient.data());
+				return costGradient;
+			}
+
+			std::vector<int> footprint() const {
+				std::vector<int> variableIndices;
+				forEachTerm([&](const auto& weightedTerm) {
+					const auto termFootprint = weightedTerm.term.footprint();
+					variableIndices.insert(variableIndices.end(), termFootprint.begin(), termFootprint.end());
+				});
+				std::sort(variableIndices.begin(), variableIndices.end());
+				variableIndices.erase(std::unique(variableIndices.begin(), variableIndices.end()), variableIndices.end());
+				return variableIndices;
+			}
+
+			const std::vector<int>& getHessianRows() const { return hessianRows; }
+			const std::vector<int>& getHessianCols() const { return hessianCols; }
+
+			void hessian(const double objectiveFactor, double* hessianValues) const {
+				std::fill(hessianValues, hessianValues + hessianRows.size(), 0);
+				auto hessianEntryPosition = hessianEntryPositions.begin();
+				auto addHessianEntry = [&](const int, const int, const double value) {
+					hessianValues[*hessianEntryPosition++] += objectiveFactor * value;
+				};
+				for (unsigned timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
+					forEachTerm([&](const auto& weightedTerm) {
+						weightedTerm.term.addHessianAtPoint(timeIndex, weightedTerm.weight, addHessianEntry);
+					});
+				}
+			}
+
+			std::vector<double> hessian(const double objectiveFactor) const {
+				std::vector<double> hessianValues(hessianRows.size());
+				hessian(objectiveFactor, hessianValues.data());
+				return hessianValues;
+			}
+
+			// Each term is timed within the single pass over the points, so the seconds are its share of that pass
+			std::vector<CostTermReport> report(const double* trajectoryPointer) const {
+				std::array<double, sizeof...(CostTerms)> termValues = {};
+				std::array<std::chrono::steady_clock::duration, sizeof...(CostTerms)> termDurations = {};
+				for (unsigned timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
+					unsigned term = 0;
+					forEachTerm([&](const auto& weightedTerm) {
+						const auto start = std::chrono::steady_clock::now();
+						termValues[term] += weightedTerm.term.atPoint(trajectoryPointer, timeIndex);
+						termDurations[term++] += std::chrono::steady_clock::now() - start;
+					});
+				}
+
+				std::vector<CostTermReport> costTermReports;
+				unsigned term = 0;
+				forEachTerm([&](const auto& weightedTerm) {
+					const std::chrono::duration<double> elapsed = termDurations[term];
+					costTermReports.push_back({weightedTerm.name,
+												weightedTerm.weight,
+												weightedTerm.weight * termValues[term],
+												elapsed.count()});
+					term++;
+				});
+				return costTermReports;
+			}
+	};
+
+	// The configurations used throughout, instantiated in the compiled library
+	extern template class WeightedCostSum<GetControlSquareSum>;
+	extern template class WeightedCostSum<GetControlSquareSum, GetControlRateSquareSum>;
+	extern template class WeightedCostSum<GetControlSquareSum, GetKinematicTrackingSquareSum>;
+	extern template class WeightedCostSum<GetControlSquareSum, GetControlRateSquareSum, GetKinematicTrackingSquareSum>;
+}//namespace
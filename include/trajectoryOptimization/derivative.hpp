@@ -2,8 +2,14 @@
 #include <cassert>
 #include <functional>
 #include <algorithm>
-#include <unordered_map>
-#include <range/v3/view.hpp>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include "arena.hpp"
+#include "sparsity.hpp"
+#include "utilities.hpp"
 
 namespace trajectoryOptimization::derivative {
 	// http://www.it.uom.gr/teaching/linearalgebra/NumericalRecipiesInC/c5-7.pdf
@@ -14,13 +20,9 @@ namespace trajectoryOptimization::derivative {
 	using VectorToDoubleFunction = std::function<double(const double* x)>;
 	using VectorToVectorFunction = std::function<std::vector<double>(const double* x)>;
 
-	double calculateH(const double* x, const unsigned partialIndex) {
-		return (x[partialIndex] != 0 ? SQRT_EPSILON * x[partialIndex] : FALLBACK_H_IF_X_ZERO);
-	}
+	double calculateH(const double* x, const unsigned partialIndex);
 
-	double calculateDerivative(const double h, const double f2, const double f1) {
-		return (f2 - f1)/(2*h);
-	}
+	double calculateDerivative(const double h, const double f2, const double f1);
 
 	class GetPartialDerivativeOfVectorToDoubleFunction {
 		const VectorToDoubleFunction f;
@@ -33,7 +35,8 @@ namespace trajectoryOptimization::derivative {
 		double operator()(const double* x, const unsigned partialIndex) const {
 			assert(partialIndex < numberVariables);
 
-			double x1[numberVariables];
+			arena::ArenaScope scope;
+			double* x1 = scope.allocate<double>(numberVariables);
 			std::copy(x, x + numberVariables, x1);
 
 			const double h = calculateH(x, partialIndex);
@@ -50,31 +53,54 @@ namespace trajectoryOptimization::derivative {
 		}
 	};
 
+	// The footprint lists the only variables f depends on; partials of all other variables are zero
+	// and are never evaluated.
 	class GetGradientOfVectorToDoubleFunction {
 		const VectorToDoubleFunction f;
 		const int numberVariables;
-		const GetPartialDerivativeOfVectorToDoubleFunction getPartialDerivative;
 		const std::vector<int> variableIndexRange;
 
 	public:
 		GetGradientOfVectorToDoubleFunction(const VectorToDoubleFunction f, const int numberVariables):
 			f(f),
 			numberVariables(numberVariables),
-			getPartialDerivative(f, numberVariables),
-			variableIndexRange(ranges::view::ints(0, numberVariables)) {}
+			variableIndexRange(utilities::indexRange(0, numberVariables)) {}
 
-		std::vector<double> operator()(const double* x) const {
-			const auto getPartialDerivativeOfIndex = [&](const auto partialIndex) {
-				return getPartialDerivative(x, partialIndex);
-			};
+		GetGradientOfVectorToDoubleFunction(const VectorToDoubleFunction f,
+											const int numberVariables,
+											const std::vector<int> footprint):
+			f(f),
+			numberVariables(numberVariables),
+			variableIndexRange(footprint) {
+				assert(std::all_of(footprint.begin(), footprint.end(),
+									[numberVariables](const int index) { return index >= 0 && index < numberVariables; }));
+			}
 
+		std::vector<double> operator()(const double* x) const {
 			std::vector<double> gradient(numberVariables);
-			std::transform(variableIndexRange.begin(), variableIndexRange.end(),
-							gradient.begin(),
-							getPartialDerivativeOfIndex);
-
+			(*this)(x, gradient.data());
 			return gradient;
 		}
+
+		void operator()(const double* x, double* gradient) const {
+			std::fill(gradient, gradient + numberVariables, 0);
+			arena::ArenaScope scope;
+			double* x1 = scope.allocate<double>(numberVariables);
+			std::copy(x, x + numberVariables, x1);
+
+			for (const auto partialIndex: variableIndexRange) {
+				const double h = calculateH(x, partialIndex);
+
+				x1[partialIndex] = x[partialIndex] - h;
+				const double f1 = f(x1);
+
+				x1[partialIndex] = x[partialIndex] + h;
+				const double f2 = f(x1);
+
+				x1[partialIndex] = x[partialIndex];
+				gradient[partialIndex] = calculateDerivative(h, f2, f1);
+			}
+		}
 	};
 
 	class GetPartialDerivativeOfVectorToVectorFunction {
@@ -88,7 +114,8 @@ namespace trajectoryOptimization::derivative {
 		std::vector<double> operator()(const double* x, const unsigned partialIndex) const {
 			assert(partialIndex < numberVariablesInput);
 
-			double x1[numberVariablesInput];
+			arena::ArenaScope scope;
+			double* x1 = scope.allocate<double>(numberVariablesInput);
 			std::copy(x, x + numberVariablesInput, x1);
 
 			const double h = calculateH(x, partialIndex);
@@ -127,7 +154,7 @@ namespace trajectoryOptimization::derivative {
 			f(f),
 			numberVariablesInput(numberVariablesInput),
 			getPartialDerivative(f, numberVariablesInput),
-			jacobianColRange(ranges::view::ints((unsigned) 0, numberVariablesInput)) {}
+			jacobianColRange(utilities::indexRange(0, (int) numberVariablesInput)) {}
 
 		std::vector<std::vector<double>> operator()(const double* x) const {
 			const auto numJacCols = jacobianColRange.size();
@@ -161,8 +188,8 @@ namespace trajectoryOptimization::derivative {
 
 			std::vector<int> jacobianRows;
 			std::vector<int> jacobianCols;
-			for (int c : ranges::view::ints(0, numJacobianCols)) {
-				for (int r : ranges::view::ints(0, numJacobianRows)) {
+			for (int c = 0; c < numJacobianCols; c++) {
+				for (int r = 0; r < numJacobianRows; r++) {
 					if (jacobianColumnList[c][r] != 0) {
 						jacobianRows.push_back(r);
 						jacobianCols.push_back(c);
@@ -174,45 +201,72 @@ namespace trajectoryOptimization::derivative {
 		}
 	};
 
+	// Differentiates once per column of the pattern that has entries and only takes the differences
+	// of the rows the pattern's compressed columns list for it. x is perturbed in a copy from the
+	// thread's arena, but f returns its values in a std::vector, so every column still makes two
+	// heap allocations.
 	class GetJacobianOfVectorToVectorFunctionUsingSparsityPattern {
 		const VectorToVectorFunction f;
-		const GetPartialDerivativeOfVectorToVectorFunction getPartialDerivative;
-		const std::vector<int> jacobianRows;
-		const std::vector<int> jacobianCols;
+		const unsigned numberVariablesInput;
 		const int numJacobianValues;
-		const std::vector<int> jacobianPositionIndexRange;
+		const std::shared_ptr<const sparsity::CompressedView> jacobianColumns;
 
 	public:
 		GetJacobianOfVectorToVectorFunctionUsingSparsityPattern(const VectorToVectorFunction f,
 																const unsigned numberVariablesInput,
 																const std::vector<int> jacobianRows,
 																const std::vector<int> jacobianCols):
-			f(f),
-			getPartialDerivative(f, numberVariablesInput),
-			jacobianRows(jacobianRows),
-			jacobianCols(jacobianCols),
-			numJacobianValues(jacobianRows.size()),
-			jacobianPositionIndexRange(ranges::view::ints(0, numJacobianValues)) {
+			GetJacobianOfVectorToVectorFunctionUsingSparsityPattern(f,
+																	numberVariablesInput,
+																	std::make_shared<const sparsity::CompressedView>(
+																		sparsity::compressLines(numberVariablesInput,
+																								jacobianCols,
+																								jacobianRows))) {
 				assert(jacobianRows.size() == jacobianCols.size());
 			}
 
+		// Functions with the same pattern, e.g. the dynamics of every interval, share its compressed columns
+		GetJacobianOfVectorToVectorFunctionUsingSparsityPattern(const VectorToVectorFunction f,
+																const unsigned numberVariablesInput,
+																const std::shared_ptr<const sparsity::CompressedView> jacobianColumns):
+			f(f),
+			numberVariablesInput(numberVariablesInput),
+			numJacobianValues(jacobianColumns->entries.size()),
+			jacobianColumns(jacobianColumns) {
+				assert(jacobianColumns->offsets.size() == numberVariablesInput + 1);
+			}
+
 		std::vector<double> operator()(const double* x) const {
-			std::unordered_map<int, std::vector<double>> jacobianColumnMap;
+			std::vector<double> jacobian(numJacobianValues);
+			(*this)(x, jacobian.data());
+			return jacobian;
+		}
+
+		void operator()(const double* x, double* jacobian) const {
+			arena::ArenaScope scope;
+			double* x1 = scope.allocate<double>(numberVariablesInput);
+			std::copy(x, x + numberVariablesInput, x1);
 
-			const auto getJacobianValue = [&] (const auto row, const auto col) {
-				if (jacobianColumnMap.count(col) == 0) {
-					jacobianColumnMap.insert({col, getPartialDerivative(x, col)});
+			for (unsigned col = 0; col < numberVariablesInput; col++) {
+				const int first = jacobianColumns->offsets[col];
+				const int last = jacobianColumns->offsets[col + 1];
+				if (first == last) {
+					continue;
 				}
+				const double h = calculateH(x, col);
 
-				return jacobianColumnMap.at(col)[row];
-			};
+				x1[col] = x[col] - h;
+				const std::vector<double> f1 = f(x1);
 
-			std::vector<double> jacobian(numJacobianValues);
-			std::transform(jacobianRows.begin(), jacobianRows.end(), jacobianCols.begin(),
-							jacobian.begin(),
-							getJacobianValue);
+				x1[col] = x[col] + h;
+				const std::vector<double> f2 = f(x1);
 
-			return jacobian;
+				x1[col] = x[col];
+				for (int position = first; position < last; position++) {
+					const int row = jacobianColumns->indices[position];
+					jacobian[jacobianColumns->entries[position]] = calculateDerivative(h, f2[row], f1[row]);
+				}
+			}
 		}
 	};
 
@@ -220,13 +274,5 @@ namespace trajectoryOptimization::derivative {
 				const std::vector<int>,
 				const VectorToVectorFunction>
 					getSparsityPatternAndJacobianFunctionOfVectorToVectorFunction(const VectorToVectorFunction f,
-																		const unsigned numberVariablesInput) {
-		const auto [jacobianRows, jacobianCols] = GetSparsityPatternOfVectorToVectorFunction(f, numberVariablesInput)();
-		auto getJacobian = GetJacobianOfVectorToVectorFunctionUsingSparsityPattern(f,
-																					numberVariablesInput,
-																					jacobianRows,
-																					jacobianCols);
-
-		return {jacobianRows, jacobianCols, getJacobian};
-	}
+																		const unsigned numberVariablesInput);
 }
\ No newline at end of file
@@ -0,0 +1,294 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace trajectoryOptimization::instrumentation {
+	using Clock = std::chrono::steady_clock;
+	using Seconds = std::chrono::duration<double>;
+
+	enum Callback {
+		GET_NLP_INFO,
+		GET_BOUNDS_INFO,
+		GET_STARTING_POINT,
+		EVAL_F,
+		EVAL_GRAD_F,
+		EVAL_G,
+		EVAL_JAC_G,
+		EVAL_H,
+		INTERMEDIATE_CALLBACK,
+		FINALIZE_SOLUTION,
+		NUMBER_OF_CALLBACKS
+	};
+
+	const std::array<const char*, NUMBER_OF_CALLBACKS> callbackNames = {"get_nlp_info",
+																		"get_bounds_info",
+																		"get_starting_point",
+																		"eval_f",
+																		"eval_grad_f",
+																		"eval_g",
+																		"eval_jac_g",
+																		"eval_h",
+																		"intermediate_callback",
+																		"finalize_solution"};
+
+	// Bucket b counts calls that took [2^b, 2^(b+1)) nanoseconds, the last bucket everything longer.
+	const unsigned numberOfHistogramBuckets = 40;
+
+	struct CallStatistics {
+		std::string name;
+		unsigned long calls = 0;
+		double totalSeconds = 0;
+		double maxSeconds = 0;
+		std::array<unsigned long, numberOfHistogramBuckets> histogram = {};
+
+		void record(const double seconds) {
+			calls++;
+			totalSeconds += seconds;
+			maxSeconds = std::max(maxSeconds, seconds);
+			const double nanoseconds = seconds * 1e9;
+			const unsigned bucket = nanoseconds < 1 ? 0 : std::min(numberOfHistogramBuckets - 1, (unsigned) std::log2(nanoseconds));
+			histogram[bucket]++;
+		}
+
+		void reset() {
+			calls = 0;
+			totalSeconds = 0;
+			maxSeconds = 0;
+			histogram.fill(0);
+		}
+	};
+
+	struct IterationRecord {
+		int iteration;
+		double objective;
+		double primalInfeasibility;
+		double dualInfeasibility;
+		double mu;
+		double stepNorm;
+		double primalStepSize;
+		double dualStepSize;
+		int lineSearchTrials;
+		double seconds;
+	};
+
+	// Collects what one solve spends where. Everything else in the solve, mostly Ipopt's own linear
+	// algebra, is solveSeconds minus the callback time. Not thread safe, use one per optimizer.
+	class Instrumentation {
+		std::array<CallStatistics, NUMBER_OF_CALLBACKS> callbacks;
+		std::vector<CallStatistics> blocks;
+		unsigned long dynamicsEvaluations;
+		std::vector<IterationRecord> iterations;
+		Clock::time_point solveStart;
+		double solveSeconds;
+
+		static void writeJsonString(std::ostream& stream, const std::string& text) {
+			stream << '"';
+			for (const char character: text) {
+				if (character == '"' || character == '\\') {
+					stream << '\\';
+				}
+				stream << character;
+			}
+			stream << '"';
+		}
+
+		static void writeJsonStatistics(std::ostream& stream, const CallStatistics& statistics) {
+			stream << "{\"name\":";
+			writeJsonString(stream, statistics.name);
+			stream << ",\"calls\":" << statistics.calls
+					<< ",\"totalSeconds\":" << statistics.totalSeconds
+					<< ",\"maxSeconds\":" << statistics.maxSeconds
+					<< ",\"histogram\":[";
+			for (unsigned bucket = 0; bucket < numberOfHistogramBuckets; bucket++) {
+				stream << (bucket ? "," : "") << statistics.histogram[bucket];
+			}
+			stream << "]}";
+		}
+
+		public:
+			Instrumentation(): dynamicsEvaluations(0), solveStart(Clock::now()), solveSeconds(0) {
+				for (unsigned callback = 0; callback < NUMBER_OF_CALLBACKS; callback++) {
+					callbacks[callback].name = callbackNames[callback];
+				}
+			}
+
+			// Clears the statistics of the previous solve, block names stay registered
+			void beginSolve() {
+				for (auto& statistics: callbacks) {
+					statistics.reset();
+				}
+				for (auto& statistics: blocks) {
+					statistics.reset();
+				}
+				dynamicsEvaluations = 0;
+				iterations.clear();
+				solveStart = Clock::now();
+				solveSeconds = 0;
+			}
+
+			void endSolve() {
+				const Seconds elapsed = Clock::now() - solveStart;
+				solveSeconds = elapsed.count();
+			}
+
+			CallStatistics& getCallback(const Callback callback) {
+				return callbacks[callback];
+			}
+
+			const CallStatistics& getCallback(const Callback callback) const {
+				return callbacks[callback];
+			}
+
+			unsigned addBlock(const std::string& name) {
+				CallStatistics statistics;
+				statistics.name = name;
+				blocks.push_back(statistics);
+				return blocks.size() - 1;
+			}
+
+			CallStatistics& getBlock(const unsigned block) {
+				return blocks[block];
+			}
+
+			const std::vector<CallStatistics>& getBlocks() const {
+				return blocks;
+			}
+
+			void countDynamicsEvaluation() {
+				dynamicsEvaluations++;
+			}
+
+			unsigned long getDynamicsEvaluations() const {
+				return dynamicsEvaluations;
+			}
+
+			void recordIteration(IterationRecord record) {
+				const Seconds elapsed = Clock::now() - solveStart;
+				record.seconds = elapsed.count();
+				iterations.push_back(record);
+			}
+
+			const std::vector<IterationRecord>& getIterations() const {
+				return iterations;
+			}
+
+			double getSolveSeconds() const {
+				return solveSeconds;
+			}
+
+			double getCallbackSeconds() const {
+				double seconds = 0;
+				for (const auto& statistics: callbacks) {
+					seconds += statistics.totalSeconds;
+				}
+				return seconds;
+			}
+
+			void toJson(std::ostream& stream) const {
+				stream << "{\"solveSeconds\":" << solveSeconds
+						<< ",\"callbackSeconds\":" << getCallbackSeconds()
+						<< ",\"dynamicsEvaluations\":" << dynamicsEvaluations
+						<< ",\"callbacks\":[";
+				for (unsigned callback = 0; callback < NUMBER_OF_CALLBACKS; callback++) {
+					stream << (callback ? "," : "");
+					writeJsonStatistics(stream, callbacks[callback]);
+				}
+				stream << "],\"blocks\":[";
+				for (unsigned block = 0; block < blocks.size(); block++) {
+					stream << (block ? "," : "");
+					writeJsonStatistics(stream, blocks[block]);
+				}
+				stream << "],\"iterations\":[";
+				for (unsigned index = 0; index < iterations.size(); index++) {
+					const auto& record = iterations[index];
+					stream << (index ? "," : "")
+							<< "{\"iteration\":" << record.iteration
+							<< ",\"objective\":" << record.objective
+							<< ",\"primalInfeasibility\":" << record.primalInfeasibility
+							<< ",\"dualInfeasibility\":" << record.dualInfeasibility
+							<< ",\"mu\":" << record.mu
+							<< ",\"stepNorm\":" << record.stepNorm
+							<< ",\"primalStepSize\":" << record.primalStepSize
+							<< ",\"dualStepSize\":" << record.dualStepSize
+							<< ",\"lineSearchTrials\":" << record.lineSearchTrials
+							<< ",\"seconds\":" << record.seconds << "}";
+				}
+				stream << "]}";
+			}
+
+			// One row per callback and constraint block, the histograms are only in the JSON export
+			void callsToCsv(std::ostream& stream) const {
+				stream << "kind,name,calls,totalSeconds,maxSeconds\n";
+				for (const auto& statistics: callbacks) {
+					stream << "callback," << statistics.name << ',' << statistics.calls << ','
+							<< statistics.totalSeconds << ',' << statistics.maxSeconds << '\n';
+				}
+				for (const auto& statistics: blocks) {
+					stream << "block," << statistics.name << ',' << statistics.calls << ','
+							<< statistics.totalSeconds << ',' << statistics.maxSeconds << '\n';
+				}
+				stream << "dynamics,evaluations," << dynamicsEvaluations << ",0,0\n";
+			}
+
+			void iterationsToCsv(std::ostream& stream) const {
+				stream << "iteration,objective,primalInfeasibility,dualInfeasibility,mu,stepNorm,"
+							"primalStepSize,dualStepSize,lineSearchTrials,seconds\n";
+				for (const auto& record: iterations) {
+					stream << record.iteration << ',' << record.objective << ','
+							<< record.primalInfeasibility << ',' << record.dualInfeasibility << ','
+							<< record.mu << ',' << record.stepNorm << ','
+							<< record.primalStepSize << ',' << record.dualStepSize << ','
+							<< record.lineSearchTrials << ',' << record.seconds << '\n';
+				}
+			}
+	};
+
+	// Records into statistics on destruction; with a null pointer it does not even read the clock.
+	class ScopedTimer {
+		CallStatistics* const statistics;
+		const Clock::time_point start;
+
+		public:
+			explicit ScopedTimer(CallStatistics* statistics):
+				statistics(statistics),
+				start(statistics ? Clock::now() : Clock::time_point()) {}
+
+			~ScopedTimer() {
+				if (statistics) {
+					const Seconds elapsed = Clock::now() - start;
+					statistics->record(elapsed.count());
+				}
+			}
+
+			ScopedTimer(const ScopedTimer&) = delete;
+			ScopedTimer& operator=(const ScopedTimer&) = delete;
+	};
+
+	// Times every call of a constraint block (or any other function), e.g. before stacking constraints
+	template <typename Function>
+	auto instrumentBlock(Function function,
+							const std::shared_ptr<Instrumentation> instrumentation,
+							const std::string& name) {
+		const unsigned block = instrumentation->addBlock(name);
+		return [function, instrumentation, block](auto&&... arguments) mutable {
+			ScopedTimer timer(&instrumentation->getBlock(block));
+			return function(std::forward<decltype(arguments)>(arguments)...);
+		};
+	}
+
+	// Counts evaluations of a dynamics function
+	template <typename Function>
+	auto instrumentDynamics(Function function, const std::shared_ptr<Instrumentation> instrumentation) {
+		return [function, instrumentation](auto&&... arguments) mutable {
+			instrumentation->countDynamicsEvaluation();
+			return function(std::forward<decltype(arguments)>(arguments)...);
+		};
+	}
+}
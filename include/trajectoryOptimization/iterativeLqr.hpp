@@ -0,0 +1,410 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <vector>
+#include "derivative.hpp"
+#include "dynamic.hpp"
+#include "linearAlgebra.hpp"
+#include "optimizer.hpp"
+
+namespace trajectoryOptimization::ilqr {
+	using namespace trajectoryOptimization::linearAlgebra;
+	using namespace trajectoryOptimization::optimizer;
+	using dynamic::DynamicFunction;
+
+	// Cost contributed by the point at timeIndex; it may only read that point of the trajectory,
+	// e.g. WeightedCostSum::atPoint of point-wise terms such as GetControlSquareSum (not GetControlRateSquareSum).
+	using StageCostFunction = std::function<double(const double* trajectoryPointer, const unsigned timeIndex)>;
+
+	// Equality constraint on the leading kinematic entries (position, then velocity) of one point
+	struct KinematicGoal {
+		unsigned timeIndex;
+		std::vector<double> kinematics;
+	};
+
+	struct IterativeLqrOptions {
+		unsigned maxIterations = 200;
+		unsigned maxOuterIterations = 20;
+		double costTolerance = 1e-9;
+		double constraintTolerance = 1e-6;
+		double initialPenalty = 10;
+		double penaltyScale = 10;
+		double minRegularization = 1e-9;
+		double maxRegularization = 1e10;
+	};
+
+	struct IterativeLqrResult {
+		SolverReturn status;
+		numberVector x;
+		numberVector constraints;
+		numberVector lambda;
+		double objectiveValue;
+		unsigned iterations;
+	};
+
+	// Iterative LQR on the stage-wise structure of the trajectory: a Riccati recursion per iteration
+	// costs O(numberOfPoints). Points are stepped with the explicit update of dynamic::stepForward,
+	// so the last point's control has no effect and is kept at zero. Goals and waypoints are handled
+	// by an augmented Lagrangian outer loop.
+	class IterativeLqr {
+		const DynamicFunction dynamics;
+		const StageCostFunction stageCost;
+		const unsigned numberOfPoints;
+		const unsigned positionDimension;
+		const unsigned controlDimension;
+		const unsigned stateDimension;
+		const unsigned pointDimension;
+		const double dt;
+		const std::vector<KinematicGoal> goals;
+		const IterativeLqrOptions options;
+		const unsigned numberConstraints;
+
+		void step(const double* point, double* nextPoint) const {
+			const auto position = point;
+			const auto velocity = point + positionDimension;
+			const auto control = point + stateDimension;
+			const auto acceleration = dynamics(position, positionDimension,
+												velocity, positionDimension,
+												control, controlDimension);
+			for (unsigned index = 0; index < positionDimension; index++) {
+				nextPoint[index] = position[index] + velocity[index] * dt;
+				nextPoint[positionDimension + index] = velocity[index] + acceleration[index] * dt;
+			}
+		}
+
+		void rollout(numberVector& trajectory) const {
+			for (unsigned timeIndex = 0; timeIndex + 1 < numberOfPoints; timeIndex++) {
+				step(trajectory.data() + timeIndex * pointDimension, trajectory.data() + (timeIndex + 1) * pointDimension);
+			}
+		}
+
+		numberVector getConstraints(const numberVector& trajectory) const {
+			numberVector constraints;
+			constraints.reserve(numberConstraints);
+			for (const auto& goal: goals) {
+				const auto point = trajectory.data() + goal.timeIndex * pointDimension;
+				for (unsigned index = 0; index < goal.kinematics.size(); index++) {
+					constraints.push_back(point[index] - goal.kinematics[index]);
+				}
+			}
+			return constraints;
+		}
+
+		double getObjective(const numberVector& trajectory) const {
+			double objective = 0;
+			for (unsigned timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
+				objective += stageCost(trajectory.data(), timeIndex);
+			}
+			return objective;
+		}
+
+		double getLagrangian(const numberVector& trajectory, const numberVector& lambda, const double penalty) const {
+			const auto constraints = getConstraints(trajectory);
+			double lagrangian = getObjective(trajectory);
+			for (unsigned row = 0; row < numberConstraints; row++) {
+				lagrangian += lambda[row] * constraints[row] + 0.5 * penalty * constraints[row] * constraints[row];
+			}
+			return lagrangian;
+		}
+
+		// Gradient and Hessian of the stage cost over the first variableDimension entries of a point
+		void getStageDerivatives(numberVector& trajectory,
+									const unsigned timeIndex,
+									const unsigned variableDimension,
+									std::vector<double>& gradient,
+									Matrix& hessian) const {
+			double* point = trajectory.data() + timeIndex * pointDimension;
+			const auto cost = [&]() { return stageCost(trajectory.data(), timeIndex); };
+			const auto stepSize = [&](const unsigned index) { return 1e-4 * std::max(1.0, std::abs(point[index])); };
+
+			gradient.assign(variableDimension, 0);
+			hessian = Matrix(variableDimension, variableDimension);
+			const double centerCost = cost();
+			for (unsigned row = 0; row < variableDimension; row++) {
+				const double rowValue = point[row];
+				const double rowStep = stepSize(row);
+				point[row] = rowValue + rowStep;
+				const double forwardCost = cost();
+				point[row] = rowValue - rowStep;
+				const double backwardCost = cost();
+				point[row] = rowValue;
+				gradient[row] = (forwardCost - backwardCost) / (2 * rowStep);
+				hessian(row, row) = (forwardCost - 2 * centerCost + backwardCost) / (rowStep * rowStep);
+
+				for (unsigned col = 0; col < row; col++) {
+					const double colValue = point[col];
+					const double colStep = stepSize(col);
+					double corners[4];
+					for (unsigned corner = 0; corner < 4; corner++) {
+						point[row] = rowValue + (corner & 1 ? -rowStep : rowStep);
+						point[col] = colValue + (corner & 2 ? -colStep : colStep);
+						corners[corner] = cost();
+					}
+					point[row] = rowValue;
+					point[col] = colValue;
+					const double crossDerivative = (corners[0] - corners[1] - corners[2] + corners[3]) / (4 * rowStep * colStep);
+					hessian(row, col) = crossDerivative;
+					hessian(col, row) = crossDerivative;
+				}
+			}
+		}
+
+		void addConstraintDerivatives(const numberVector& trajectory,
+										const unsigned timeIndex,
+										const numberVector& lambda,
+										const double penalty,
+										std::vector<double>& gradient,
+										Matrix& hessian) const {
+			unsigned row = 0;
+			for (const auto& goal: goals) {
+				if (goal.timeIndex == timeIndex) {
+					const auto point = trajectory.data() + timeIndex * pointDimension;
+					for (unsigned index = 0; index < goal.kinematics.size(); index++) {
+						const double constraint = point[index] - goal.kinematics[index];
+						gradient[index] += lambda[row + index] + penalty * constraint;
+						hessian(index, index) += penalty;
+					}
+				}
+				row += goal.kinematics.size();
+			}
+		}
+
+		// Linearization of step around a point: next state = A state + B control
+		void getStepJacobians(const numberVector& trajectory, const unsigned timeIndex, Matrix& A, Matrix& B) const {
+			std::vector<double> point(trajectory.begin() + timeIndex * pointDimension,
+										trajectory.begin() + (timeIndex + 1) * pointDimension);
+			std::vector<double> forwardState(stateDimension), backwardState(stateDimension);
+			A = Matrix(stateDimension, stateDimension);
+			B = Matrix(stateDimension, controlDimension);
+
+			for (unsigned col = 0; col < pointDimension; col++) {
+				const double value = point[col];
+				const double h = derivative::calculateH(point.data(), col);
+				point[col] = value + h;
+				step(point.data(), forwardState.data());
+				point[col] = value - h;
+				step(point.data(), backwardState.data());
+				point[col] = value;
+				for (unsigned row = 0; row < stateDimension; row++) {
+					const double partial = derivative::calculateDerivative(h, forwardState[row], backwardState[row]);
+					if (col < stateDimension) {
+						A(row, col) = partial;
+					}
+					else {
+						B(row, col - stateDimension) = partial;
+					}
+				}
+			}
+		}
+
+		bool backwardPass(numberVector& trajectory,
+							const numberVector& lambda,
+							const double penalty,
+							const double regularization,
+							std::vector<std::vector<double>>& feedforwards,
+							std::vector<Matrix>& feedbacks) const {
+			std::vector<double> gradient;
+			Matrix hessian;
+			getStageDerivatives(trajectory, numberOfPoints - 1, stateDimension, gradient, hessian);
+			addConstraintDerivatives(trajectory, numberOfPoints - 1, lambda, penalty, gradient, hessian);
+			std::vector<double> valueGradient = gradient;
+			Matrix valueHessian = hessian;
+
+			Matrix A, B;
+			for (unsigned timeIndex = numberOfPoints - 1; timeIndex-- > 0;) {
+				getStageDerivatives(trajectory, timeIndex, pointDimension, gradient, hessian);
+				addConstraintDerivatives(trajectory, timeIndex, lambda, penalty, gradient, hessian);
+				getStepJacobians(trajectory, timeIndex, A, B);
+
+				Matrix stateHessian(stateDimension, stateDimension), controlHessian(controlDimension, controlDimension);
+				Matrix controlStateHessian(controlDimension, stateDimension);
+				std::vector<double> stateGradient(gradient.begin(), gradient.begin() + stateDimension);
+				std::vector<double> controlGradient(gradient.begin() + stateDimension, gradient.end());
+				for (unsigned row = 0; row < pointDimension; row++) {
+					for (unsigned col = 0; col < pointDimension; col++) {
+						if (row < stateDimension && col < stateDimension) {
+							stateHessian(row, col) = hessian(row, col);
+						}
+						else if (row >= stateDimension && col >= stateDimension) {
+							controlHessian(row - stateDimension, col - stateDimension) = hessian(row, col);
+						}
+						else if (row >= stateDimension) {
+							controlStateHessian(row - stateDimension, col) = hessian(row, col);
+						}
+					}
+				}
+
+				const auto valueHessianA = multiply(valueHessian, A);
+				const auto valueHessianB = multiply(valueHessian, B);
+				const auto qState = add(stateGradient, multiplyTransposed(A, valueGradient));
+				const auto qControl = add(controlGradient, multiplyTransposed(B, valueGradient));
+				const auto qStateState = add(stateHessian, multiplyTransposed(A, valueHessianA));
+				const auto qControlControl = add(add(controlHessian, multiplyTransposed(B, valueHessianB)),
+													identity(controlDimension, regularization));
+				const auto qControlState = add(controlStateHessian, multiplyTransposed(B, valueHessianA));
+
+				Matrix choleskyFactor;
+				if (!choleskyFactorize(symmetrize(qControlControl), choleskyFactor)) {
+					return false;
+				}
+				const auto feedforward = add(std::vector<double>(controlDimension), choleskySolve(choleskyFactor, qControl), -1);
+				const auto feedback = add(Matrix(controlDimension, stateDimension), choleskySolve(choleskyFactor, qControlState), -1);
+
+				// V_x = Q_x + K^T Q_uu k + K^T Q_u + Q_ux^T k, V_xx = Q_xx + K^T Q_uu K + K^T Q_ux + Q_ux^T K
+				const auto qControlControlFeedback = multiply(qControlControl, feedback);
+				valueGradient = add(add(add(qState, multiplyTransposed(feedback, multiply(qControlControl, feedforward))),
+										multiplyTransposed(feedback, qControl)),
+									multiplyTransposed(qControlState, feedforward));
+				valueHessian = symmetrize(add(add(add(qStateState, multiplyTransposed(feedback, qControlControlFeedback)),
+													multiplyTransposed(feedback, qControlState)),
+												multiplyTransposed(qControlState, feedback)));
+
+				feedforwards[timeIndex] = feedforward;
+				feedbacks[timeIndex] = feedback;
+			}
+			return true;
+		}
+
+		numberVector forwardPass(const numberVector& trajectory,
+									const double stepSize,
+									const std::vector<std::vector<double>>& feedforwards,
+									const std::vector<Matrix>& feedbacks) const {
+			numberVector newTrajectory = trajectory;
+			std::vector<double> stateDeviation(stateDimension);
+			for (unsigned timeIndex = 0; timeIndex + 1 < numberOfPoints; timeIndex++) {
+				const auto point = trajectory.data() + timeIndex * pointDimension;
+				const auto newPoint = newTrajectory.data() + timeIndex * pointDimension;
+				for (unsigned index = 0; index < stateDimension; index++) {
+					stateDeviation[index] = newPoint[index] - point[index];
+				}
+				const auto feedbackControl = multiply(feedbacks[timeIndex], stateDeviation);
+				for (unsigned index = 0; index < controlDimension; index++) {
+					newPoint[stateDimension + index] = point[stateDimension + index]
+														+ stepSize * feedforwards[timeIndex][index]
+														+ feedbackControl[index];
+				}
+				step(newPoint, newPoint + pointDimension);
+			}
+			return newTrajectory;
+		}
+
+		public:
+			IterativeLqr(const DynamicFunction dynamics,
+							const StageCostFunction stageCost,
+							const unsigned numberOfPoints,
+							const unsigned positionDimension,
+							const unsigned controlDimension,
+							const double dt,
+							const std::vector<KinematicGoal> goals,
+							const IterativeLqrOptions options = IterativeLqrOptions()):
+								dynamics(dynamics),
+								stageCost(stageCost),
+								numberOfPoints(numberOfPoints),
+								positionDimension(positionDimension),
+								controlDimension(controlDimension),
+								stateDimension(2 * positionDimension),
+								pointDimension(2 * positionDimension + controlDimension),
+								dt(dt),
+								goals(goals),
+								options(options),
+								numberConstraints(std::accumulate(goals.begin(), goals.end(), 0u,
+																	[](const unsigned sum, const KinematicGoal& goal) {
+																		return sum + goal.kinematics.size();
+																	})) {
+									assert(numberOfPoints > 1);
+									for (const auto& goal: goals) {
+										assert(goal.timeIndex < numberOfPoints);
+										assert(goal.kinematics.size() <= stateDimension);
+									}
+								}
+
+			// Only the kinematics of the first point and the controls of startingTrajectory are used,
+			// the remaining kinematics follow from rolling out the dynamics.
+			IterativeLqrResult operator()(const numberVector& startingTrajectory,
+											const FinalizerFunction finalizerFunction) const {
+				assert(startingTrajectory.size() == numberOfPoints * pointDimension);
+				numberVector trajectory = startingTrajectory;
+				std::fill(trajectory.end() - controlDimension, trajectory.end(), 0);
+				rollout(trajectory);
+
+				numberVector lambda(numberConstraints, 0);
+				double penalty = options.initialPenalty;
+				double regularization = options.minRegularization;
+				std::vector<std::vector<double>> feedforwards(numberOfPoints - 1);
+				std::vector<Matrix> feedbacks(numberOfPoints - 1);
+				unsigned iterations = 0;
+				SolverReturn status = MAXITER_EXCEEDED;
+
+				for (unsigned outerIteration = 0; outerIteration < options.maxOuterIterations; outerIteration++) {
+					double lagrangian = getLagrangian(trajectory, lambda, penalty);
+					for (unsigned iteration = 0; iteration < options.maxIterations; iteration++, iterations++) {
+						if (!backwardPass(trajectory, lambda, penalty, regularization, feedforwards, feedbacks)) {
+							regularization *= 10;
+							if (regularization > options.maxRegularization) {
+								break;
+							}
+							continue;
+						}
+
+						bool improved = false;
+						double newLagrangian = lagrangian;
+						for (double stepSize = 1; stepSize > 1e-4; stepSize *= 0.5) {
+							auto newTrajectory = forwardPass(trajectory, stepSize, feedforwards, feedbacks);
+							newLagrangian = getLagrangian(newTrajectory, lambda, penalty);
+							if (newLagrangian < lagrangian) {
+								trajectory = newTrajectory;
+								improved = true;
+								break;
+							}
+						}
+
+						if (!improved) {
+							regularization *= 10;
+							if (regularization > options.maxRegularization) {
+								break;
+							}
+							continue;
+						}
+						regularization = std::max(options.minRegularization, regularization / 10);
+
+						const bool converged = lagrangian - newLagrangian < options.costTolerance * std::max(1.0, std::abs(lagrangian));
+						lagrangian = newLagrangian;
+						if (converged) {
+							break;
+						}
+					}
+
+					const auto constraints = getConstraints(trajectory);
+					double maxViolation = 0;
+					for (const auto constraint: constraints) {
+						maxViolation = std::max(maxViolation, std::abs(constraint));
+					}
+					if (maxViolation <= options.constraintTolerance) {
+						status = SUCCESS;
+						break;
+					}
+					for (unsigned row = 0; row < numberConstraints; row++) {
+						lambda[row] += penalty * constraints[row];
+					}
+					penalty *= options.penaltyScale;
+				}
+
+				const IterativeLqrResult result = {status,
+													trajectory,
+													getConstraints(trajectory),
+													lambda,
+													getObjective(trajectory),
+													iterations};
+
+				const numberVector boundMultipliers(trajectory.size(), 0);
+				finalizerFunction(status, trajectory.size(), result.x.data(),
+									boundMultipliers.data(), boundMultipliers.data(),
+									numberConstraints, result.constraints.data(), result.lambda.data(),
+									result.objectiveValue, NULL, NULL);
+				return result;
+			}
+	};
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace trajectoryOptimization::linearAlgebra {
+
+	// Small dense row-major matrix for the per-point blocks of the structured solvers.
+	class Matrix {
+		unsigned numberRows;
+		unsigned numberCols;
+		std::vector<double> values;
+
+		public:
+			Matrix(): numberRows(0), numberCols(0) {}
+
+			Matrix(const unsigned numberRows, const unsigned numberCols, const double fill = 0):
+				numberRows(numberRows),
+				numberCols(numberCols),
+				values(numberRows * numberCols, fill) {}
+
+			double& operator()(const unsigned row, const unsigned col) {
+				assert(row < numberRows && col < numberCols);
+				return values[row * numberCols + col];
+			}
+
+			double operator()(const unsigned row, const unsigned col) const {
+				assert(row < numberRows && col < numberCols);
+				return values[row * numberCols + col];
+			}
+
+			unsigned rows() const { return numberRows; }
+			unsigned cols() const { return numberCols; }
+	};
+
+	Matrix identity(const unsigned dimension, const double diagonal = 1);
+
+	Matrix transpose(const Matrix& A);
+
+	Matrix multiply(const Matrix& A, const Matrix& B);
+
+	// A^T B without forming the transpose
+	Matrix multiplyTransposed(const Matrix& A, const Matrix& B);
+
+	std::vector<double> multiply(const Matrix& A, const std::vector<double>& v);
+
+	std::vector<double> multiplyTransposed(const Matrix& A, const std::vector<double>& v);
+
+	Matrix add(const Matrix& A, const Matrix& B, const double scaleB = 1);
+
+	std::vector<double> add(const std::vector<double>& a, const std::vector<double>& b, const double scaleB = 1);
+
+	Matrix symmetrize(const Matrix& A);
+
+	// Lower triangular L with A = L L^T, false if A is not positive definite
+	bool choleskyFactorize(const Matrix& A, Matrix& L);
+
+	std::vector<double> choleskySolve(const Matrix& L, std::vector<double> b);
+
+	Matrix choleskySolve(const Matrix& L, const Matrix& B);
+
+	// Square band matrix; every row keeps room for the fill-in of partial pivoting, columns
+	// [row - lowerBandwidth, row + lowerBandwidth + upperBandwidth].
+	class BandedMatrix {
+		unsigned matrixDimension;
+		unsigned lower;
+		unsigned upper;
+		unsigned rowWidth;
+		std::vector<double> values;
+
+		public:
+			BandedMatrix(): matrixDimension(0), lower(0), upper(0), rowWidth(0) {}
+
+			BandedMatrix(const unsigned dimension, const unsigned lowerBandwidth, const unsigned upperBandwidth):
+				matrixDimension(dimension),
+				lower(lowerBandwidth),
+				upper(upperBandwidth),
+				rowWidth(2 * lowerBandwidth + upperBandwidth + 1),
+				values(dimension * rowWidth, 0) {}
+
+			bool inBand(const unsigned row, const unsigned col) const {
+				return row < matrixDimension && col < matrixDimension
+						&& col + lower >= row && col <= row + lower + upper;
+			}
+
+			double& operator()(const unsigned row, const unsigned col) {
+				assert(inBand(row, col));
+				return values[row * rowWidth + col + lower - row];
+			}
+
+			double operator()(const unsigned row, const unsigned col) const {
+				return inBand(row, col) ? values[row * rowWidth + col + lower - row] : 0;
+			}
+
+			unsigned dimension() const { return matrixDimension; }
+			unsigned lowerBandwidth() const { return lower; }
+			unsigned upperBandwidth() const { return upper; }
+	};
+
+	// In-place LU with partial pivoting in O(dimension * lower * (lower + upper)), false if singular.
+	// Like LAPACK's gbtrf the multipliers are not permuted by later row swaps.
+	bool bandedLuFactorize(BandedMatrix& A, std::vector<unsigned>& pivots);
+
+	void bandedLuSolve(const BandedMatrix& LU, const std::vector<unsigned>& pivots, std::vector<double>& b);
+}
@@ -0,0 +1,267 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "linearAlgebra.hpp"
+#include "optimizer.hpp"
+
+namespace trajectoryOptimization::lq {
+	using namespace trajectoryOptimization::linearAlgebra;
+	using namespace trajectoryOptimization::optimizer;
+
+	// minimize 0.5 x^T H x + linearCost^T x + constantCost
+	// subject to jacobian x + constraintOffsets = constraintTargets, xLowerBounds <= x <= xUpperBounds.
+	// H is given by its lower triangle in the same triplet form as Ipopt's Hessian.
+	// Variables with equal bounds are fixed, other bounds are only checked at the solution.
+	struct LinearQuadraticProblem {
+		Index numberVariables;
+		Index numberConstraints;
+		indexVector hessianRows;
+		indexVector hessianCols;
+		numberVector hessianValues;
+		numberVector linearCost;
+		Number constantCost;
+		indexVector jacobianRows;
+		indexVector jacobianCols;
+		numberVector jacobianValues;
+		numberVector constraintOffsets;
+		numberVector constraintTargets;
+		numberVector xLowerBounds;
+		numberVector xUpperBounds;
+	};
+
+	struct LinearQuadraticSolution {
+		SolverReturn status;
+		PrimalDualPoint solution;
+		numberVector constraints;
+		Number objectiveValue;
+	};
+
+	namespace detail {
+		bool isClose(const double expected, const double actual, const double tolerance);
+
+		// Symmetric product of a lower triangle in triplet form
+		numberVector multiplyLowerTriangle(const indexVector& rows, const indexVector& cols,
+											const numberVector& values, const numberVector& x);
+	}
+
+	// Evaluates the problem functions at zero and at a second point and returns the linear-quadratic
+	// problem they describe, or nothing if the constraints are not affine equalities or the objective
+	// is not quadratic. The Hessian is the objective's alone, so it has to be exact even if Ipopt
+	// itself runs with a limited-memory approximation. tolerance is relative, the Jacobian and
+	// gradient are usually finite differences.
+	std::optional<LinearQuadraticProblem> detectLinearQuadratic(const numberVector& xLowerBounds,
+																const numberVector& xUpperBounds,
+																const numberVector& gLowerBounds,
+																const numberVector& gUpperBounds,
+																const EvaluateObjectiveFunction& objectiveFunction,
+																const EvaluateGradientInPlaceFunction& gradientFunction,
+																const EvaluateConstraintInPlaceFunction& constraintFunction,
+																const GetJacobianValueInPlaceFunction& jacobianValueFunction,
+																const indexVector& jacobianRows,
+																const indexVector& jacobianCols,
+																const GetHessianValueInPlaceFunction& objectiveHessianValueFunction,
+																const indexVector& hessianRows,
+																const indexVector& hessianCols,
+																const double tolerance = 1e-6);
+
+	// Factorizes the KKT matrix [H J^T; J 0] of the free variables once; every call then solves
+	// [H J^T; J 0] [x; lambda] = [-linearCost; targets - offsets] for given values of the fixed variables
+	// with one back substitution. Unknowns are ordered by trajectory index with every constraint placed
+	// after the last variable it touches, so for trajectory problems the bandwidth is a few point
+	// dimensions and the cost is linear in the number of points.
+	// Multipliers follow Ipopt's sign convention, the bound multipliers are zero.
+	class FactorizeLinearQuadratic {
+		const LinearQuadraticProblem problem;
+		std::vector<bool> isFree;
+		std::vector<long> position;
+		unsigned kktDimension;
+		BandedMatrix kkt;
+		std::vector<unsigned> pivots;
+		bool factorized;
+
+		public:
+			FactorizeLinearQuadratic(const LinearQuadraticProblem problem):
+				problem(problem),
+				isFree(problem.numberVariables),
+				position(problem.numberVariables + problem.numberConstraints, -1) {
+					const Index n = problem.numberVariables;
+					const Index m = problem.numberConstraints;
+					for (Index index = 0; index < n; index++) {
+						isFree[index] = problem.xLowerBounds[index] != problem.xUpperBounds[index];
+					}
+
+					std::vector<long> lastFreeColumn(m, -1);
+					for (unsigned entry = 0; entry < problem.jacobianValues.size(); entry++) {
+						const Index col = problem.jacobianCols[entry];
+						if (isFree[col] && problem.jacobianValues[entry] != 0) {
+							lastFreeColumn[problem.jacobianRows[entry]] = std::max<long>(lastFreeColumn[problem.jacobianRows[entry]], col);
+						}
+					}
+
+					// Sort keys interleave variables (2 col) and constraints (2 lastFreeColumn + 1)
+					std::vector<std::pair<long, Index>> order;
+					for (Index index = 0; index < n; index++) {
+						if (isFree[index]) {
+							order.push_back({2l * index, index});
+						}
+					}
+					for (Index row = 0; row < m; row++) {
+						if (lastFreeColumn[row] >= 0) {
+							order.push_back({2 * lastFreeColumn[row] + 1, n + row});
+						}
+					}
+					std::sort(order.begin(), order.end());
+					kktDimension = order.size();
+					for (unsigned index = 0; index < kktDimension; index++) {
+						position[order[index].second] = index;
+					}
+
+					unsigned lowerBandwidth = 0;
+					unsigned upperBandwidth = 0;
+					const auto widenBand = [&](const long row, const long col) {
+						lowerBandwidth = std::max<long>(lowerBandwidth, row - col);
+						upperBandwidth = std::max<long>(upperBandwidth, col - row);
+					};
+					for (unsigned entry = 0; entry < problem.hessianValues.size(); entry++) {
+						const Index row = problem.hessianRows[entry];
+						const Index col = problem.hessianCols[entry];
+						if (isFree[row] && isFree[col]) {
+							widenBand(position[row], position[col]);
+							widenBand(position[col], position[row]);
+						}
+					}
+					for (unsigned entry = 0; entry < problem.jacobianValues.size(); entry++) {
+						const Index row = problem.jacobianRows[entry];
+						const Index col = problem.jacobianCols[entry];
+						if (position[n + row] >= 0 && isFree[col]) {
+							widenBand(position[n + row], position[col]);
+							widenBand(position[col], position[n + row]);
+						}
+					}
+
+					kkt = BandedMatrix(kktDimension, lowerBandwidth, upperBandwidth);
+					for (unsigned entry = 0; entry < problem.hessianValues.size(); entry++) {
+						const Index row = problem.hessianRows[entry];
+						const Index col = problem.hessianCols[entry];
+						if (isFree[row] && isFree[col]) {
+							kkt(position[row], position[col]) += problem.hessianValues[entry];
+							if (row != col) {
+								kkt(position[col], position[row]) += problem.hessianValues[entry];
+							}
+						}
+					}
+					for (unsigned entry = 0; entry < problem.jacobianValues.size(); entry++) {
+						const Index row = problem.jacobianRows[entry];
+						const Index col = problem.jacobianCols[entry];
+						if (position[n + row] >= 0 && isFree[col]) {
+							kkt(position[n + row], position[col]) += problem.jacobianValues[entry];
+							kkt(position[col], position[n + row]) += problem.jacobianValues[entry];
+						}
+					}
+
+					factorized = bandedLuFactorize(kkt, pivots);
+				}
+
+			bool succeeded() const {
+				return factorized;
+			}
+
+			// Only the entries of fixedValues at fixed variables are read
+			LinearQuadraticSolution operator()(const numberVector& fixedValues) const {
+				const Index n = problem.numberVariables;
+				const Index m = problem.numberConstraints;
+				assert(fixedValues.size() == (size_t) n);
+				LinearQuadraticSolution result = {ERROR_IN_STEP_COMPUTATION,
+													{numberVector(n), numberVector(n, 0), numberVector(n, 0), numberVector(m, 0)},
+													numberVector(m),
+													0};
+				if (!factorized) {
+					return result;
+				}
+				numberVector& x = result.solution.x;
+				for (Index index = 0; index < n; index++) {
+					x[index] = isFree[index] ? 0 : fixedValues[index];
+				}
+
+				// Right hand side with the fixed variables moved over
+				numberVector rightHandSide(kktDimension, 0);
+				for (Index index = 0; index < n; index++) {
+					if (isFree[index]) {
+						rightHandSide[position[index]] = -problem.linearCost[index];
+					}
+				}
+				for (Index row = 0; row < m; row++) {
+					if (position[n + row] >= 0) {
+						rightHandSide[position[n + row]] = problem.constraintTargets[row] - problem.constraintOffsets[row];
+					}
+				}
+				for (unsigned entry = 0; entry < problem.hessianValues.size(); entry++) {
+					const Index row = problem.hessianRows[entry];
+					const Index col = problem.hessianCols[entry];
+					if (isFree[row] && !isFree[col]) {
+						rightHandSide[position[row]] -= problem.hessianValues[entry] * x[col];
+					}
+					if (row != col && isFree[col] && !isFree[row]) {
+						rightHandSide[position[col]] -= problem.hessianValues[entry] * x[row];
+					}
+				}
+				for (unsigned entry = 0; entry < problem.jacobianValues.size(); entry++) {
+					const Index row = problem.jacobianRows[entry];
+					const Index col = problem.jacobianCols[entry];
+					if (position[n + row] >= 0 && !isFree[col]) {
+						rightHandSide[position[n + row]] -= problem.jacobianValues[entry] * x[col];
+					}
+				}
+
+				bandedLuSolve(kkt, pivots, rightHandSide);
+				for (Index index = 0; index < n; index++) {
+					if (isFree[index]) {
+						x[index] = rightHandSide[position[index]];
+					}
+				}
+				for (Index row = 0; row < m; row++) {
+					if (position[n + row] >= 0) {
+						result.solution.lambda[row] = rightHandSide[position[n + row]];
+					}
+				}
+
+				result.constraints = problem.constraintOffsets;
+				for (unsigned entry = 0; entry < problem.jacobianValues.size(); entry++) {
+					result.constraints[problem.jacobianRows[entry]] += problem.jacobianValues[entry] * x[problem.jacobianCols[entry]];
+				}
+				const auto hessianTimesX = detail::multiplyLowerTriangle(problem.hessianRows, problem.hessianCols,
+																			problem.hessianValues, x);
+				result.objectiveValue = problem.constantCost;
+				for (Index index = 0; index < n; index++) {
+					result.objectiveValue += (0.5 * hessianTimesX[index] + problem.linearCost[index]) * x[index];
+				}
+
+				result.status = SUCCESS;
+				for (Index row = 0; row < m; row++) {
+					// Rows without free variables are constant, they either hold or make the problem infeasible
+					if (position[n + row] < 0 && !detail::isClose(problem.constraintTargets[row], result.constraints[row], 1e-9)) {
+						result.status = LOCAL_INFEASIBILITY;
+					}
+				}
+				for (Index index = 0; index < n; index++) {
+					// An active inequality bound needs the interior point solver
+					if (isFree[index] && (x[index] < problem.xLowerBounds[index] || x[index] > problem.xUpperBounds[index])) {
+						result.status = LOCAL_INFEASIBILITY;
+					}
+				}
+				return result;
+			}
+	};
+
+	// Fixed variables take the value of their bounds
+	LinearQuadraticSolution solveLinearQuadratic(const LinearQuadraticProblem& problem);
+
+	// Hands a successful solve to the same finalizer TrajectoryOptimizer would call
+	void reportLinearQuadraticSolution(const LinearQuadraticSolution& result, const FinalizerFunction& finalizerFunction);
+}
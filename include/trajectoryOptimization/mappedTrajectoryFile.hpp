@@ -0,0 +1,182 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "trajectoryFile.hpp"
+#include "trajectoryView.hpp"
+#include "utilities.hpp"
+
+namespace trajectoryOptimization::trajectoryFile {
+
+	// A record inside a mapped file; every pointer points into the mapping, nothing is copied.
+	// Multiplier pointers are null when the record was written without them.
+	struct MappedRecord {
+		const RecordHeader* header;
+		const double* x;
+		const double* timeStepSizes;
+		const double* zLower;
+		const double* zUpper;
+		const double* lambda;
+
+		unsigned getNumberOfPoints() const {
+			return header->numberOfPoints;
+		}
+
+		unsigned getPointDimension() const {
+			return 2 * header->positionDimension + header->controlDimension;
+		}
+
+		trajectoryView::TrajectoryView getTrajectory() const {
+			return {x, getNumberOfPoints(), header->positionDimension, header->controlDimension};
+		}
+
+		const double* getPoint(const unsigned timeIndex) const {
+			assert(timeIndex < getNumberOfPoints());
+			return x + timeIndex * getPointDimension();
+		}
+
+		const double* getPosition(const unsigned timeIndex) const {
+			return getPoint(timeIndex);
+		}
+
+		const double* getVelocity(const unsigned timeIndex) const {
+			return getPoint(timeIndex) + header->positionDimension;
+		}
+
+		const double* getControl(const unsigned timeIndex) const {
+			return getPoint(timeIndex) + 2 * header->positionDimension;
+		}
+
+		double getTimeStepSize(const unsigned interval) const {
+			assert(interval + 1 < getNumberOfPoints());
+			return timeStepSizes ? timeStepSizes[interval] : header->timeStepSize;
+		}
+
+		std::vector<double> getKnotTimes() const {
+			std::vector<double> knotTimes(getNumberOfPoints(), 0);
+			for (unsigned interval = 0; interval + 1 < knotTimes.size(); interval++) {
+				knotTimes[interval + 1] = knotTimes[interval] + getTimeStepSize(interval);
+			}
+			return knotTimes;
+		}
+
+		// Copy for TrajectoryOptimizer::setStartingPoint, with the multipliers that were stored
+		PrimalDualPoint toPrimalDualPoint() const {
+			const size_t n = (size_t) getNumberOfPoints() * getPointDimension();
+			return {numberVector(x, x + n),
+					zLower ? numberVector(zLower, zLower + n) : numberVector(),
+					zUpper ? numberVector(zUpper, zUpper + n) : numberVector(),
+					lambda ? numberVector(lambda, lambda + header->numberConstraints) : numberVector()};
+		}
+	};
+
+	// Maps a trajectory file read-only and indexes its records. Records stay valid as long as the
+	// file object lives. A truncated or foreign tail ends the index, see isComplete.
+	class MappedTrajectoryFile {
+		const char* data;
+		size_t size;
+		bool complete;
+		std::vector<MappedRecord> records;
+
+		void index() {
+			size_t offset = 0;
+			const auto take = [this, &offset](const size_t count) -> const double* {
+				const size_t bytes = count * sizeof(double);
+				if (offset + bytes > size) {
+					return nullptr;
+				}
+				const double* values = reinterpret_cast<const double*>(data + offset);
+				offset += bytes;
+				return values;
+			};
+
+			while (offset + sizeof(RecordHeader) <= size) {
+				const RecordHeader* header = reinterpret_cast<const RecordHeader*>(data + offset);
+				if (header->magic != magic || header->version != version) {
+					return;
+				}
+				offset += sizeof(RecordHeader);
+
+				const size_t n = (size_t) header->numberOfPoints * (2 * header->positionDimension + header->controlDimension);
+				MappedRecord record = {header, take(n), nullptr, nullptr, nullptr, nullptr};
+				bool valid = record.x != nullptr;
+				if (header->flags & HAS_TIME_STEP_SIZES) {
+					valid = valid && header->numberOfPoints > 0 && (record.timeStepSizes = take(header->numberOfPoints - 1));
+				}
+				if (header->flags & HAS_BOUND_MULTIPLIERS) {
+					valid = valid && (record.zLower = take(n)) && (record.zUpper = take(n));
+				}
+				if (header->flags & HAS_CONSTRAINT_MULTIPLIERS) {
+					valid = valid && (record.lambda = take(header->numberConstraints));
+				}
+				if (!valid) {
+					return;
+				}
+				records.push_back(record);
+			}
+			complete = offset == size;
+		}
+
+		public:
+			explicit MappedTrajectoryFile(const std::string& filename): data(nullptr), size(0), complete(false) {
+				const int descriptor = open(filename.c_str(), O_RDONLY);
+				if (descriptor < 0) {
+					return;
+				}
+				struct stat status;
+				if (fstat(descriptor, &status) == 0) {
+					// mmap refuses empty files, which are complete without records
+					complete = status.st_size == 0;
+					void* mapping = complete ? MAP_FAILED : mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+					if (mapping != MAP_FAILED) {
+						data = static_cast<const char*>(mapping);
+						size = status.st_size;
+					}
+				}
+				close(descriptor);
+				if (data) {
+					index();
+				}
+			}
+
+			~MappedTrajectoryFile() {
+				if (data) {
+					munmap(const_cast<char*>(data), size);
+				}
+			}
+
+			MappedTrajectoryFile(const MappedTrajectoryFile&) = delete;
+			MappedTrajectoryFile& operator=(const MappedTrajectoryFile&) = delete;
+
+			// Every byte of the file belongs to an indexed record
+			bool isComplete() const {
+				return complete;
+			}
+
+			size_t getNumberOfRecords() const {
+				return records.size();
+			}
+
+			const MappedRecord& operator[](const size_t recordIndex) const {
+				return records[recordIndex];
+			}
+
+			const std::vector<MappedRecord>& getRecords() const {
+				return records;
+			}
+	};
+
+	// Samples a stored trajectory at new knot times within its time span. Positions follow the cubic
+	// Hermite curve their velocities define, velocities and controls are linear between knots, so no
+	// dynamics are needed. Meant for xStartingPoint of a problem with a different number of points.
+	numberVector resampleTrajectory(const MappedRecord& record, const std::vector<double>& newKnotTimes);
+
+	// Onto numberOfPoints evenly spaced knots over the stored time span
+	numberVector resampleTrajectory(const MappedRecord& record, const unsigned numberOfPoints);
+}
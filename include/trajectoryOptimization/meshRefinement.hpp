@@ -0,0 +1,165 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <vector>
+#include "coin/IpIpoptApplication.hpp"
+#include "coin/IpSolveStatistics.hpp"
+#include "dynamic.hpp"
+#include "optimizer.hpp"
+#include "problem.hpp"
+#include "utilities.hpp"
+
+namespace trajectoryOptimization::mesh {
+	using namespace trajectoryOptimization::optimizer;
+	using dynamic::DynamicFunction;
+	using problem::TrajectoryProblem;
+	using utilities::getUniformKnotTimes;
+
+	// Builds the problem on a mesh, e.g. with the per-interval TrajectoryProblem constructor and
+	// getTimeStepSizes. Knots are only ever inserted, so goals placed on the initial knots can be
+	// found again with findKnotIndex. The starting point is overwritten by the driver.
+	using ProblemFactory = std::function<TrajectoryProblem(const std::vector<double>& knotTimes)>;
+
+	struct MeshRefinementOptions {
+		// Largest accepted state error an interval accumulates, see getIntervalDefects
+		double defectTolerance = 1e-3;
+		unsigned maxLevels = 6;
+		unsigned maxNumberOfPoints = 2000;
+	};
+
+	struct MeshLevel {
+		unsigned numberOfPoints;
+		ApplicationReturnStatus status;
+		Index iterationCount;
+		double maxDefect;
+		unsigned insertedPoints;
+		double seconds;
+	};
+
+	struct MeshRefinementResult {
+		ApplicationReturnStatus status;
+		std::vector<double> knotTimes;
+		PrimalDualPoint solution;
+		std::vector<MeshLevel> levels;
+	};
+
+	std::vector<double> getTimeStepSizes(const std::vector<double>& knotTimes);
+
+	unsigned findKnotIndex(const std::vector<double>& knotTimes, const double time, const double tolerance = 1e-9);
+
+	namespace detail {
+		// State derivative (velocity, acceleration) of one point
+		std::vector<double> getStateDerivative(const double* point,
+												const unsigned positionDimension,
+												const unsigned controlDimension,
+												const DynamicFunction& dynamics);
+	}
+
+	// Error estimate per interval: the cubic Hermite interpolant through both knots, with slopes from
+	// the dynamics, is checked against the dynamics at the interval midpoint. The largest difference
+	// of its slope there times the interval length is what the trapezoidal rule gets wrong locally; it
+	// vanishes wherever the state is a cubic, and shrinks with h^3 otherwise.
+	std::vector<double> getIntervalDefects(const numberVector& x,
+											const std::vector<double>& knotTimes,
+											const unsigned positionDimension,
+											const unsigned controlDimension,
+											const DynamicFunction& dynamics);
+
+	// Bisects every interval whose defect is above the tolerance
+	std::vector<double> refineKnotTimes(const std::vector<double>& knotTimes,
+										const std::vector<double>& defects,
+										const double defectTolerance);
+
+	// Evaluates the Hermite interpolant of a trajectory at new knots inside its time span
+	numberVector interpolateTrajectory(const numberVector& x,
+										const std::vector<double>& knotTimes,
+										const std::vector<double>& newKnotTimes,
+										const unsigned positionDimension,
+										const unsigned controlDimension,
+										const DynamicFunction& dynamics);
+
+	// Coarse to fine: solves on the initial mesh, bisects the intervals whose defect is above the
+	// tolerance and solves again from the interpolated solution, until every interval is accurate
+	// enough or a limit is hit. Coarse levels are cheap and put the fine solve next to its solution.
+	class RefineMesh {
+		const ProblemFactory problemFactory;
+		const unsigned positionDimension;
+		const unsigned controlDimension;
+		const DynamicFunction dynamics;
+		const MeshRefinementOptions options;
+
+		public:
+			RefineMesh(const ProblemFactory problemFactory,
+						const unsigned positionDimension,
+						const unsigned controlDimension,
+						const DynamicFunction dynamics,
+						const MeshRefinementOptions options = MeshRefinementOptions()):
+							problemFactory(problemFactory),
+							positionDimension(positionDimension),
+							controlDimension(controlDimension),
+							dynamics(dynamics),
+							options(options) {}
+
+			// Starts from zeros unless a starting trajectory on initialKnotTimes is given
+			MeshRefinementResult operator()(const SmartPtr<IpoptApplication>& app,
+											const std::vector<double>& initialKnotTimes,
+											const numberVector& startingTrajectory = {}) const {
+				const FinalizerFunction finalizerFunction = [](SolverReturn status, Index n, const Number* x,
+																const Number* zLower, const Number* zUpper,
+																Index m, const Number* g, const Number* lambda,
+																Number objValue, const IpoptData* ipData,
+																IpoptCalculatedQuantities* ipCalculatedQuantities) {};
+				const unsigned pointDimension = 2 * positionDimension + controlDimension;
+				problem::StructureCache cache;
+
+				MeshRefinementResult result = {Internal_Error, initialKnotTimes, {}, {}};
+				numberVector xStartingPoint = startingTrajectory.empty() ?
+												numberVector(initialKnotTimes.size() * pointDimension, 0) :
+												startingTrajectory;
+				for (unsigned level = 0; level < options.maxLevels; level++) {
+					const auto start = std::chrono::steady_clock::now();
+					auto trajectoryProblem = problemFactory(result.knotTimes);
+					trajectoryProblem.setStartingPoint(xStartingPoint);
+					SmartPtr<TrajectoryOptimizer> trajectoryOptimizer = trajectoryProblem.build(finalizerFunction, cache);
+
+					setHessianApproximation(app, trajectoryOptimizer->getSparsityStructure());
+					result.status = app->OptimizeTNLP(trajectoryOptimizer);
+					MeshLevel meshLevel = {(unsigned) result.knotTimes.size(), result.status, 0, 0, 0, 0};
+					if (IsValid(app->Statistics())) {
+						meshLevel.iterationCount = app->Statistics()->IterationCount();
+					}
+					if (!trajectoryOptimizer->hasSolution()) {
+						result.levels.push_back(meshLevel);
+						break;
+					}
+					result.solution = trajectoryOptimizer->getSolution();
+
+					const auto defects = getIntervalDefects(result.solution.x, result.knotTimes,
+															positionDimension, controlDimension, dynamics);
+					meshLevel.maxDefect = *std::max_element(defects.begin(), defects.end());
+					const auto refinedKnotTimes = refineKnotTimes(result.knotTimes, defects, options.defectTolerance);
+					const bool refine = result.status == Solve_Succeeded
+										&& refinedKnotTimes.size() > result.knotTimes.size()
+										&& refinedKnotTimes.size() <= options.maxNumberOfPoints
+										&& level + 1 < options.maxLevels;
+					if (refine) {
+						meshLevel.insertedPoints = refinedKnotTimes.size() - result.knotTimes.size();
+						xStartingPoint = interpolateTrajectory(result.solution.x, result.knotTimes, refinedKnotTimes,
+																positionDimension, controlDimension, dynamics);
+					}
+					const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+					meshLevel.seconds = elapsed.count();
+					result.levels.push_back(meshLevel);
+
+					if (!refine) {
+						break;
+					}
+					result.knotTimes = refinedKnotTimes;
+				}
+				return result;
+			}
+	};
+}
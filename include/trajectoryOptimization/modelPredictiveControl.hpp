@@ -0,0 +1,152 @@
+#pragma once
+#include <chrono>
+#include <cassert>
+#include <algorithm>
+#include <vector>
+#include "coin/IpIpoptApplication.hpp"
+#include "optimizer.hpp"
+
+namespace trajectoryOptimization::mpc {
+	using namespace trajectoryOptimization::optimizer;
+
+	using Clock = std::chrono::steady_clock;
+	using Seconds = std::chrono::duration<double>;
+
+	struct LatencyStatistics {
+		unsigned numberOfTicks;
+		unsigned deadlineMisses;
+		double last;
+		double mean;
+		double min;
+		double max;
+		double median;
+		double percentile99;
+	};
+
+	struct TickResult {
+		ApplicationReturnStatus status;
+		bool metDeadline;
+		double seconds;
+		// The controls of the first point, what to apply until the next tick
+		numberVector control;
+	};
+
+	// Maps every constraint row to the row whose multiplier it takes over after shifting by one point.
+	// Rows of the per-point block [blockStartRow, blockStartRow + rowsPerPoint * numberOfBlocks) move down
+	// one block, the last block and all rows outside the block keep their own multiplier.
+	indexVector getConstraintShiftMap(const unsigned numberConstraints,
+										const unsigned blockStartRow,
+										const unsigned rowsPerPoint,
+										const unsigned numberOfBlocks);
+
+	numberVector shiftPointsByOne(const numberVector& values, const unsigned pointDimension);
+
+	PrimalDualPoint shiftPrimalDualPoint(const PrimalDualPoint& primalDualPoint,
+											const unsigned pointDimension,
+											const indexVector& constraintShiftMap);
+
+	LatencyStatistics getLatencyStatistics(std::vector<double> latencies, const unsigned deadlineMisses);
+
+	// Receding-horizon driver: the optimizer, its sparsity and the Ipopt application live across ticks.
+	// The measured kinematics are imposed by fixing the bounds of the first point, so every tick solves
+	// a problem with the same structure, warm started from the previous solution shifted by one point.
+	class ModelPredictiveControl {
+		const SmartPtr<TrajectoryOptimizer> trajectoryOptimizer;
+		const SmartPtr<IpoptApplication> app;
+		const unsigned pointDimension;
+		const unsigned kinematicDimension;
+		const indexVector constraintShiftMap;
+		const Seconds deadline;
+		const numberVector xLowerBounds;
+		const numberVector xUpperBounds;
+		Clock::time_point deadlineTime;
+		std::vector<double> latencies;
+		unsigned deadlineMisses;
+		bool solvedOnce;
+
+		public:
+			ModelPredictiveControl(const SmartPtr<TrajectoryOptimizer> trajectoryOptimizer,
+									const SmartPtr<IpoptApplication> app,
+									const unsigned pointDimension,
+									const unsigned kinematicDimension,
+									const indexVector constraintShiftMap,
+									const Seconds deadline):
+										trajectoryOptimizer(trajectoryOptimizer),
+										app(app),
+										pointDimension(pointDimension),
+										kinematicDimension(kinematicDimension),
+										constraintShiftMap(constraintShiftMap),
+										deadline(deadline),
+										xLowerBounds(trajectoryOptimizer->getVariableLowerBounds()),
+										xUpperBounds(trajectoryOptimizer->getVariableUpperBounds()),
+										deadlineMisses(0),
+										solvedOnce(false) {
+											assert(kinematicDimension <= pointDimension);
+											setHessianApproximation(app, trajectoryOptimizer->getSparsityStructure());
+											trajectoryOptimizer->setIntermediateFunction([this](AlgorithmMode mode, Index iteration,
+																					Number objValue, Number primalInfeasibility,
+																					Number dualInfeasibility, Number mu, Number stepNorm,
+																					Number regularizationSize, Number dualStepSize,
+																					Number primalStepSize, Index lineSearchTrials,
+																					const IpoptData* ipData,
+																					IpoptCalculatedQuantities* ipCalculatedQuantities) {
+												return Clock::now() < deadlineTime;
+											});
+										}
+
+			TickResult tick(const numberVector& measuredKinematics) {
+				assert(measuredKinematics.size() == kinematicDimension);
+				const auto tickStart = Clock::now();
+				deadlineTime = tickStart + std::chrono::duration_cast<Clock::duration>(deadline);
+
+				PrimalDualPoint startingPoint = trajectoryOptimizer->hasSolution() ?
+													shiftPrimalDualPoint(trajectoryOptimizer->getSolution(),
+																			pointDimension,
+																			constraintShiftMap) :
+													trajectoryOptimizer->getStartingPoint();
+				std::copy(measuredKinematics.begin(), measuredKinematics.end(), startingPoint.x.begin());
+				trajectoryOptimizer->setStartingPoint(startingPoint);
+
+				numberVector lowerBounds = xLowerBounds;
+				numberVector upperBounds = xUpperBounds;
+				std::copy(measuredKinematics.begin(), measuredKinematics.end(), lowerBounds.begin());
+				std::copy(measuredKinematics.begin(), measuredKinematics.end(), upperBounds.begin());
+				trajectoryOptimizer->setVariableBounds(lowerBounds, upperBounds);
+
+				ApplicationReturnStatus status;
+				if (solvedOnce) {
+					status = app->ReOptimizeTNLP(trajectoryOptimizer);
+				}
+				else {
+					status = app->OptimizeTNLP(trajectoryOptimizer);
+					enableWarmStart(app);
+					solvedOnce = true;
+				}
+
+				const Seconds elapsed = Clock::now() - tickStart;
+				const bool metDeadline = elapsed <= deadline && status != User_Requested_Stop;
+				latencies.push_back(elapsed.count());
+				if (!metDeadline) {
+					deadlineMisses++;
+				}
+
+				// Empty if Ipopt stopped before finalizing a solution
+				const numberVector& x = trajectoryOptimizer->getSolution().x;
+				return {status, metDeadline, elapsed.count(),
+						x.empty() ? numberVector() : numberVector(x.begin() + kinematicDimension, x.begin() + pointDimension)};
+			}
+
+			const PrimalDualPoint& getSolution() const {
+				return trajectoryOptimizer->getSolution();
+			}
+
+			LatencyStatistics getLatencyStatistics() const {
+				return mpc::getLatencyStatistics(latencies, deadlineMisses);
+			}
+
+		private:
+			// The optimizer keeps a callback pointing at this driver
+			ModelPredictiveControl(const ModelPredictiveControl&);
+			ModelPredictiveControl& operator=(const ModelPredictiveControl&);
+	};
+}
@@ -0,0 +1,240 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "coin/IpIpoptApplication.hpp"
+#include "coin/IpSolveStatistics.hpp"
+#include "batch.hpp"
+#include "dynamic.hpp"
+#include "optimizer.hpp"
+#include "problem.hpp"
+
+namespace trajectoryOptimization::multistart {
+	using namespace trajectoryOptimization::optimizer;
+	using batch::ConfigureApplicationFunction;
+	using dynamic::DynamicFunction;
+	using problem::ProblemFunctions;
+
+	// Uniform noise of relative size magnitude (at least magnitude in absolute terms), kept inside the bounds
+	numberVector perturbStartingPoint(const numberVector& x,
+										const numberVector& xLowerBounds,
+										const numberVector& xUpperBounds,
+										const double magnitude,
+										const unsigned seed);
+
+	// Straight line between two sets of kinematics, controls zero
+	numberVector interpolateStartingPoint(const numberVector& startKinematics,
+											const numberVector& goalKinematics,
+											const unsigned numberOfPoints,
+											const unsigned pointDimension);
+
+	// Applies the controls of every point to the dynamics from the start kinematics, with the same
+	// explicit update as dynamic::stepForward. controls holds controlDimension values per point.
+	numberVector rollOutStartingPoint(const numberVector& startKinematics,
+										const numberVector& controls,
+										const DynamicFunction& dynamics,
+										const unsigned positionDimension,
+										const unsigned controlDimension,
+										const double dt);
+
+	struct MultiStartOptions {
+		unsigned numberOfWorkers = 1;
+		// Iterates count as feasible below this primal infeasibility
+		double feasibilityTolerance = 1e-6;
+		// A feasible iterate worse than the incumbent by more than pruneMargin * max(1, |incumbent|)
+		// is pruned once its run has done pruneAfterIterations iterations. With 0, iterate 0, the
+		// starting point, is already checked before the start is handed to Ipopt.
+		double pruneMargin = 0.1;
+		int pruneAfterIterations = 10;
+		// Known lower bound on the objective, e.g. 0 for a sum of squares; a solution within
+		// optimalityGap of it cancels the remaining runs. The default never triggers.
+		double objectiveLowerBound = -std::numeric_limits<double>::infinity();
+		double optimalityGap = 1e-6;
+	};
+
+	enum RunOutcome {
+		NOT_STARTED,
+		COMPLETED,
+		PRUNED,
+		CANCELLED
+	};
+
+	struct StartStatistics {
+		RunOutcome outcome;
+		ApplicationReturnStatus status;
+		Number objectiveValue;
+		Index iterationCount;
+		double seconds;
+	};
+
+	struct MultiStartResult {
+		// Index of the best converged start, or -1 if none converged
+		int bestStart;
+		PrimalDualPoint solution;
+		Number objectiveValue;
+		std::vector<StartStatistics> starts;
+	};
+
+	// Solves one problem from several starting points on a fixed number of worker threads, every
+	// worker with its own IpoptApplication as in batch::SolveBatch. Runs watch the best converged
+	// objective so far: a run whose feasible iterates stay clearly above it is pruned, and a
+	// solution within the optimality gap of the lower bound cancels the others.
+	class SolveMultiStart {
+		const ConfigureApplicationFunction configureApplication;
+		const MultiStartOptions options;
+
+		struct SharedState {
+			std::mutex mutex;
+			std::atomic<bool> stop;
+			std::atomic<size_t> nextStart;
+			Number incumbentObjective;
+			MultiStartResult result;
+		};
+
+		bool isDominated(const Number objectiveValue, const Number incumbentObjective) const {
+			return objectiveValue > incumbentObjective + options.pruneMargin * std::max(1.0, std::abs(incumbentObjective));
+		}
+
+		bool isFeasible(const ProblemFunctions& functions, const numberVector& x) const {
+			for (unsigned index = 0; index < x.size(); index++) {
+				if (x[index] < functions.xLowerBounds[index] || x[index] > functions.xUpperBounds[index]) {
+					return false;
+				}
+			}
+			numberVector g(functions.gLowerBounds.size());
+			functions.constraintFunction(x.size(), x.data(), g.size(), g.data());
+			for (unsigned row = 0; row < g.size(); row++) {
+				if (g[row] < functions.gLowerBounds[row] - options.feasibilityTolerance ||
+						g[row] > functions.gUpperBounds[row] + options.feasibilityTolerance) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		void solveStart(const SmartPtr<IpoptApplication>& app,
+						const ProblemFunctions& functions,
+						const numberVector& startingPoint,
+						const size_t startIndex,
+						SharedState& state) const {
+			const auto start = std::chrono::steady_clock::now();
+			if (options.pruneAfterIterations <= 0 && isFeasible(functions, startingPoint)) {
+				const Number startingObjective = functions.objectiveFunction(startingPoint.size(), startingPoint.data());
+				std::lock_guard<std::mutex> lock(state.mutex);
+				if (isDominated(startingObjective, state.incumbentObjective)) {
+					const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+					state.result.starts[startIndex] = {PRUNED, User_Requested_Stop, startingObjective, 0, elapsed.count()};
+					return;
+				}
+			}
+			std::atomic<bool> pruned(false);
+
+			SmartPtr<TrajectoryOptimizer> trajectoryOptimizer =
+				new TrajectoryOptimizer(functions.xLowerBounds,
+										functions.xUpperBounds,
+										functions.gLowerBounds,
+										functions.gUpperBounds,
+										startingPoint,
+										functions.objectiveFunction,
+										functions.gradientFunction,
+										functions.constraintFunction,
+										functions.jacobianValueFunction,
+										functions.hessianValueFunction,
+										[](SolverReturn status, Index n, const Number* x, const Number* zLower,
+											const Number* zUpper, Index m, const Number* g, const Number* lambda,
+											Number objValue, const IpoptData* ipData,
+											IpoptCalculatedQuantities* ipCalculatedQuantities) {},
+										functions.structure->sparsityStructure);
+			trajectoryOptimizer->setIntermediateFunction([this, &state, &pruned](AlgorithmMode mode, Index iteration,
+																				Number objValue, Number primalInfeasibility,
+																				Number dualInfeasibility, Number mu,
+																				Number stepNorm, Number regularizationSize,
+																				Number dualStepSize, Number primalStepSize,
+																				Index lineSearchTrials, const IpoptData* ipData,
+																				IpoptCalculatedQuantities* ipCalculatedQuantities) {
+				if (state.stop) {
+					return false;
+				}
+				if (mode == RegularMode && iteration >= options.pruneAfterIterations &&
+						primalInfeasibility <= options.feasibilityTolerance) {
+					std::lock_guard<std::mutex> lock(state.mutex);
+					if (isDominated(objValue, state.incumbentObjective)) {
+						pruned = true;
+						return false;
+					}
+				}
+				return true;
+			});
+
+			setHessianApproximation(app, *functions.structure->sparsityStructure);
+			const ApplicationReturnStatus status = app->OptimizeTNLP(trajectoryOptimizer);
+			const Index iterationCount = IsValid(app->Statistics()) ? app->Statistics()->IterationCount() : 0;
+			const PrimalDualPoint& solution = trajectoryOptimizer->getSolution();
+			const Number objectiveValue = solution.x.empty() ? std::numeric_limits<double>::infinity() :
+											functions.objectiveFunction(solution.x.size(), solution.x.data());
+			const bool converged = status == Solve_Succeeded || status == Solved_To_Acceptable_Level;
+			const RunOutcome outcome = pruned ? PRUNED :
+										status == User_Requested_Stop ? CANCELLED : COMPLETED;
+			const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+			std::lock_guard<std::mutex> lock(state.mutex);
+			state.result.starts[startIndex] = {outcome, status, objectiveValue, iterationCount, elapsed.count()};
+			if (converged && objectiveValue < state.incumbentObjective) {
+				state.incumbentObjective = objectiveValue;
+				state.result.bestStart = startIndex;
+				state.result.solution = solution;
+				state.result.objectiveValue = objectiveValue;
+				if (objectiveValue <= options.objectiveLowerBound + options.optimalityGap) {
+					state.stop = true;
+				}
+			}
+		}
+
+		public:
+			SolveMultiStart(const ConfigureApplicationFunction configureApplication,
+							const MultiStartOptions options = MultiStartOptions()):
+								configureApplication(configureApplication),
+								options(options) {}
+
+			// Starts are taken in order, so put the most promising ones first
+			MultiStartResult operator()(const ProblemFunctions& functions, const std::vector<numberVector>& startingPoints) const {
+				SharedState state;
+				state.stop = false;
+				state.nextStart = 0;
+				state.incumbentObjective = std::numeric_limits<double>::infinity();
+				state.result = {-1, {}, std::numeric_limits<double>::infinity(),
+								std::vector<StartStatistics>(startingPoints.size(),
+																{NOT_STARTED, Internal_Error, std::numeric_limits<double>::infinity(), 0, 0})};
+
+				const auto work = [&]() {
+					SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
+					configureApplication(app);
+					if (app->Initialize() != Solve_Succeeded) {
+						return;
+					}
+					for (size_t startIndex = state.nextStart++; startIndex < startingPoints.size() && !state.stop;
+							startIndex = state.nextStart++) {
+						solveStart(app, functions, startingPoints[startIndex], startIndex, state);
+					}
+				};
+
+				std::vector<std::thread> workers;
+				const size_t numberOfThreads = std::min<size_t>(std::max(1u, options.numberOfWorkers), startingPoints.size());
+				for (size_t workerIndex = 0; workerIndex < numberOfThreads; workerIndex++) {
+					workers.emplace_back(work);
+				}
+				for (auto& worker: workers) {
+					worker.join();
+				}
+
+				return state.result;
+			}
+	};
+}
@@ -1,10 +1,17 @@
 #pragma once
 #include "coin/IpTNLP.hpp"
+#include "coin/IpIpoptApplication.hpp"
+#include "arena.hpp"
+#include "instrumentation.hpp"
 #include <cassert>
+#include <memory>
 
 namespace trajectoryOptimization::optimizer {
 
 	using namespace Ipopt;
+	using instrumentation::CallStatistics;
+	using instrumentation::Instrumentation;
+	using instrumentation::ScopedTimer;
 
 	using numberVector = std::vector<Number>;
 	using indexVector = std::vector<Index>;
@@ -15,9 +22,66 @@ namespace trajectoryOptimization::optimizer {
 	using GetJacobianValueFunction = std::function<const numberVector(Index n, const Number* x, Index m, Index numberElementsJacobians)>;
 	using GetHessianValueFunction = std::function<const numberVector(Index n, const Number* x, const Number objFactor, Index m, const Number* lambda,
 										Index numberElementsHessian)>;
+	// Write straight into the arrays Ipopt hands to the callbacks instead of returning a vector
+	using EvaluateGradientInPlaceFunction = std::function<void(Index n, const Number* x, Number* gradient)>;
+	using EvaluateConstraintInPlaceFunction = std::function<void(Index n, const Number* x, Index m, Number* g)>;
+	using GetJacobianValueInPlaceFunction = std::function<void(Index n, const Number* x, Index m, Index numberElementsJacobians,
+										Number* values)>;
+	using GetHessianValueInPlaceFunction = std::function<void(Index n, const Number* x, const Number objFactor, Index m, const Number* lambda,
+										Index numberElementsHessian, Number* values)>;
 	using FinalizerFunction = std::function<void(SolverReturn status, Index n, const Number* x, const Number* zLower, const Number* zUpper,
 										Index m, const Number* g, const Number* lambda,Number objValue,
 										const IpoptData* ipData, IpoptCalculatedQuantities* ipCalulatedQuantities)>;
+	// Returning false asks Ipopt to stop after the current iteration.
+	using IntermediateFunction = std::function<bool(AlgorithmMode mode, Index iteration, Number objValue, Number primalInfeasibility,
+										Number dualInfeasibility, Number mu, Number stepNorm, Number regularizationSize,
+										Number dualStepSize, Number primalStepSize, Index lineSearchTrials,
+										const IpoptData* ipData, IpoptCalculatedQuantities* ipCalulatedQuantities)>;
+
+	// Bound multipliers and constraint multipliers may be left empty when only x is known.
+	struct PrimalDualPoint {
+		numberVector x;
+		numberVector zLower;
+		numberVector zUpper;
+		numberVector lambda;
+	};
+
+	// Ipopt solves for scaling * x, scaling * g and objectiveScaling * f; empty vectors leave x or g unscaled.
+	// Only used with the option nlp_scaling_method set to user-scaling.
+	struct ScalingParameters {
+		Number objectiveScaling;
+		numberVector xScaling;
+		numberVector gScaling;
+	};
+
+	EvaluateGradientInPlaceFunction adaptGradientFunction(const EvaluateGradientFunction gradientFunction);
+
+	EvaluateConstraintInPlaceFunction adaptConstraintFunction(const EvaluateConstraintFunction constraintFunction);
+
+	GetJacobianValueInPlaceFunction adaptJacobianValueFunction(const GetJacobianValueFunction jacobianValueFunction);
+
+	GetHessianValueInPlaceFunction adaptHessianValueFunction(const GetHessianValueFunction hessianValueFunction);
+
+	// Read only once built, so structurally identical problems can share one instance across threads.
+	struct SparsityStructure {
+		const indexVector jacobianRows;
+		const indexVector jacobianCols;
+		const indexVector hessianRows;
+		const indexVector hessianCols;
+	};
+
+	std::shared_ptr<const SparsityStructure> makeSparsityStructure(const indexVector& jacobianRows,
+																	const indexVector& jacobianCols,
+																	const indexVector& hessianRows,
+																	const indexVector& hessianCols);
+
+	// Makes Ipopt start from the primal and dual point handed to get_starting_point instead of pushing
+	// it back into the interior, so re-solves of nearby problems only need a few iterations.
+	void enableWarmStart(const SmartPtr<IpoptApplication>& app, const Number boundPush = 1e-9, const Number muInit = 1e-6);
+
+	// Ipopt asks for the exact Hessian by default, which eval_h cannot give without a Hessian structure
+	// (e.g. a TrajectoryProblem without exactHessian). Such problems need the limited-memory approximation.
+	void setHessianApproximation(const SmartPtr<IpoptApplication>& app, const SparsityStructure& sparsityStructure);
 
 	class TrajectoryOptimizer : public TNLP
 	{
@@ -31,7 +95,6 @@ namespace trajectoryOptimization::optimizer {
 							const numberVector& gLowerBounds,
 							const numberVector& gUpperBounds,
 							const numberVector& xStartingPoint,
-							// z and lambda starting point not implemented
 							const EvaluateObjectiveFunction objectiveFunction,
 							const EvaluateGradientFunction gradientFunction,
 							const EvaluateConstraintFunction constraintFunction,
@@ -42,43 +105,101 @@ namespace trajectoryOptimization::optimizer {
 							const indexVector& hessianStructureCols,
 							const GetHessianValueFunction hessianValueFunction,
 							const FinalizerFunction finalizerFunction) :
-			numberVariablesX(numberVariablesX),
-			numberConstraintsG(numberConstraintsG),
-			numberNonzeroJacobian(numberNonzeroJacobian),
-			numberNonzeroHessian(numberNonzeroHessian),
+			TrajectoryOptimizer(xLowerBounds,
+								xUpperBounds,
+								gLowerBounds,
+								gUpperBounds,
+								xStartingPoint,
+								objectiveFunction,
+								gradientFunction,
+								constraintFunction,
+								jacobianValueFunction,
+								hessianValueFunction,
+								finalizerFunction,
+								makeSparsityStructure(jacobianStructureRows,
+														jacobianStructureCols,
+														hessianStructureRows,
+														hessianStructureCols)) {
+
+				assert(numberVariablesX == this->numberVariablesX);
+				assert(numberConstraintsG == this->numberConstraintsG);
+				assert(numberNonzeroJacobian == this->numberNonzeroJacobian);
+				assert(numberNonzeroHessian == this->numberNonzeroHessian);
+			}
+
+		TrajectoryOptimizer(const numberVector& xLowerBounds,
+							const numberVector& xUpperBounds,
+							const numberVector& gLowerBounds,
+							const numberVector& gUpperBounds,
+							const numberVector& xStartingPoint,
+							const EvaluateObjectiveFunction objectiveFunction,
+							const EvaluateGradientFunction gradientFunction,
+							const EvaluateConstraintFunction constraintFunction,
+							const GetJacobianValueFunction jacobianValueFunction,
+							const GetHessianValueFunction hessianValueFunction,
+							const FinalizerFunction finalizerFunction,
+							const std::shared_ptr<const SparsityStructure> sparsityStructure) :
+			TrajectoryOptimizer(xLowerBounds,
+								xUpperBounds,
+								gLowerBounds,
+								gUpperBounds,
+								xStartingPoint,
+								objectiveFunction,
+								adaptGradientFunction(gradientFunction),
+								adaptConstraintFunction(constraintFunction),
+								adaptJacobianValueFunction(jacobianValueFunction),
+								adaptHessianValueFunction(hessianValueFunction),
+								finalizerFunction,
+								sparsityStructure) {}
+
+		TrajectoryOptimizer(const numberVector& xLowerBounds,
+							const numberVector& xUpperBounds,
+							const numberVector& gLowerBounds,
+							const numberVector& gUpperBounds,
+							const numberVector& xStartingPoint,
+							const EvaluateObjectiveFunction objectiveFunction,
+							const EvaluateGradientInPlaceFunction gradientFunction,
+							const EvaluateConstraintInPlaceFunction constraintFunction,
+							const GetJacobianValueInPlaceFunction jacobianValueFunction,
+							const GetHessianValueInPlaceFunction hessianValueFunction,
+							const FinalizerFunction finalizerFunction,
+							const std::shared_ptr<const SparsityStructure> sparsityStructure) :
+			numberVariablesX(xLowerBounds.size()),
+			numberConstraintsG(gLowerBounds.size()),
+			numberNonzeroJacobian(sparsityStructure->jacobianRows.size()),
+			numberNonzeroHessian(sparsityStructure->hessianRows.size()),
 			xLowerBounds(xLowerBounds),
 			xUpperBounds(xUpperBounds),
 			gLowerBounds(gLowerBounds),
 			gUpperBounds(gUpperBounds),
-			xStartingPoint(xStartingPoint),
+			startingPoint({xStartingPoint, {}, {}, {}}),
 			objectiveFunction(objectiveFunction),
 			gradientFunction(gradientFunction),
 			constraintFunction(constraintFunction),
-			jacobianStructureRows(jacobianStructureRows),
-			jacobianStructureCols(jacobianStructureCols),
+			sparsityStructure(sparsityStructure),
 			jacobianValueFunction(jacobianValueFunction),
-			hessianStructureRows(hessianStructureRows),
-			hessianStructureCols(hessianStructureCols),
 			hessianValueFunction(hessianValueFunction),
-			finalizerFunction(finalizerFunction) {
+			finalizerFunction(finalizerFunction),
+			scalingParameters({1, {}, {}}),
+			trackIterates(false) {
 
-				assert(numberVariablesX == xLowerBounds.size());
 				assert(numberVariablesX == xUpperBounds.size());
-				assert(numberConstraintsG == gLowerBounds.size());
 				assert(numberConstraintsG == gUpperBounds.size());
 
-				assert(numberVariablesX == xStartingPoint.size());
-
-				assert(numberNonzeroJacobian == jacobianStructureRows.size());
-				assert(numberNonzeroJacobian == jacobianStructureCols.size());
+				assert(numberVariablesX == startingPoint.x.size());
 
-				assert(numberNonzeroHessian == hessianStructureRows.size());
-				assert(numberNonzeroHessian == hessianStructureCols.size());
+				assert(numberNonzeroJacobian == sparsityStructure->jacobianCols.size());
+				assert(numberNonzeroHessian == sparsityStructure->hessianCols.size());
 			}
 		virtual ~TrajectoryOptimizer() {}
 
 		virtual bool get_nlp_info(Index& n, Index& m, Index& nnz_jac_g,
 								  Index& nnz_h_lag, IndexStyleEnum& index_style) {
+			if (solveInstrumentation) {
+				solveInstrumentation->beginSolve();
+			}
+			lastGradientPoint.clear();
+			ScopedTimer timer(timerFor(instrumentation::GET_NLP_INFO));
 			n = numberVariablesX;
 			m = numberConstraintsG;
 			nnz_jac_g = numberNonzeroJacobian;
@@ -91,6 +212,7 @@ namespace trajectoryOptimization::optimizer {
 									 Index m, Number* g_l, Number* g_u) {
 			assert(n == numberVariablesX);
 			assert(m == numberConstraintsG);
+			ScopedTimer timer(timerFor(instrumentation::GET_BOUNDS_INFO));
 
 			std::copy(xLowerBounds.begin(), xLowerBounds.end(), x_l);
 			std::copy(xUpperBounds.begin(), xUpperBounds.end(), x_u);
@@ -100,23 +222,56 @@ namespace trajectoryOptimization::optimizer {
 			return true;
 		}
 
+		virtual bool get_scaling_parameters(Number& obj_scaling,
+											bool& use_x_scaling, Index n, Number* x_scaling,
+											bool& use_g_scaling, Index m, Number* g_scaling) {
+			assert(n == numberVariablesX);
+			assert(m == numberConstraintsG);
+
+			obj_scaling = scalingParameters.objectiveScaling;
+			use_x_scaling = !scalingParameters.xScaling.empty();
+			if (use_x_scaling) {
+				std::copy(scalingParameters.xScaling.begin(), scalingParameters.xScaling.end(), x_scaling);
+			}
+			use_g_scaling = !scalingParameters.gScaling.empty();
+			if (use_g_scaling) {
+				std::copy(scalingParameters.gScaling.begin(), scalingParameters.gScaling.end(), g_scaling);
+			}
+			return true;
+		}
+
 		virtual bool get_starting_point(Index n, bool init_x, Number* x,
 										bool init_z, Number* z_L, Number* z_U,
 										Index m, bool init_lambda,
 										Number* lambda) {
 			assert(n == numberVariablesX);
 			assert(m == numberConstraintsG);
+			ScopedTimer timer(timerFor(instrumentation::GET_STARTING_POINT));
 
 			if (init_x) {
-				std::copy(xStartingPoint.begin(), xStartingPoint.end(), x);
+				std::copy(startingPoint.x.begin(), startingPoint.x.end(), x);
 			}
 
 			if (init_z) {
-				printf("WARNING: Ipopt wants z starting point, not implemented");
+				if (startingPoint.zLower.empty() || startingPoint.zUpper.empty()) {
+					printf("WARNING: Ipopt wants z starting point, none set, starting from zero\n");
+					std::fill(z_L, z_L + n, 0);
+					std::fill(z_U, z_U + n, 0);
+				}
+				else {
+					std::copy(startingPoint.zLower.begin(), startingPoint.zLower.end(), z_L);
+					std::copy(startingPoint.zUpper.begin(), startingPoint.zUpper.end(), z_U);
+				}
 			}
 
 			if (init_lambda) {
-				printf("WARNING: Ipopt wants lambda starting point, not implemented");
+				if (startingPoint.lambda.empty()) {
+					printf("WARNING: Ipopt wants lambda starting point, none set, starting from zero\n");
+					std::fill(lambda, lambda + m, 0);
+				}
+				else {
+					std::copy(startingPoint.lambda.begin(), startingPoint.lambda.end(), lambda);
+				}
 			}
 
 			return true;
@@ -124,28 +279,30 @@ namespace trajectoryOptimization::optimizer {
 
 		virtual bool eval_f(Index n, const Number* x, bool new_x, Number& obj_value) {
 			assert(n == numberVariablesX);
+			ScopedTimer timer(timerFor(instrumentation::EVAL_F));
 			obj_value = objectiveFunction(n, x);
 			return true;
 		}
 
+		// Finite-difference derivatives take their temporaries from the thread's arena, all released when the callback returns
 		virtual bool eval_grad_f(Index n, const Number* x, bool new_x, Number* grad_f) {
 			assert(n == numberVariablesX);
+			ScopedTimer timer(timerFor(instrumentation::EVAL_GRAD_F));
+			arena::ArenaScope temporaries;
 
-			numberVector grad_output = gradientFunction(n, x);
-			assert(n == grad_output.size());
-
-			std::copy(grad_output.begin(), grad_output.end(), grad_f);
+			gradientFunction(n, x, grad_f);
+			if (trackIterates) {
+				lastGradientPoint.assign(x, x + n);
+			}
 			return true;
 		}
 
 		virtual bool eval_g(Index n, const Number* x, bool new_x, Index m, Number* g) {
 			assert(n == numberVariablesX);
 			assert(m == numberConstraintsG);
+			ScopedTimer timer(timerFor(instrumentation::EVAL_G));
 
-			numberVector constraint_output = constraintFunction(n, x, m);
-			assert(m == constraint_output.size());
-
-			std::copy(constraint_output.begin(), constraint_output.end(), g);
+			constraintFunction(n, x, m, g);
 			return true;
 		}
 
@@ -155,16 +312,16 @@ namespace trajectoryOptimization::optimizer {
 			assert(n == numberVariablesX);
 			assert(m == numberConstraintsG);
 			assert(nele_jac == numberNonzeroJacobian);
+			ScopedTimer timer(timerFor(instrumentation::EVAL_JAC_G));
+			arena::ArenaScope temporaries;
 
 			if (values == NULL) {
-				std::copy(jacobianStructureRows.begin(), jacobianStructureRows.end(), iRow);
-				std::copy(jacobianStructureCols.begin(), jacobianStructureCols.end(), jCol);
+				std::copy(sparsityStructure->jacobianRows.begin(), sparsityStructure->jacobianRows.end(), iRow);
+				std::copy(sparsityStructure->jacobianCols.begin(), sparsityStructure->jacobianCols.end(), jCol);
 				return true;
 			}
 			else {
-				numberVector vals = jacobianValueFunction(n, x, m, nele_jac);
-				assert(nele_jac == vals.size());
-				std::copy(vals.begin(), vals.end(), values);
+				jacobianValueFunction(n, x, m, nele_jac, values);
 				return true;
 			}
 		}
@@ -176,20 +333,19 @@ namespace trajectoryOptimization::optimizer {
 			assert(n == numberVariablesX);
 			assert(m == numberConstraintsG);
 			assert(nele_hess == numberNonzeroHessian);
+			ScopedTimer timer(timerFor(instrumentation::EVAL_H));
 
 			if (numberNonzeroHessian == 0) {
 				return false;
 			}
 
 			if (values == NULL) {
-				std::copy(hessianStructureRows.begin(), hessianStructureRows.end(), iRow);
-				std::copy(hessianStructureCols.begin(), hessianStructureCols.end(), jCol);
+				std::copy(sparsityStructure->hessianRows.begin(), sparsityStructure->hessianRows.end(), iRow);
+				std::copy(sparsityStructure->hessianCols.begin(), sparsityStructure->hessianCols.end(), jCol);
 				return true;
 			}
 			else {
-				numberVector vals = hessianValueFunction(n, x, obj_factor, m, lambda, nele_hess);
-				assert(nele_hess == vals.size());
-				std::copy(vals.begin(), vals.end(), values);
+				hessianValueFunction(n, x, obj_factor, m, lambda, nele_hess, values);
 				return true;
 			}
 		}
@@ -202,10 +358,135 @@ namespace trajectoryOptimization::optimizer {
 									   IpoptCalculatedQuantities* ip_cq) {
 			assert(n == numberVariablesX);
 			assert(m == numberConstraintsG);
+			ScopedTimer timer(timerFor(instrumentation::FINALIZE_SOLUTION));
+
+			solution = {numberVector(x, x + n),
+						numberVector(z_L, z_L + n),
+						numberVector(z_U, z_U + n),
+						numberVector(lambda, lambda + m)};
+			// A failed solve keeps the last starting point, its iterate would be a poor one to warm start from
+			if (status == SUCCESS || status == STOP_AT_ACCEPTABLE_POINT) {
+				startingPoint = solution;
+			}
 
+			if (solveInstrumentation) {
+				solveInstrumentation->endSolve();
+			}
 			finalizerFunction(status, n, x, z_L, z_U, m, g, lambda, obj_value, ip_data, ip_cq);
 		}
 
+		virtual bool intermediate_callback(AlgorithmMode mode,
+											Index iter, Number obj_value,
+											Number inf_pr, Number inf_du,
+											Number mu, Number d_norm,
+											Number regularization_size,
+											Number alpha_du, Number alpha_pr,
+											Index ls_trials,
+											const IpoptData* ip_data,
+											IpoptCalculatedQuantities* ip_cq) {
+			ScopedTimer timer(timerFor(instrumentation::INTERMEDIATE_CALLBACK));
+			if (solveInstrumentation) {
+				solveInstrumentation->recordIteration({iter, obj_value, inf_pr, inf_du, mu, d_norm,
+														alpha_pr, alpha_du, ls_trials, 0});
+			}
+			if (!intermediateFunction) {
+				return true;
+			}
+			return intermediateFunction(mode, iter, obj_value, inf_pr, inf_du, mu, d_norm, regularization_size,
+										alpha_du, alpha_pr, ls_trials, ip_data, ip_cq);
+		}
+
+		void setIntermediateFunction(const IntermediateFunction function) {
+			intermediateFunction = function;
+		}
+
+		const IntermediateFunction& getIntermediateFunction() const {
+			return intermediateFunction;
+		}
+
+		// Remembers where the objective gradient was last evaluated. Ipopt evaluates it at every
+		// accepted iterate before calling intermediate_callback, so getCurrentIterate called from an
+		// intermediate function returns the iterate being reported (outside the restoration phase).
+		void setIterateTracking(const bool enabled) {
+			trackIterates = enabled;
+			lastGradientPoint.clear();
+		}
+
+		bool getCurrentIterate(numberVector& x) const {
+			if (lastGradientPoint.empty()) {
+				return false;
+			}
+			x = lastGradientPoint;
+			return true;
+		}
+
+		void setScaling(const ScalingParameters& scaling) {
+			assert(scaling.xScaling.empty() || numberVariablesX == scaling.xScaling.size());
+			assert(scaling.gScaling.empty() || numberConstraintsG == scaling.gScaling.size());
+
+			scalingParameters = scaling;
+		}
+
+		const ScalingParameters& getScaling() const {
+			return scalingParameters;
+		}
+
+		// Every solve starts a fresh record in it; a null pointer disables the timers.
+		void setInstrumentation(const std::shared_ptr<Instrumentation> instrumentation) {
+			solveInstrumentation = instrumentation;
+		}
+
+		const std::shared_ptr<Instrumentation>& getInstrumentation() const {
+			return solveInstrumentation;
+		}
+
+		// The structure of the problem stays the same, e.g. fixing the first point to a measured state.
+		void setVariableBounds(const numberVector& lowerBounds, const numberVector& upperBounds) {
+			assert(numberVariablesX == lowerBounds.size());
+			assert(numberVariablesX == upperBounds.size());
+
+			xLowerBounds = lowerBounds;
+			xUpperBounds = upperBounds;
+		}
+
+		const numberVector& getVariableLowerBounds() const {
+			return xLowerBounds;
+		}
+
+		const numberVector& getVariableUpperBounds() const {
+			return xUpperBounds;
+		}
+
+		Index getNumberConstraints() const {
+			return numberConstraintsG;
+		}
+
+		const SparsityStructure& getSparsityStructure() const {
+			return *sparsityStructure;
+		}
+
+		// Used by the next solve; finalize_solution replaces it with the solution of a successful solve.
+		void setStartingPoint(const PrimalDualPoint& primalDualPoint) {
+			assert(numberVariablesX == primalDualPoint.x.size());
+			assert(primalDualPoint.zLower.empty() || numberVariablesX == primalDualPoint.zLower.size());
+			assert(primalDualPoint.zUpper.empty() || numberVariablesX == primalDualPoint.zUpper.size());
+			assert(primalDualPoint.lambda.empty() || numberConstraintsG == primalDualPoint.lambda.size());
+
+			startingPoint = primalDualPoint;
+		}
+
+		const PrimalDualPoint& getStartingPoint() const {
+			return startingPoint;
+		}
+
+		bool hasSolution() const {
+			return !solution.x.empty();
+		}
+
+		const PrimalDualPoint& getSolution() const {
+			return solution;
+		}
+
 	private:
 		/**@name Methods to block default compiler methods.
 		 * The compiler automatically generates the following three methods.
@@ -228,25 +509,31 @@ namespace trajectoryOptimization::optimizer {
 		const int numberNonzeroJacobian;
 		const int numberNonzeroHessian;
 
-		const numberVector xLowerBounds;
-		const numberVector xUpperBounds;
+		numberVector xLowerBounds;
+		numberVector xUpperBounds;
 		const numberVector gLowerBounds;
 		const numberVector gUpperBounds;
 
-		const numberVector xStartingPoint;
+		PrimalDualPoint startingPoint;
+		PrimalDualPoint solution;
 
 		const EvaluateObjectiveFunction objectiveFunction;
-		const EvaluateGradientFunction gradientFunction;
-		const EvaluateConstraintFunction constraintFunction;
+		const EvaluateGradientInPlaceFunction gradientFunction;
+		const EvaluateConstraintInPlaceFunction constraintFunction;
 
-		const indexVector jacobianStructureRows;
-		const indexVector jacobianStructureCols;
-		const GetJacobianValueFunction jacobianValueFunction;
-		
-		const indexVector hessianStructureRows;
-		const indexVector hessianStructureCols;
-		const GetHessianValueFunction hessianValueFunction;
+		const std::shared_ptr<const SparsityStructure> sparsityStructure;
+		const GetJacobianValueInPlaceFunction jacobianValueFunction;
+		const GetHessianValueInPlaceFunction hessianValueFunction;
 
 		const FinalizerFunction finalizerFunction;
+		IntermediateFunction intermediateFunction;
+		std::shared_ptr<Instrumentation> solveInstrumentation;
+		ScalingParameters scalingParameters;
+		bool trackIterates;
+		numberVector lastGradientPoint;
+
+		CallStatistics* timerFor(const instrumentation::Callback callback) {
+			return solveInstrumentation ? &solveInstrumentation->getCallback(callback) : nullptr;
+		}
   };
 }
\ No newline at end of file
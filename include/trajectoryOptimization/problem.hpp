@@ -0,0 +1,371 @@
+#pragma once
+#include <cassert>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "arena.hpp"
+#include "constraint.hpp"
+#include "cost.hpp"
+#include "derivative.hpp"
+#include "dynamic.hpp"
+#include "optimizer.hpp"
+#include "sparsity.hpp"
+#include "utilities.hpp"
+
+namespace trajectoryOptimization::problem {
+	using namespace trajectoryOptimization::optimizer;
+	using constraint::ConstraintFunction;
+	using dynamic::DynamicFunction;
+
+	// Everything about a problem that does not change with its numbers. Constraint blocks are stacked
+	// in the order dynamics (one block per interval), then goals and added constraints. Block
+	// Jacobians are differentiated on their own pattern and added to the stacked Jacobian through their index map.
+	struct ProblemStructure {
+		const unsigned numberConstraints;
+		const std::vector<unsigned> blockRowOffsets;
+		const std::shared_ptr<const SparsityStructure> sparsityStructure;
+		const std::vector<sparsity::IndexMap> blockJacobianIndexMaps;
+	};
+
+	// Structures by signature; shared by every problem built with it, including from several threads.
+	class StructureCache {
+		std::map<std::string, std::shared_ptr<const ProblemStructure>> structures;
+		mutable std::mutex mutex;
+		unsigned hits;
+		unsigned misses;
+
+		public:
+			StructureCache(): hits(0), misses(0) {}
+
+			std::shared_ptr<const ProblemStructure> get(const std::string& signature,
+														const std::function<ProblemStructure()>& createStructure) {
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					const auto found = structures.find(signature);
+					if (found != structures.end()) {
+						hits++;
+						return found->second;
+					}
+					misses++;
+				}
+				// Created unlocked, a concurrent miss on the same signature only wastes work
+				const auto structure = std::make_shared<const ProblemStructure>(createStructure());
+				std::lock_guard<std::mutex> lock(mutex);
+				return structures.insert({signature, structure}).first->second;
+			}
+
+			unsigned getHits() const {
+				std::lock_guard<std::mutex> lock(mutex);
+				return hits;
+			}
+
+			unsigned getMisses() const {
+				std::lock_guard<std::mutex> lock(mutex);
+				return misses;
+			}
+	};
+
+	struct Objective {
+		EvaluateObjectiveFunction objectiveFunction;
+		EvaluateGradientInPlaceFunction gradientFunction;
+		indexVector hessianRows;
+		indexVector hessianCols;
+		std::function<void(const Number objFactor, Number* values)> hessianValueFunction;
+	};
+
+	// Any cost with the interface of cost::WeightedCostSum
+	template <typename CostSum>
+	Objective makeObjective(const CostSum costSum) {
+		return {[costSum](Index n, const Number* x) { return costSum(x); },
+				[costSum](Index n, const Number* x, Number* gradient) { costSum.gradient(x, n, gradient); },
+				costSum.getHessianRows(),
+				costSum.getHessianCols(),
+				[costSum](const Number objFactor, Number* values) { costSum.hessian(objFactor, values); }};
+	}
+
+	extern template Objective makeObjective(const cost::WeightedCostSum<cost::GetControlSquareSum>);
+	extern template Objective makeObjective(const cost::WeightedCostSum<cost::GetControlSquareSum,
+																		cost::GetControlRateSquareSum>);
+	extern template Objective makeObjective(const cost::WeightedCostSum<cost::GetControlSquareSum,
+																		cost::GetKinematicTrackingSquareSum>);
+	extern template Objective makeObjective(const cost::WeightedCostSum<cost::GetControlSquareSum,
+																		cost::GetControlRateSquareSum,
+																		cost::GetKinematicTrackingSquareSum>);
+
+	// What TrajectoryOptimizer, the batch solver or the linear-quadratic detection need
+	struct ProblemFunctions {
+		numberVector xLowerBounds;
+		numberVector xUpperBounds;
+		numberVector gLowerBounds;
+		numberVector gUpperBounds;
+		numberVector xStartingPoint;
+		EvaluateObjectiveFunction objectiveFunction;
+		EvaluateGradientInPlaceFunction gradientFunction;
+		EvaluateConstraintInPlaceFunction constraintFunction;
+		GetJacobianValueInPlaceFunction jacobianValueFunction;
+		GetHessianValueInPlaceFunction hessianValueFunction;
+		std::shared_ptr<const ProblemStructure> structure;
+	};
+
+	// A constraint block only sees the variables from columnOffset on, as many as its pattern has
+	// columns: an interval's dynamics its two points, a goal its point. The functor differentiates it
+	// on that pattern; blocks of the same shape share the pattern and its compressed columns.
+	struct ConstraintBlock {
+		ConstraintFunction constraintFunction;
+		unsigned columnOffset;
+		std::shared_ptr<const sparsity::SparsityPattern> jacobianPattern;
+		derivative::GetJacobianOfVectorToVectorFunctionUsingSparsityPattern jacobian;
+	};
+
+	// Declares a trajectory problem point by point. Each block's sparsity is found when the block is
+	// added, the dynamics once on a single interval, and hashed with its offset into the structural
+	// signature, which is made of the dimensions and these hashes. Stacking them is done once per signature and
+	// then taken from the cache, so problems that only differ in goal values, bounds or starting point share it.
+	class TrajectoryProblem {
+		const unsigned numberOfPoints;
+		const unsigned positionDimension;
+		const unsigned controlDimension;
+		const unsigned pointDimension;
+		const unsigned numberVariables;
+		// Shared by all functions taken from the problem
+		std::shared_ptr<std::vector<ConstraintBlock>> blocks;
+		// Of the blocks' patterns and offsets in order, kept up to date by addBlock
+		std::size_t blocksHash;
+		Objective objective;
+		bool exactHessian;
+		std::size_t hessianHash;
+		numberVector xLowerBounds;
+		numberVector xUpperBounds;
+		numberVector xStartingPoint;
+
+		void addBlock(const ConstraintFunction constraintFunction,
+						const unsigned columnOffset,
+						const std::shared_ptr<const sparsity::SparsityPattern>& jacobianPattern,
+						const std::shared_ptr<const sparsity::CompressedView>& jacobianColumns) {
+			assert(columnOffset + jacobianPattern->getNumberCols() <= numberVariables);
+			// Functions taken from this problem, or a copy of it, keep the blocks they were made with
+			if (blocks.use_count() > 1) {
+				blocks = std::make_shared<std::vector<ConstraintBlock>>(*blocks);
+			}
+			blocks->push_back({constraintFunction,
+								columnOffset,
+								jacobianPattern,
+								derivative::GetJacobianOfVectorToVectorFunctionUsingSparsityPattern(constraintFunction,
+																									jacobianPattern->getNumberCols(),
+																									jacobianColumns)});
+			blocksHash = sparsity::combineHash(sparsity::combineHash(blocksHash, columnOffset),
+												sparsity::hashPattern(*jacobianPattern));
+		}
+
+		void addBlock(const ConstraintFunction constraintFunction,
+						const unsigned columnOffset,
+						const sparsity::SparsityPattern& jacobianPattern) {
+			addBlock(constraintFunction,
+						columnOffset,
+						std::make_shared<const sparsity::SparsityPattern>(jacobianPattern),
+						std::make_shared<const sparsity::CompressedView>(jacobianPattern.getCompressedCols()));
+		}
+
+		ProblemStructure createStructure() const {
+			std::vector<unsigned> blockRowOffsets;
+			unsigned numberConstraints = 0;
+			for (const auto& block: *blocks) {
+				blockRowOffsets.push_back(numberConstraints);
+				numberConstraints += block.jacobianPattern->getNumberRows();
+			}
+
+			std::vector<sparsity::SparsityPattern> placedPatterns;
+			placedPatterns.reserve(blocks->size());
+			for (unsigned block = 0; block < blocks->size(); block++) {
+				placedPatterns.push_back(sparsity::placeBlock(*(*blocks)[block].jacobianPattern, numberConstraints,
+																numberVariables, blockRowOffsets[block],
+																(*blocks)[block].columnOffset));
+			}
+			const auto jacobianPattern = sparsity::unite(placedPatterns);
+			std::vector<sparsity::IndexMap> blockJacobianIndexMaps;
+			for (unsigned block = 0; block < blocks->size(); block++) {
+				blockJacobianIndexMaps.push_back(sparsity::getIndexMap(*(*blocks)[block].jacobianPattern, jacobianPattern,
+																		blockRowOffsets[block], (*blocks)[block].columnOffset));
+			}
+
+			return {numberConstraints,
+					blockRowOffsets,
+					makeSparsityStructure(jacobianPattern.getRows(),
+											jacobianPattern.getCols(),
+											exactHessian ? objective.hessianRows : indexVector(),
+											exactHessian ? objective.hessianCols : indexVector()),
+					blockJacobianIndexMaps};
+		}
+
+		public:
+			TrajectoryProblem(const unsigned numberOfPoints,
+								const unsigned positionDimension,
+								const unsigned controlDimension,
+								const double timeStepSize,
+								const DynamicFunction dynamics):
+									TrajectoryProblem(positionDimension,
+														controlDimension,
+														std::vector<double>(numberOfPoints - 1, timeStepSize),
+														dynamics) {}
+
+			// One step size per interval, numberOfPoints - 1 of them. The step sizes are values, not
+			// structure, so meshes with the same number of points share a cache entry.
+			TrajectoryProblem(const unsigned positionDimension,
+								const unsigned controlDimension,
+								const std::vector<double>& timeStepSizes,
+								const DynamicFunction dynamics):
+									numberOfPoints(timeStepSizes.size() + 1),
+									positionDimension(positionDimension),
+									controlDimension(controlDimension),
+									pointDimension(2 * positionDimension + controlDimension),
+									numberVariables(numberOfPoints * (2 * positionDimension + controlDimension)),
+									blocks(std::make_shared<std::vector<ConstraintBlock>>()),
+									blocksHash(0),
+									exactHessian(false),
+									hessianHash(0),
+									xLowerBounds(numberVariables, -1e19),
+									xUpperBounds(numberVariables, 1e19),
+									xStartingPoint(numberVariables, 0) {
+										assert(numberOfPoints > 1);
+										// Every interval's violation is that of interval 0 of its own two points
+										const unsigned intervalVariables = 2 * pointDimension;
+										const auto getIntervalConstraint = [&](const unsigned interval) {
+											return ConstraintFunction(constraint::GetKinematicViolation(dynamics, pointDimension, positionDimension,
+																										0, timeStepSizes[interval]));
+										};
+										const auto firstInterval = getIntervalConstraint(0);
+										const std::vector<double> ones(intervalVariables, 1);
+										const auto [intervalRows, intervalCols] =
+											derivative::GetSparsityPatternOfVectorToVectorFunction(firstInterval, intervalVariables)();
+										const auto intervalPattern =
+											std::make_shared<const sparsity::SparsityPattern>(firstInterval(ones.data()).size(), intervalVariables,
+																								intervalRows, intervalCols);
+										const auto intervalColumns =
+											std::make_shared<const sparsity::CompressedView>(intervalPattern->getCompressedCols());
+
+										blocks->reserve(numberOfPoints - 1);
+										for (unsigned interval = 0; interval + 1 < numberOfPoints; interval++) {
+											addBlock(getIntervalConstraint(interval), interval * pointDimension, intervalPattern, intervalColumns);
+										}
+									}
+
+			TrajectoryProblem& addKinematicGoal(const unsigned timeIndex,
+												const unsigned kinematicDimension,
+												const std::vector<double>& kinematicGoal) {
+				assert(timeIndex < numberOfPoints);
+				// Row k pins value k of the point
+				const std::vector<int> goalEntries = utilities::indexRange(0, (int) kinematicDimension);
+				addBlock(constraint::GetToKinematicGoal(1, pointDimension, kinematicDimension, 0, kinematicGoal),
+							timeIndex * pointDimension,
+							sparsity::SparsityPattern(kinematicDimension, pointDimension, goalEntries, goalEntries));
+				return *this;
+			}
+
+			// All rows are equalities, g(x) = 0. Its sparsity is detected over all variables right away.
+			TrajectoryProblem& addConstraint(const ConstraintFunction constraintFunction) {
+				const std::vector<double> ones(numberVariables, 1);
+				const auto [rows, cols] = derivative::GetSparsityPatternOfVectorToVectorFunction(constraintFunction, numberVariables)();
+				addBlock(constraintFunction, 0,
+							sparsity::SparsityPattern(constraintFunction(ones.data()).size(), numberVariables, rows, cols));
+				return *this;
+			}
+
+			// The objective's Hessian is only the Hessian of the Lagrangian if all constraints are linear,
+			// otherwise leave exactHessian off; setHessianApproximation then has Ipopt use its limited-memory approximation.
+			template <typename CostSum>
+			TrajectoryProblem& setObjective(const CostSum& costSum, const bool exactHessian) {
+				objective = makeObjective(costSum);
+				this->exactHessian = exactHessian;
+				hessianHash = sparsity::hashEntries(objective.hessianRows, objective.hessianCols);
+				return *this;
+			}
+
+			TrajectoryProblem& setPointBounds(const numberVector& pointLowerBounds, const numberVector& pointUpperBounds) {
+				assert(pointLowerBounds.size() == pointDimension && pointUpperBounds.size() == pointDimension);
+				for (unsigned index = 0; index < numberVariables; index++) {
+					xLowerBounds[index] = pointLowerBounds[index % pointDimension];
+					xUpperBounds[index] = pointUpperBounds[index % pointDimension];
+				}
+				return *this;
+			}
+
+			TrajectoryProblem& setBounds(const numberVector& lowerBounds, const numberVector& upperBounds) {
+				assert(lowerBounds.size() == numberVariables && upperBounds.size() == numberVariables);
+				xLowerBounds = lowerBounds;
+				xUpperBounds = upperBounds;
+				return *this;
+			}
+
+			TrajectoryProblem& setStartingPoint(const numberVector& startingPoint) {
+				assert(startingPoint.size() == numberVariables);
+				xStartingPoint = startingPoint;
+				return *this;
+			}
+
+			std::string getStructureSignature() const {
+				std::ostringstream signature;
+				signature << numberOfPoints << ' ' << positionDimension << ' ' << controlDimension
+							<< " | " << blocks->size() << " blocks " << blocksHash << " | hessian";
+				if (exactHessian) {
+					signature << ' ' << hessianHash;
+				}
+				return signature.str();
+			}
+
+			ProblemFunctions getFunctions(StructureCache& cache) const {
+				assert(objective.objectiveFunction);
+				const auto structure = cache.get(getStructureSignature(), [this]() { return createStructure(); });
+				const std::shared_ptr<const std::vector<ConstraintBlock>> constraintBlocks = blocks;
+				const auto objectiveHessian = objective.hessianValueFunction;
+
+				return {xLowerBounds,
+						xUpperBounds,
+						numberVector(structure->numberConstraints, 0),
+						numberVector(structure->numberConstraints, 0),
+						xStartingPoint,
+						objective.objectiveFunction,
+						objective.gradientFunction,
+						[constraintBlocks](Index n, const Number* x, Index m, Number* g) {
+							for (const auto& block: *constraintBlocks) {
+								const auto values = block.constraintFunction(x + block.columnOffset);
+								g = std::copy(values.begin(), values.end(), g);
+							}
+						},
+						[constraintBlocks, structure](Index n, const Number* x, Index m, Index numberElementsJacobian, Number* values) {
+							std::fill(values, values + numberElementsJacobian, 0);
+							for (unsigned block = 0; block < constraintBlocks->size(); block++) {
+								const auto& constraintBlock = (*constraintBlocks)[block];
+								arena::ArenaScope scope;
+								double* blockValues = scope.allocate<double>(constraintBlock.jacobianPattern->size());
+								constraintBlock.jacobian(x + constraintBlock.columnOffset, blockValues);
+								sparsity::assemble(structure->blockJacobianIndexMaps[block], blockValues, values);
+							}
+						},
+						[objectiveHessian](Index n, const Number* x, const Number objFactor, Index m, const Number* lambda,
+											Index numberElementsHessian, Number* values) {
+							objectiveHessian(objFactor, values);
+						},
+						structure};
+			}
+
+			SmartPtr<TrajectoryOptimizer> build(const FinalizerFunction finalizerFunction, StructureCache& cache) const {
+				const auto functions = getFunctions(cache);
+				return new TrajectoryOptimizer(functions.xLowerBounds,
+												functions.xUpperBounds,
+												functions.gLowerBounds,
+												functions.gUpperBounds,
+												functions.xStartingPoint,
+												functions.objectiveFunction,
+												functions.gradientFunction,
+												functions.constraintFunction,
+												functions.jacobianValueFunction,
+												functions.hessianValueFunction,
+												finalizerFunction,
+												functions.structure->sparsityStructure);
+			}
+	};
+}
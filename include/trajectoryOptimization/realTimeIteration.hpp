@@ -0,0 +1,149 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "linearQuadratic.hpp"
+#include "modelPredictiveControl.hpp"
+#include "optimizer.hpp"
+
+namespace trajectoryOptimization::rti {
+	using namespace trajectoryOptimization::optimizer;
+	using namespace trajectoryOptimization::lq;
+	using mpc::Clock;
+	using mpc::Seconds;
+
+	struct FeedbackResult {
+		SolverReturn status;
+		double preparationSeconds;
+		double feedbackSeconds;
+	};
+
+	// Real-time iteration: one Gauss-Newton SQP step per tick. The QP in the step d,
+	//   minimize 0.5 d^T H d + gradient^T d  subject to  J d = gLowerBounds - g,
+	// uses the objective Hessian only (no constraint curvature) and is linearized at the previous
+	// solution shifted by one point. prepare() evaluates the derivatives and factorizes the KKT matrix
+	// before the measurement arrives; feedback() only fixes the first point's kinematics to the
+	// measurement and back substitutes. The Hessian pattern of sparsityStructure is the objective's.
+	// Constraints have to be equalities, variable bounds are reported through the status but not
+	// enforced. An empty constraintShiftMap re-linearizes at the solution, i.e. plain SQP iterations.
+	class RealTimeIteration {
+		const numberVector xLowerBounds;
+		const numberVector xUpperBounds;
+		const numberVector gTargets;
+		const EvaluateGradientInPlaceFunction gradientFunction;
+		const EvaluateConstraintInPlaceFunction constraintFunction;
+		const GetJacobianValueInPlaceFunction jacobianValueFunction;
+		const GetHessianValueInPlaceFunction objectiveHessianValueFunction;
+		const std::shared_ptr<const SparsityStructure> sparsityStructure;
+		const unsigned pointDimension;
+		const unsigned kinematicDimension;
+		const indexVector constraintShiftMap;
+		PrimalDualPoint linearizationPoint;
+		PrimalDualPoint solution;
+		std::unique_ptr<FactorizeLinearQuadratic> factorization;
+		double preparationSeconds;
+
+		public:
+			RealTimeIteration(const numberVector& xLowerBounds,
+								const numberVector& xUpperBounds,
+								const numberVector& gLowerBounds,
+								const numberVector& gUpperBounds,
+								const numberVector& xStartingPoint,
+								const EvaluateGradientInPlaceFunction& gradientFunction,
+								const EvaluateConstraintInPlaceFunction& constraintFunction,
+								const GetJacobianValueInPlaceFunction& jacobianValueFunction,
+								const GetHessianValueInPlaceFunction& objectiveHessianValueFunction,
+								const std::shared_ptr<const SparsityStructure> sparsityStructure,
+								const unsigned pointDimension,
+								const unsigned kinematicDimension,
+								const indexVector& constraintShiftMap):
+									xLowerBounds(xLowerBounds),
+									xUpperBounds(xUpperBounds),
+									gTargets(gLowerBounds),
+									gradientFunction(gradientFunction),
+									constraintFunction(constraintFunction),
+									jacobianValueFunction(jacobianValueFunction),
+									objectiveHessianValueFunction(objectiveHessianValueFunction),
+									sparsityStructure(sparsityStructure),
+									pointDimension(pointDimension),
+									kinematicDimension(kinematicDimension),
+									constraintShiftMap(constraintShiftMap),
+									linearizationPoint({xStartingPoint, {}, {}, numberVector(gLowerBounds.size(), 0)}),
+									preparationSeconds(0) {
+										assert(gLowerBounds == gUpperBounds);
+										assert(xStartingPoint.size() == xLowerBounds.size());
+										assert(kinematicDimension <= pointDimension);
+										assert(constraintShiftMap.empty() || constraintShiftMap.size() == gLowerBounds.size());
+									}
+
+			// Everything that does not depend on the measurement
+			bool prepare() {
+				const auto start = Clock::now();
+				const Index n = xLowerBounds.size();
+				const Index m = gTargets.size();
+				const numberVector& x = linearizationPoint.x;
+				const SparsityStructure& structure = *sparsityStructure;
+
+				LinearQuadraticProblem problem = {n, m, structure.hessianRows, structure.hessianCols,
+													numberVector(structure.hessianRows.size()), numberVector(n), 0,
+													structure.jacobianRows, structure.jacobianCols,
+													numberVector(structure.jacobianRows.size()), numberVector(m), gTargets,
+													numberVector(n), numberVector(n)};
+				objectiveHessianValueFunction(n, x.data(), 1, m, linearizationPoint.lambda.data(),
+												problem.hessianValues.size(), problem.hessianValues.data());
+				gradientFunction(n, x.data(), problem.linearCost.data());
+				jacobianValueFunction(n, x.data(), m, problem.jacobianValues.size(), problem.jacobianValues.data());
+				constraintFunction(n, x.data(), m, problem.constraintOffsets.data());
+
+				// Step bounds; the measured kinematics are fixed, their value is set in feedback
+				for (Index index = 0; index < n; index++) {
+					problem.xLowerBounds[index] = xLowerBounds[index] - x[index];
+					problem.xUpperBounds[index] = xUpperBounds[index] - x[index];
+				}
+				std::fill(problem.xLowerBounds.begin(), problem.xLowerBounds.begin() + kinematicDimension, 0);
+				std::fill(problem.xUpperBounds.begin(), problem.xUpperBounds.begin() + kinematicDimension, 0);
+
+				factorization = std::make_unique<FactorizeLinearQuadratic>(problem);
+				const Seconds elapsed = Clock::now() - start;
+				preparationSeconds = elapsed.count();
+				return factorization->succeeded();
+			}
+
+			FeedbackResult feedback(const numberVector& measuredKinematics) {
+				assert(measuredKinematics.size() == kinematicDimension);
+				const auto start = Clock::now();
+				if (!factorization) {
+					prepare();
+				}
+
+				const numberVector& x = linearizationPoint.x;
+				numberVector fixedSteps(x.size());
+				for (unsigned index = 0; index < x.size(); index++) {
+					fixedSteps[index] = index < kinematicDimension ? measuredKinematics[index] - x[index] :
+																		xLowerBounds[index] - x[index];
+				}
+
+				const auto step = (*factorization)(fixedSteps);
+				if (step.status != ERROR_IN_STEP_COMPUTATION) {
+					solution = {add(x, step.solution.x), step.solution.zLower, step.solution.zUpper, step.solution.lambda};
+					linearizationPoint = constraintShiftMap.empty() ?
+											solution :
+											mpc::shiftPrimalDualPoint(solution, pointDimension, constraintShiftMap);
+				}
+				factorization.reset();
+
+				const Seconds elapsed = Clock::now() - start;
+				return {step.status, preparationSeconds, elapsed.count()};
+			}
+
+			const PrimalDualPoint& getSolution() const {
+				return solution;
+			}
+
+			const PrimalDualPoint& getLinearizationPoint() const {
+				return linearizationPoint;
+			}
+	};
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "coin/IpIpoptApplication.hpp"
+#include "optimizer.hpp"
+
+namespace trajectoryOptimization::scaling {
+	using namespace trajectoryOptimization::optimizer;
+
+	// Ipopt's default nlp_lower_bound_inf / nlp_upper_bound_inf
+	const Number boundInfinity = 1e19;
+	// Largest gradient entry left after scaling, Ipopt's nlp_scaling_max_gradient
+	const Number defaultMaxGradient = 100;
+
+	// 1 / max(|lower|, |upper|) over the finite bounds, 1 for free and fixed variables
+	numberVector getVariableScalingFromBounds(const numberVector& xLowerBounds, const numberVector& xUpperBounds);
+
+	// Typical magnitude of every entry of a point, e.g. positions in the tens and controls around one
+	numberVector getVariableScalingFromMagnitudes(const unsigned numberOfPoints, const numberVector& pointMagnitudes);
+
+	// Ipopt's gradient-based rule on the Jacobian with respect to the scaled variables:
+	// min(1, maxGradient / max_j |J_ij / xScaling_j|) per row
+	numberVector getConstraintScalingFromJacobian(const unsigned numberConstraints,
+													const indexVector& jacobianRows,
+													const indexVector& jacobianCols,
+													const numberVector& jacobianValues,
+													const numberVector& xScaling,
+													const Number maxGradient = defaultMaxGradient);
+
+	Number getObjectiveScalingFromGradient(const numberVector& gradient,
+											const numberVector& xScaling,
+											const Number maxGradient = defaultMaxGradient);
+
+	// Variables are scaled by the declared point magnitudes, or by their bounds if none are given.
+	// Constraints and objective then follow from the Jacobian and gradient at the starting point.
+	ScalingParameters computeAutomaticScaling(const numberVector& xLowerBounds,
+												const numberVector& xUpperBounds,
+												const numberVector& xStartingPoint,
+												const EvaluateGradientInPlaceFunction& gradientFunction,
+												const GetJacobianValueInPlaceFunction& jacobianValueFunction,
+												const SparsityStructure& sparsityStructure,
+												const unsigned numberConstraints,
+												const numberVector& pointMagnitudes = {});
+
+	// One line with the objective factor and the range of the variable and constraint factors
+	std::string describeScaling(const ScalingParameters& scaling);
+
+	void enableUserScaling(const SmartPtr<IpoptApplication>& app);
+}
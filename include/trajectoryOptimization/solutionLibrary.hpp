@@ -0,0 +1,286 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <queue>
+#include <string>
+#include <vector>
+#include "optimizer.hpp"
+#include "trajectoryFile.hpp"
+
+namespace trajectoryOptimization::solutionLibrary {
+	using namespace trajectoryOptimization::optimizer;
+	using trajectoryFile::TrajectoryRecord;
+
+	// Problem parameters a solution is looked up by: start, goal, then every waypoint. Entries of very
+	// different units should be scaled beforehand, distances are Euclidean.
+	numberVector makeKey(const numberVector& start,
+							const numberVector& goal,
+							const std::vector<numberVector>& waypoints = {});
+
+	// Children are node indices, -1 for none; nodes are written to disk as they are
+	struct KdNode {
+		uint32_t entry;
+		uint32_t splitDimension;
+		int32_t left;
+		int32_t right;
+	};
+
+	struct Neighbor {
+		unsigned entry;
+		double squaredDistance;
+	};
+
+	// k-d tree over flat keys. Insertions descend to a leaf, so the tree can lose balance under
+	// runtime insertions; insert rebuilds it around medians once it gets much deeper than log2 n.
+	class KdTree {
+		unsigned keyDimension;
+		std::vector<double> keys;
+		std::vector<KdNode> nodes;
+		int root;
+		unsigned depth;
+
+		const double* getKey(const unsigned entry) const {
+			return keys.data() + (size_t) entry * keyDimension;
+		}
+
+		double getSquaredDistance(const double* key, const unsigned entry) const {
+			const double* other = getKey(entry);
+			double squaredDistance = 0;
+			for (unsigned index = 0; index < keyDimension; index++) {
+				squaredDistance += (key[index] - other[index]) * (key[index] - other[index]);
+			}
+			return squaredDistance;
+		}
+
+		int build(std::vector<unsigned>::iterator first, std::vector<unsigned>::iterator last, const unsigned level) {
+			if (first == last) {
+				return -1;
+			}
+			depth = std::max(depth, level + 1);
+			const unsigned splitDimension = keyDimension ? level % keyDimension : 0;
+			const auto median = first + (last - first) / 2;
+			std::nth_element(first, median, last, [this, splitDimension](const unsigned a, const unsigned b) {
+				return getKey(a)[splitDimension] < getKey(b)[splitDimension];
+			});
+			// Entries equal to the median on the split dimension end up on either side, search handles both
+			const int node = *median;
+			nodes[node] = {*median, splitDimension, -1, -1};
+			nodes[node].left = build(first, median, level + 1);
+			nodes[node].right = build(median + 1, last, level + 1);
+			return node;
+		}
+
+		public:
+			explicit KdTree(const unsigned keyDimension): keyDimension(keyDimension), root(-1), depth(0) {}
+
+			// Node i holds entry i, so nodes read back from disk fit the keys in entry order
+			KdTree(const unsigned keyDimension, std::vector<double> keys, std::vector<KdNode> nodes, const int root):
+				keyDimension(keyDimension), keys(std::move(keys)), nodes(std::move(nodes)), root(root), depth(0) {
+					assert(this->keys.size() == this->nodes.size() * keyDimension);
+				}
+
+			unsigned getKeyDimension() const {
+				return keyDimension;
+			}
+
+			unsigned size() const {
+				return nodes.size();
+			}
+
+			const std::vector<double>& getKeys() const {
+				return keys;
+			}
+
+			const std::vector<KdNode>& getNodes() const {
+				return nodes;
+			}
+
+			int getRoot() const {
+				return root;
+			}
+
+			unsigned insert(const double* key) {
+				const unsigned entry = nodes.size();
+				keys.insert(keys.end(), key, key + keyDimension);
+				nodes.push_back({entry, 0, -1, -1});
+
+				unsigned level = 0;
+				if (root < 0) {
+					root = entry;
+				} else {
+					int node = root;
+					while (true) {
+						level++;
+						KdNode& parent = nodes[node];
+						int& child = key[parent.splitDimension] < getKey(parent.entry)[parent.splitDimension] ? parent.left : parent.right;
+						if (child < 0) {
+							child = entry;
+							break;
+						}
+						node = child;
+					}
+				}
+				nodes[entry].splitDimension = keyDimension ? level % keyDimension : 0;
+				depth = std::max(depth, level + 1);
+
+				if (depth > 2 * std::log2(nodes.size() + 1) + 8) {
+					rebuild();
+				}
+				return entry;
+			}
+
+			void rebuild() {
+				std::vector<unsigned> entries(nodes.size());
+				for (unsigned entry = 0; entry < entries.size(); entry++) {
+					entries[entry] = entry;
+				}
+				depth = 0;
+				root = build(entries.begin(), entries.end(), 0);
+			}
+
+			// Closest first
+			std::vector<Neighbor> nearest(const double* query, const unsigned k) const {
+				const auto fartherFirst = [](const Neighbor& a, const Neighbor& b) { return a.squaredDistance < b.squaredDistance; };
+				std::priority_queue<Neighbor, std::vector<Neighbor>, decltype(fartherFirst)> best(fartherFirst);
+
+				const auto search = [&](const auto& search, const int node) -> void {
+					if (node < 0) {
+						return;
+					}
+					const KdNode& current = nodes[node];
+					const double squaredDistance = getSquaredDistance(query, current.entry);
+					if (best.size() < k) {
+						best.push({current.entry, squaredDistance});
+					} else if (squaredDistance < best.top().squaredDistance) {
+						best.pop();
+						best.push({current.entry, squaredDistance});
+					}
+
+					const double offset = query[current.splitDimension] - getKey(current.entry)[current.splitDimension];
+					search(search, offset < 0 ? current.left : current.right);
+					if (best.size() < k || offset * offset < best.top().squaredDistance) {
+						search(search, offset < 0 ? current.right : current.left);
+					}
+				};
+				if (k > 0) {
+					search(search, root);
+				}
+
+				std::vector<Neighbor> neighbors(best.size());
+				for (auto neighbor = neighbors.rbegin(); neighbor != neighbors.rend(); ++neighbor) {
+					*neighbor = best.top();
+					best.pop();
+				}
+				return neighbors;
+			}
+	};
+
+	// Solved trajectories, multipliers included, stored under the parameters of the problem they solve.
+	// Warm starts for a new problem come from the closest stored problems.
+	class SolutionLibrary {
+		KdTree tree;
+		std::vector<TrajectoryRecord> records;
+
+		static constexpr uint32_t indexMagic = 0x4B44494C; // "LIDK" on little-endian machines
+
+		public:
+			explicit SolutionLibrary(const unsigned keyDimension): tree(keyDimension) {}
+
+			unsigned getKeyDimension() const {
+				return tree.getKeyDimension();
+			}
+
+			unsigned size() const {
+				return records.size();
+			}
+
+			const TrajectoryRecord& getRecord(const unsigned entry) const {
+				return records[entry];
+			}
+
+			numberVector getKey(const unsigned entry) const {
+				const auto key = tree.getKeys().begin() + (size_t) entry * getKeyDimension();
+				return numberVector(key, key + getKeyDimension());
+			}
+
+			unsigned insert(const numberVector& key, const TrajectoryRecord& record) {
+				assert(key.size() == getKeyDimension());
+				records.push_back(record);
+				return tree.insert(key.data());
+			}
+
+			std::vector<Neighbor> nearest(const numberVector& key, const unsigned k) const {
+				assert(key.size() == getKeyDimension());
+				return tree.nearest(key.data(), k);
+			}
+
+			// Hands the closest of the k nearest solutions that fits the optimizer's problem to
+			// setStartingPoint, multipliers that do not fit are left out. Use with enableWarmStart.
+			bool setWarmStart(TrajectoryOptimizer& trajectoryOptimizer, const numberVector& key, const unsigned k = 8) const {
+				const size_t numberVariables = trajectoryOptimizer.getVariableUpperBounds().size();
+				const size_t numberConstraints = trajectoryOptimizer.getNumberConstraints();
+				for (const auto& neighbor: nearest(key, k)) {
+					const auto& solution = records[neighbor.entry].solution;
+					if (solution.x.size() != numberVariables) {
+						continue;
+					}
+					const bool boundMultipliers = solution.zLower.size() == numberVariables && solution.zUpper.size() == numberVariables;
+					trajectoryOptimizer.setStartingPoint({solution.x,
+															boundMultipliers ? solution.zLower : numberVector(),
+															boundMultipliers ? solution.zUpper : numberVector(),
+															solution.lambda.size() == numberConstraints ? solution.lambda : numberVector()});
+					return true;
+				}
+				return false;
+			}
+
+			// Solutions go to filename + ".traj" as trajectory records, keys and tree to filename
+			bool save(const std::string& filename) const {
+				{
+					trajectoryFile::TrajectoryWriter writer(filename + ".traj");
+					for (const auto& record: records) {
+						writer.write(record);
+					}
+					if (!writer.flush()) {
+						return false;
+					}
+				}
+
+				std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+				const uint32_t header[4] = {indexMagic, getKeyDimension(), size(), (uint32_t) tree.getRoot()};
+				file.write(reinterpret_cast<const char*>(header), sizeof(header));
+				file.write(reinterpret_cast<const char*>(tree.getKeys().data()), tree.getKeys().size() * sizeof(double));
+				file.write(reinterpret_cast<const char*>(tree.getNodes().data()), tree.getNodes().size() * sizeof(KdNode));
+				return file.good();
+			}
+
+			// Replaces the contents; false, and the library unchanged, if the files do not match
+			bool load(const std::string& filename) {
+				std::ifstream file(filename, std::ios::binary);
+				uint32_t header[4];
+				if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != indexMagic) {
+					return false;
+				}
+				const unsigned keyDimension = header[1];
+				const unsigned numberOfEntries = header[2];
+				std::vector<double> keys((size_t) numberOfEntries * keyDimension);
+				std::vector<KdNode> nodes(numberOfEntries);
+				file.read(reinterpret_cast<char*>(keys.data()), keys.size() * sizeof(double));
+				file.read(reinterpret_cast<char*>(nodes.data()), nodes.size() * sizeof(KdNode));
+				if (!file) {
+					return false;
+				}
+
+				auto loadedRecords = trajectoryFile::readFile(filename + ".traj");
+				if (loadedRecords.size() != numberOfEntries) {
+					return false;
+				}
+				tree = KdTree(keyDimension, std::move(keys), std::move(nodes), (int32_t) header[3]);
+				records = std::move(loadedRecords);
+				return true;
+			}
+	};
+}
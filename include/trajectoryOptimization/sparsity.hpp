@@ -0,0 +1,186 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace trajectoryOptimization::sparsity {
+	// CSR or CSC: line l holds the entries entries[offsets[l]] to entries[offsets[l + 1] - 1], positions in the
+	// coordinate arrays, and indices holds their column (CSR) or row (CSC)
+	struct CompressedView {
+		std::vector<int> offsets;
+		std::vector<int> indices;
+		std::vector<int> entries;
+	};
+
+	// Rows by lines, e.g. compressLines(numberRows, rows, cols) for CSR and compressLines(numberCols, cols, rows)
+	// for CSC. Coordinates may come in any order and repeat; entries keep their order within a line.
+	CompressedView compressLines(const unsigned numberLines, const std::vector<int>& lines, const std::vector<int>& indices);
+
+	// Slot in a pattern of every entry of a block, block values are added to the slots they map to
+	using IndexMap = std::vector<int>;
+
+	// Nonzero structure of a numberRows x numberCols matrix. Entries are in row-major order, each
+	// (row, col) once, so patterns compare, merge and search without further sorting.
+	class SparsityPattern {
+		unsigned numberRows;
+		unsigned numberCols;
+		std::vector<int> rows;
+		std::vector<int> cols;
+
+		public:
+			SparsityPattern(): numberRows(0), numberCols(0) {}
+
+			// Coordinates in any order, repeated ones are merged
+			SparsityPattern(const unsigned numberRows,
+							const unsigned numberCols,
+							const std::vector<int>& entryRows,
+							const std::vector<int>& entryCols):
+								numberRows(numberRows),
+								numberCols(numberCols) {
+									assert(entryRows.size() == entryCols.size());
+									std::vector<int> order(entryRows.size());
+									std::iota(order.begin(), order.end(), 0);
+									std::sort(order.begin(), order.end(), [&](const int a, const int b) {
+										return entryRows[a] != entryRows[b] ? entryRows[a] < entryRows[b] : entryCols[a] < entryCols[b];
+									});
+									for (const int entry: order) {
+										assert(entryRows[entry] >= 0 && entryRows[entry] < (int) numberRows);
+										assert(entryCols[entry] >= 0 && entryCols[entry] < (int) numberCols);
+										if (rows.empty() || rows.back() != entryRows[entry] || cols.back() != entryCols[entry]) {
+											rows.push_back(entryRows[entry]);
+											cols.push_back(entryCols[entry]);
+										}
+									}
+								}
+
+			unsigned getNumberRows() const { return numberRows; }
+			unsigned getNumberCols() const { return numberCols; }
+			unsigned size() const { return rows.size(); }
+
+			// Coordinate (COO) view, what Ipopt takes
+			const std::vector<int>& getRows() const { return rows; }
+			const std::vector<int>& getCols() const { return cols; }
+
+			CompressedView getCompressedRows() const { return compressLines(numberRows, rows, cols); }
+			CompressedView getCompressedCols() const { return compressLines(numberCols, cols, rows); }
+
+			// Slot of (row, col), -1 if it is structurally zero
+			int find(const int row, const int col) const {
+				unsigned first = 0;
+				unsigned last = rows.size();
+				while (first < last) {
+					const unsigned middle = first + (last - first) / 2;
+					if (rows[middle] < row || (rows[middle] == row && cols[middle] < col)) {
+						first = middle + 1;
+					} else {
+						last = middle;
+					}
+				}
+				return first < rows.size() && rows[first] == row && cols[first] == col ? first : -1;
+			}
+
+			bool operator==(const SparsityPattern& other) const {
+				return numberRows == other.numberRows && numberCols == other.numberCols
+						&& rows == other.rows && cols == other.cols;
+			}
+
+			bool operator!=(const SparsityPattern& other) const {
+				return !(*this == other);
+			}
+	};
+
+	// Entries of either; both of the same size
+	SparsityPattern unite(const SparsityPattern& a, const SparsityPattern& b);
+
+	// Entries of any of them, sorted and merged once; all of the same size, at least one
+	SparsityPattern unite(const std::vector<SparsityPattern>& patterns);
+
+	// Folds value into seed the way boost::hash_combine does
+	inline std::size_t combineHash(const std::size_t seed, const std::size_t value) {
+		return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+	}
+
+	// Of the coordinates in their order, e.g. to tell structures apart without comparing them
+	std::size_t hashEntries(const std::vector<int>& entryRows, const std::vector<int>& entryCols);
+
+	std::size_t hashPattern(const SparsityPattern& pattern);
+
+	// The block's entries shifted into a numberRows x numberCols pattern, e.g. a constraint block at its row offset
+	SparsityPattern placeBlock(const SparsityPattern& block,
+								const unsigned numberRows,
+								const unsigned numberCols,
+								const unsigned rowOffset,
+								const unsigned colOffset);
+
+	// The lower triangle of a symmetric matrix given by any of its entries: (row, col) above the
+	// diagonal becomes (col, row). Ipopt takes the Hessian of the Lagrangian this way.
+	SparsityPattern getLowerTriangle(const SparsityPattern& symmetric);
+
+	// For every block entry (entryRows[k], entryCols[k]) shifted by the offsets, its slot in pattern;
+	// with lowerTriangle, entries above the diagonal map to their mirror image. Every entry must be in pattern.
+	IndexMap getIndexMap(const std::vector<int>& entryRows,
+							const std::vector<int>& entryCols,
+							const SparsityPattern& pattern,
+							const unsigned rowOffset = 0,
+							const unsigned colOffset = 0,
+							const bool lowerTriangle = false);
+
+	IndexMap getIndexMap(const SparsityPattern& block,
+							const SparsityPattern& pattern,
+							const unsigned rowOffset = 0,
+							const unsigned colOffset = 0,
+							const bool lowerTriangle = false);
+
+	// values[indexMap[k]] += factor * blockValues[k]
+	inline void assemble(const IndexMap& indexMap, const double* blockValues, double* values, const double factor = 1) {
+		for (unsigned entry = 0; entry < indexMap.size(); entry++) {
+			values[indexMap[entry]] += factor * blockValues[entry];
+		}
+	}
+
+	// Values on a pattern that structurally identical matrices share
+	class SparseMatrix {
+		std::shared_ptr<const SparsityPattern> pattern;
+		std::vector<double> values;
+
+		public:
+			explicit SparseMatrix(const std::shared_ptr<const SparsityPattern> pattern):
+				pattern(pattern), values(pattern->size(), 0) {}
+
+			const SparsityPattern& getPattern() const { return *pattern; }
+			const std::vector<double>& getValues() const { return values; }
+			std::vector<double>& getValues() { return values; }
+
+			void setZero() {
+				std::fill(values.begin(), values.end(), 0);
+			}
+
+			void add(const IndexMap& indexMap, const double* blockValues, const double factor = 1) {
+				assemble(indexMap, blockValues, values.data(), factor);
+			}
+
+			// A x
+			std::vector<double> multiply(const std::vector<double>& x) const {
+				assert(x.size() == pattern->getNumberCols());
+				std::vector<double> product(pattern->getNumberRows(), 0);
+				for (unsigned entry = 0; entry < values.size(); entry++) {
+					product[pattern->getRows()[entry]] += values[entry] * x[pattern->getCols()[entry]];
+				}
+				return product;
+			}
+
+			// A^T x
+			std::vector<double> multiplyTransposed(const std::vector<double>& x) const {
+				assert(x.size() == pattern->getNumberRows());
+				std::vector<double> product(pattern->getNumberCols(), 0);
+				for (unsigned entry = 0; entry < values.size(); entry++) {
+					product[pattern->getCols()[entry]] += values[entry] * x[pattern->getRows()[entry]];
+				}
+				return product;
+			}
+	};
+}
@@ -0,0 +1,338 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "optimizer.hpp"
+
+namespace trajectoryOptimization::telemetry {
+	using namespace trajectoryOptimization::optimizer;
+	using Clock = std::chrono::steady_clock;
+	using Seconds = std::chrono::duration<double>;
+
+	static_assert(std::atomic<uint64_t>::is_always_lock_free, "slot sequences are shared between processes");
+
+	const uint32_t magic = 0x4D4C4554; // "TELM" on little-endian machines
+	const uint32_t version = 1;
+
+	struct Sample {
+		int32_t iteration;
+		int32_t restoration;
+		double objectiveValue;
+		double primalInfeasibility;
+		double dualInfeasibility;
+		double mu;
+		double stepNorm;
+		// Since the solve started and since the previous sample
+		double seconds;
+		double iterationSeconds;
+		// Points of the downsampled trajectory in this sample, 0 if none was available
+		uint32_t numberOfStoredPoints;
+		uint32_t pointDimension;
+	};
+
+	// Shared memory layout: the header, then capacity slots of slotSize bytes, each a sequence number,
+	// a Sample and numberOfStoredPoints * pointDimension doubles. The single writer publishes sample
+	// k into slot k % capacity under a seqlock: the sequence is odd while the slot is written and
+	// 2 * (k + 1) once sample k is in it. Readers never block the writer; they copy a slot and keep
+	// the copy only if the sequence was the expected one before and after.
+	struct SegmentHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t capacity;
+		uint32_t numberOfStoredPoints;
+		uint32_t pointDimension;
+		uint32_t slotSize;
+		std::atomic<uint64_t> published;
+	};
+
+	namespace detail {
+		struct SlotHeader {
+			std::atomic<uint64_t> sequence;
+			Sample sample;
+		};
+
+		inline size_t getSlotSize(const unsigned numberOfStoredPoints, const unsigned pointDimension) {
+			const size_t size = sizeof(SlotHeader) + (size_t) numberOfStoredPoints * pointDimension * sizeof(double);
+			return (size + 63) / 64 * 64;
+		}
+
+		inline size_t getSegmentSize(const unsigned capacity, const size_t slotSize) {
+			return 64 + (size_t) capacity * slotSize;
+		}
+	}
+	static_assert(sizeof(SegmentHeader) <= 64, "slots start at the second cache line");
+
+	struct Record {
+		Sample sample;
+		// numberOfStoredPoints points of pointDimension entries, evenly spread over the trajectory
+		std::vector<double> trajectory;
+	};
+
+	// Creates the shared memory segment, e.g. name "/trajectoryOptimization", and removes it again on
+	// destruction. One process writes, from one thread at a time.
+	class TelemetryWriter {
+		SegmentHeader* header;
+		size_t segmentSize;
+		const std::string name;
+
+		detail::SlotHeader* getSlot(const uint64_t index) const {
+			char* slots = reinterpret_cast<char*>(header) + 64;
+			return reinterpret_cast<detail::SlotHeader*>(slots + (index % header->capacity) * header->slotSize);
+		}
+
+		public:
+			TelemetryWriter(const std::string& name,
+							const unsigned capacity,
+							const unsigned numberOfStoredPoints = 0,
+							const unsigned pointDimension = 0):
+								header(nullptr),
+								segmentSize(0),
+								name(name) {
+				assert(capacity > 0);
+				const size_t slotSize = detail::getSlotSize(numberOfStoredPoints, pointDimension);
+				const int descriptor = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+				if (descriptor < 0) {
+					return;
+				}
+				const size_t size = detail::getSegmentSize(capacity, slotSize);
+				void* mapping = ftruncate(descriptor, size) == 0 ?
+								mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0) :
+								MAP_FAILED;
+				close(descriptor);
+				if (mapping == MAP_FAILED) {
+					shm_unlink(name.c_str());
+					return;
+				}
+
+				segmentSize = size;
+				header = static_cast<SegmentHeader*>(mapping);
+				header->capacity = capacity;
+				header->numberOfStoredPoints = numberOfStoredPoints;
+				header->pointDimension = pointDimension;
+				header->slotSize = slotSize;
+				new (&header->published) std::atomic<uint64_t>(0);
+				for (uint64_t index = 0; index < capacity; index++) {
+					new (&getSlot(index)->sequence) std::atomic<uint64_t>(0);
+				}
+				header->version = version;
+				// Readers check the magic last
+				std::atomic_thread_fence(std::memory_order_release);
+				header->magic = magic;
+			}
+
+			~TelemetryWriter() {
+				if (header) {
+					munmap(header, segmentSize);
+					shm_unlink(name.c_str());
+				}
+			}
+
+			TelemetryWriter(const TelemetryWriter&) = delete;
+			TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+			bool isOpen() const {
+				return header != nullptr;
+			}
+
+			unsigned getNumberOfStoredPoints() const {
+				return header ? header->numberOfStoredPoints : 0;
+			}
+
+			// x may be null; otherwise every stored point is taken from x's numberOfPoints points
+			void publish(Sample sample, const double* x = nullptr, const unsigned numberOfPoints = 0) {
+				if (!header) {
+					return;
+				}
+				const uint64_t index = header->published.load(std::memory_order_relaxed);
+				detail::SlotHeader* slot = getSlot(index);
+				double* trajectory = reinterpret_cast<double*>(slot + 1);
+				const unsigned storedPoints = x && numberOfPoints > 0 ? header->numberOfStoredPoints : 0;
+				sample.numberOfStoredPoints = storedPoints;
+				sample.pointDimension = header->pointDimension;
+
+				slot->sequence.store(2 * index + 1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+				slot->sample = sample;
+				for (unsigned point = 0; point < storedPoints; point++) {
+					const unsigned timeIndex = storedPoints > 1 ?
+												(unsigned) ((uint64_t) point * (numberOfPoints - 1) / (storedPoints - 1)) : 0;
+					std::memcpy(trajectory + point * header->pointDimension,
+								x + (size_t) timeIndex * header->pointDimension,
+								header->pointDimension * sizeof(double));
+				}
+				slot->sequence.store(2 * (index + 1), std::memory_order_release);
+				header->published.store(index + 1, std::memory_order_release);
+			}
+	};
+
+	// Attaches to a writer's segment read-only and returns what was published since the last poll
+	class TelemetryReader {
+		const SegmentHeader* header;
+		size_t segmentSize;
+		uint64_t next;
+		uint64_t lost;
+
+		const detail::SlotHeader* getSlot(const uint64_t index) const {
+			const char* slots = reinterpret_cast<const char*>(header) + 64;
+			return reinterpret_cast<const detail::SlotHeader*>(slots + (index % header->capacity) * header->slotSize);
+		}
+
+		public:
+			explicit TelemetryReader(const std::string& name): header(nullptr), segmentSize(0), next(0), lost(0) {
+				const int descriptor = shm_open(name.c_str(), O_RDONLY, 0);
+				if (descriptor < 0) {
+					return;
+				}
+				struct stat status;
+				void* mapping = fstat(descriptor, &status) == 0 && status.st_size >= 64 ?
+								mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0) :
+								MAP_FAILED;
+				close(descriptor);
+				if (mapping == MAP_FAILED) {
+					return;
+				}
+				const SegmentHeader* segment = static_cast<const SegmentHeader*>(mapping);
+				const bool initialized = segment->magic == magic;
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (!initialized || segment->version != version ||
+						detail::getSegmentSize(segment->capacity, segment->slotSize) > (size_t) status.st_size) {
+					munmap(mapping, status.st_size);
+					return;
+				}
+				header = segment;
+				segmentSize = status.st_size;
+			}
+
+			~TelemetryReader() {
+				if (header) {
+					munmap(const_cast<SegmentHeader*>(header), segmentSize);
+				}
+			}
+
+			TelemetryReader(const TelemetryReader&) = delete;
+			TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+			bool isOpen() const {
+				return header != nullptr;
+			}
+
+			// Samples overwritten before they could be read
+			uint64_t getLost() const {
+				return lost;
+			}
+
+			// Appends the new records in order and returns how many were appended
+			size_t poll(std::vector<Record>& records) {
+				if (!header) {
+					return 0;
+				}
+				const uint64_t published = header->published.load(std::memory_order_acquire);
+				if (published > next + header->capacity) {
+					lost += published - header->capacity - next;
+					next = published - header->capacity;
+				}
+
+				size_t appended = 0;
+				for (; next < published; next++) {
+					const detail::SlotHeader* slot = getSlot(next);
+					const uint64_t expected = 2 * (next + 1);
+					if (slot->sequence.load(std::memory_order_acquire) != expected) {
+						lost++;
+						continue;
+					}
+					Record record;
+					std::memcpy(&record.sample, &slot->sample, sizeof(Sample));
+					const double* trajectory = reinterpret_cast<const double*>(slot + 1);
+					const size_t trajectorySize = std::min<size_t>(record.sample.numberOfStoredPoints, header->numberOfStoredPoints)
+													* header->pointDimension;
+					record.trajectory.assign(trajectory, trajectory + trajectorySize);
+					std::atomic_thread_fence(std::memory_order_acquire);
+					if (slot->sequence.load(std::memory_order_relaxed) != expected) {
+						lost++;
+						continue;
+					}
+					records.push_back(std::move(record));
+					appended++;
+				}
+				return appended;
+			}
+	};
+
+	// Publishes every iteration, to be set with TrajectoryOptimizer::setIntermediateFunction.
+	// With stored points the optimizer is switched to iterate tracking to provide the trajectory.
+	// An intermediate function that was already set is still called.
+	IntermediateFunction makeTelemetryFunction(const std::shared_ptr<TelemetryWriter> writer,
+												const SmartPtr<TrajectoryOptimizer>& trajectoryOptimizer,
+												const unsigned pointDimension);
+
+	// Keeps one gnuplot process open and sends it data through a pipe, so plotting never waits for
+	// a window to close, unlike utilities::plotTrajectory.
+	class LivePlot {
+		std::FILE* gnuplot;
+
+		public:
+			LivePlot(): gnuplot(popen("gnuplot", "w")) {}
+
+			~LivePlot() {
+				if (gnuplot) {
+					pclose(gnuplot);
+				}
+			}
+
+			LivePlot(const LivePlot&) = delete;
+			LivePlot& operator=(const LivePlot&) = delete;
+
+			bool isOpen() const {
+				return gnuplot != nullptr;
+			}
+
+			// Objective and primal infeasibility over the iterations, plus the positions of the latest
+			// stored trajectory against their index
+			void plot(const std::vector<Record>& records, const unsigned positionDimension) {
+				if (!gnuplot || records.empty()) {
+					return;
+				}
+				const auto& latest = records.back();
+				const bool trajectory = latest.sample.numberOfStoredPoints > 0 && positionDimension > 0;
+				std::fprintf(gnuplot, "set multiplot layout %d, 1\nset logscale y\n", trajectory ? 2 : 1);
+				std::fprintf(gnuplot, "plot '-' using 1:2 with lines title 'objective', "
+										"'-' using 1:2 with lines title 'primal infeasibility'\n");
+				for (const auto value: {&Sample::objectiveValue, &Sample::primalInfeasibility}) {
+					for (const auto& record: records) {
+						std::fprintf(gnuplot, "%d %.17g\n", record.sample.iteration, std::abs(record.sample.*value));
+					}
+					std::fprintf(gnuplot, "e\n");
+				}
+				std::fprintf(gnuplot, "unset logscale y\n");
+				if (trajectory) {
+					std::fprintf(gnuplot, "plot");
+					for (unsigned dimension = 0; dimension < positionDimension; dimension++) {
+						std::fprintf(gnuplot, "%s '-' using 1:2 with linespoints title 'position %u'",
+										dimension ? "," : "", dimension);
+					}
+					std::fprintf(gnuplot, "\n");
+					for (unsigned dimension = 0; dimension < positionDimension; dimension++) {
+						for (unsigned point = 0; point < latest.sample.numberOfStoredPoints; point++) {
+							std::fprintf(gnuplot, "%u %.17g\n", point,
+											latest.trajectory[point * latest.sample.pointDimension + dimension]);
+						}
+						std::fprintf(gnuplot, "e\n");
+					}
+				}
+				std::fprintf(gnuplot, "unset multiplot\n");
+				std::fflush(gnuplot);
+			}
+	};
+}
@@ -0,0 +1,156 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "optimizer.hpp"
+
+namespace trajectoryOptimization::trajectoryFile {
+	using namespace trajectoryOptimization::optimizer;
+
+	// A trajectory file is a sequence of records, each a header followed by
+	//   x                       numberOfPoints * pointDimension doubles
+	//   timeStepSizes           numberOfPoints - 1 doubles     if HAS_TIME_STEP_SIZES
+	//   zLower, zUpper          numberOfPoints * pointDimension doubles each   if HAS_BOUND_MULTIPLIERS
+	//   lambda                  numberConstraints doubles      if HAS_CONSTRAINT_MULTIPLIERS
+	// Everything is in the byte order of the machine that wrote it; a reader on the other order
+	// sees a byte-swapped magic and rejects the file. Records are 8 byte aligned throughout.
+	const uint32_t magic = 0x4A525454; // "TTRJ" on little-endian machines
+	const uint16_t version = 1;
+
+	enum RecordFlags : uint16_t {
+		HAS_TIME_STEP_SIZES = 1 << 0,
+		HAS_BOUND_MULTIPLIERS = 1 << 1,
+		HAS_CONSTRAINT_MULTIPLIERS = 1 << 2
+	};
+
+	struct RecordHeader {
+		uint32_t magic;
+		uint16_t version;
+		uint16_t flags;
+		uint32_t numberOfPoints;
+		uint32_t positionDimension;
+		uint32_t controlDimension;
+		uint32_t numberConstraints;
+		int32_t status;
+		uint32_t reserved;
+		double timeStepSize;
+		double objectiveValue;
+	};
+	static_assert(sizeof(RecordHeader) == 48 && std::is_standard_layout<RecordHeader>::value,
+					"RecordHeader is written as is");
+
+	struct TrajectoryRecord {
+		unsigned positionDimension;
+		unsigned controlDimension;
+		// Uniform step; timeStepSizes, if not empty, has one entry per interval and takes precedence
+		double timeStepSize;
+		std::vector<double> timeStepSizes;
+		SolverReturn status;
+		Number objectiveValue;
+		PrimalDualPoint solution;
+
+		unsigned getPointDimension() const {
+			return 2 * positionDimension + controlDimension;
+		}
+
+		unsigned getNumberOfPoints() const {
+			return solution.x.size() / getPointDimension();
+		}
+	};
+
+	// Appends records through one large buffer instead of a flush per line. Meant to be called from
+	// finalizers, the pointer overload takes Ipopt's arrays as they are.
+	class TrajectoryWriter {
+		std::vector<char> buffer;
+		std::ofstream file;
+
+		void writeDoubles(const Number* values, const size_t count) {
+			file.write(reinterpret_cast<const char*>(values), count * sizeof(Number));
+		}
+
+		public:
+			TrajectoryWriter(const std::string& filename, const bool append = false, const size_t bufferSize = 1 << 20):
+				buffer(bufferSize) {
+					file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+					file.open(filename, std::ios::binary | std::ios::out | (append ? std::ios::app : std::ios::trunc));
+				}
+
+			// zLower, zUpper and lambda may be null to leave them out; timeStepSizes too, then
+			// timeStepSize is the step of every interval
+			bool write(const unsigned positionDimension,
+						const unsigned controlDimension,
+						const double timeStepSize,
+						const double* timeStepSizes,
+						const SolverReturn status,
+						const Index n,
+						const Number* x,
+						const Number* zLower,
+						const Number* zUpper,
+						const Index m,
+						const Number* lambda,
+						const Number objectiveValue) {
+				const unsigned pointDimension = 2 * positionDimension + controlDimension;
+				assert(n % pointDimension == 0);
+				assert((zLower == nullptr) == (zUpper == nullptr));
+				const unsigned numberOfPoints = n / pointDimension;
+
+				RecordHeader header = {magic, version, 0, numberOfPoints, positionDimension, controlDimension,
+										(uint32_t) (lambda ? m : 0), status, 0, timeStepSize, objectiveValue};
+				header.flags = (uint16_t) ((timeStepSizes ? HAS_TIME_STEP_SIZES : 0)
+											| (zLower ? HAS_BOUND_MULTIPLIERS : 0)
+											| (lambda ? HAS_CONSTRAINT_MULTIPLIERS : 0));
+				file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				writeDoubles(x, n);
+				if (timeStepSizes) {
+					writeDoubles(timeStepSizes, numberOfPoints - 1);
+				}
+				if (zLower) {
+					writeDoubles(zLower, n);
+					writeDoubles(zUpper, n);
+				}
+				if (lambda) {
+					writeDoubles(lambda, m);
+				}
+				return file.good();
+			}
+
+			bool write(const TrajectoryRecord& record) {
+				const auto& solution = record.solution;
+				assert(record.timeStepSizes.empty() || record.timeStepSizes.size() + 1 == record.getNumberOfPoints());
+				const bool boundMultipliers = !solution.zLower.empty() && !solution.zUpper.empty();
+				return write(record.positionDimension, record.controlDimension, record.timeStepSize,
+								record.timeStepSizes.empty() ? nullptr : record.timeStepSizes.data(),
+								record.status, solution.x.size(), solution.x.data(),
+								boundMultipliers ? solution.zLower.data() : nullptr,
+								boundMultipliers ? solution.zUpper.data() : nullptr,
+								solution.lambda.size(), solution.lambda.empty() ? nullptr : solution.lambda.data(),
+								record.objectiveValue);
+			}
+
+			bool flush() {
+				file.flush();
+				return file.good();
+			}
+
+			bool good() const {
+				return file.good();
+			}
+	};
+
+	// False at the end of the stream or on a malformed record
+	bool readRecord(std::istream& stream, TrajectoryRecord& record);
+
+	std::vector<TrajectoryRecord> readFile(const std::string& filename);
+
+	// One line per point: record, timeIndex, time, then the point's entries
+	void writeCsv(std::ostream& stream, const std::vector<TrajectoryRecord>& records);
+
+	// Header fields as comments, then the points of a record one per line
+	void writeText(std::ostream& stream, const std::vector<TrajectoryRecord>& records);
+}
@@ -0,0 +1,212 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace trajectoryOptimization::trajectoryView {
+
+	// Contiguous values inside the decision vector, e.g. the position of one knot
+	template<typename T>
+	class Span {
+		T* first;
+		unsigned count;
+		public:
+			using value_type = std::remove_cv_t<T>;
+			using size_type = unsigned;
+			using iterator = T*;
+			using const_iterator = T*;
+
+			Span(T* first, const unsigned count): first(first), count(count) {}
+
+			T* data() const { return first; }
+			unsigned size() const { return count; }
+			bool empty() const { return count == 0; }
+			T* begin() const { return first; }
+			T* end() const { return first + count; }
+
+			T& operator[](const unsigned index) const {
+				assert(index < count);
+				return first[index];
+			}
+	};
+
+	// Values a fixed stride apart, e.g. one position component across all knots
+	template<typename T>
+	class StridedSpan {
+		T* first;
+		unsigned count;
+		unsigned stride;
+		public:
+			// Counts elements instead of advancing a pointer, which would leave the decision vector at end()
+			class iterator {
+				T* first;
+				std::ptrdiff_t index;
+				unsigned stride;
+				public:
+					using iterator_category = std::random_access_iterator_tag;
+					using value_type = std::remove_cv_t<T>;
+					using difference_type = std::ptrdiff_t;
+					using pointer = T*;
+					using reference = T&;
+
+					iterator(T* first, const std::ptrdiff_t index, const unsigned stride): first(first), index(index), stride(stride) {}
+
+					T& operator*() const { return first[index * stride]; }
+					T& operator[](const difference_type offset) const { return first[(index + offset) * stride]; }
+					iterator& operator++() { index++; return *this; }
+					iterator operator++(int) { iterator previous = *this; index++; return previous; }
+					iterator& operator--() { index--; return *this; }
+					iterator operator--(int) { iterator previous = *this; index--; return previous; }
+					iterator& operator+=(const difference_type offset) { index += offset; return *this; }
+					iterator& operator-=(const difference_type offset) { index -= offset; return *this; }
+					iterator operator+(const difference_type offset) const { return iterator(*this) += offset; }
+					iterator operator-(const difference_type offset) const { return iterator(*this) -= offset; }
+					difference_type operator-(const iterator& other) const { return index - other.index; }
+					bool operator==(const iterator& other) const { return index == other.index; }
+					bool operator!=(const iterator& other) const { return index != other.index; }
+					bool operator<(const iterator& other) const { return index < other.index; }
+			};
+
+			using value_type = std::remove_cv_t<T>;
+			using size_type = unsigned;
+			using const_iterator = iterator;
+
+			StridedSpan(T* first, const unsigned count, const unsigned stride): first(first), count(count), stride(stride) {}
+
+			unsigned size() const { return count; }
+			bool empty() const { return count == 0; }
+			iterator begin() const { return {first, 0, stride}; }
+			iterator end() const { return {first, count, stride}; }
+
+			T& operator[](const unsigned index) const {
+				assert(index < count);
+				return first[(std::size_t) index * stride];
+			}
+	};
+
+	template<typename T>
+	struct Knot {
+		unsigned timeIndex;
+		Span<T> point;
+		Span<T> position;
+		Span<T> velocity;
+		Span<T> control;
+	};
+
+	// Knot-structured access to a flat trajectory of points [position, velocity, control] without copying.
+	// T is const double for Ipopt's const Number* and double for gradients or starting points that are filled in.
+	template<typename T>
+	class BasicTrajectoryView {
+		T* trajectoryPointer;
+		unsigned numberOfPoints;
+		unsigned positionDimension;
+		unsigned controlDimension;
+		unsigned pointDimension;
+
+		public:
+			class iterator {
+				const BasicTrajectoryView* view;
+				unsigned timeIndex;
+				public:
+					using iterator_category = std::forward_iterator_tag;
+					using value_type = Knot<T>;
+					using difference_type = std::ptrdiff_t;
+					using pointer = void;
+					using reference = Knot<T>;
+
+					iterator(const BasicTrajectoryView* view, const unsigned timeIndex): view(view), timeIndex(timeIndex) {}
+
+					Knot<T> operator*() const { return view->knot(timeIndex); }
+					iterator& operator++() { timeIndex++; return *this; }
+					iterator operator++(int) { iterator previous = *this; timeIndex++; return previous; }
+					bool operator==(const iterator& other) const { return timeIndex == other.timeIndex; }
+					bool operator!=(const iterator& other) const { return timeIndex != other.timeIndex; }
+			};
+
+			BasicTrajectoryView(T* trajectoryPointer,
+								const unsigned numberOfPoints,
+								const unsigned positionDimension,
+								const unsigned controlDimension):
+									trajectoryPointer(trajectoryPointer),
+									numberOfPoints(numberOfPoints),
+									positionDimension(positionDimension),
+									controlDimension(controlDimension),
+									pointDimension(2 * positionDimension + controlDimension) {}
+
+			// A mutable view converts to a read-only one
+			template<typename U, typename = std::enable_if_t<std::is_same_v<T, const U>>>
+			BasicTrajectoryView(const BasicTrajectoryView<U>& other):
+				BasicTrajectoryView(other.data(), other.getNumberOfPoints(), other.getPositionDimension(), other.getControlDimension()) {}
+
+			T* data() const { return trajectoryPointer; }
+			unsigned size() const { return numberOfPoints * pointDimension; }
+			unsigned getNumberOfPoints() const { return numberOfPoints; }
+			unsigned getPositionDimension() const { return positionDimension; }
+			unsigned getVelocityDimension() const { return positionDimension; }
+			unsigned getControlDimension() const { return controlDimension; }
+			unsigned getPointDimension() const { return pointDimension; }
+
+			Span<T> point(const unsigned timeIndex) const {
+				assert(timeIndex < numberOfPoints);
+				return {trajectoryPointer + timeIndex * pointDimension, pointDimension};
+			}
+
+			Span<T> position(const unsigned timeIndex) const {
+				return {point(timeIndex).data(), positionDimension};
+			}
+
+			Span<T> velocity(const unsigned timeIndex) const {
+				return {point(timeIndex).data() + positionDimension, positionDimension};
+			}
+
+			Span<T> control(const unsigned timeIndex) const {
+				return {point(timeIndex).data() + 2 * positionDimension, controlDimension};
+			}
+
+			Knot<T> knot(const unsigned timeIndex) const {
+				return {timeIndex, point(timeIndex), position(timeIndex), velocity(timeIndex), control(timeIndex)};
+			}
+
+			// One entry of the point across all knots
+			StridedSpan<T> component(const unsigned pointIndex) const {
+				assert(pointIndex < pointDimension);
+				return {trajectoryPointer + pointIndex, numberOfPoints, pointDimension};
+			}
+
+			StridedSpan<T> positionComponent(const unsigned positionIndex) const {
+				assert(positionIndex < positionDimension);
+				return component(positionIndex);
+			}
+
+			StridedSpan<T> velocityComponent(const unsigned velocityIndex) const {
+				assert(velocityIndex < positionDimension);
+				return component(positionDimension + velocityIndex);
+			}
+
+			StridedSpan<T> controlComponent(const unsigned controlIndex) const {
+				assert(controlIndex < controlDimension);
+				return component(2 * positionDimension + controlIndex);
+			}
+
+			// Offset of an entry in the decision vector, for gradients, Jacobians and Hessians
+			unsigned index(const unsigned timeIndex, const unsigned pointIndex) const {
+				assert(timeIndex < numberOfPoints && pointIndex < pointDimension);
+				return timeIndex * pointDimension + pointIndex;
+			}
+
+			iterator begin() const { return {this, 0}; }
+			iterator end() const { return {this, numberOfPoints}; }
+	};
+
+	using TrajectoryView = BasicTrajectoryView<const double>;
+	using MutableTrajectoryView = BasicTrajectoryView<double>;
+
+	// Instantiated in the compiled library
+	extern template class Span<const double>;
+	extern template class Span<double>;
+	extern template class StridedSpan<const double>;
+	extern template class StridedSpan<double>;
+	extern template class BasicTrajectoryView<const double>;
+	extern template class BasicTrajectoryView<double>;
+}
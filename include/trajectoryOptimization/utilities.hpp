@@ -3,126 +3,63 @@
 #include <vector>
 #include <cassert>
 #include <algorithm>
-#include <fstream>
-#include <sstream>
-#include <range/v3/view.hpp>
+#include <numeric>
+#include <tuple>
+#include "trajectoryView.hpp"
 
 namespace trajectoryOptimization::utilities {
-	using namespace ranges;
+	// first, first + 1, ..., last - 1
+	template<typename Index>
+	std::vector<Index> indexRange(const Index first, const Index last) {
+		std::vector<Index> indices(last > first ? last - first : 0);
+		std::iota(indices.begin(), indices.end(), first);
+		return indices;
+	}
 
 	std::vector<double> createTrajectoryWithIdenticalPoints(unsigned numberOfPoints,
-															const std::vector<double>& singlePoint){
-
-		auto trajectoryDimension = numberOfPoints * singlePoint.size();
-		auto trajectoryWithIdenticalPoints_Range = view::all(singlePoint)
-													| view::cycle
-													| view::take(trajectoryDimension);
-		std::vector<double> trajectoryWithIdenticalPoints
-										= yield_from(trajectoryWithIdenticalPoints_Range);
-		return trajectoryWithIdenticalPoints;
-	}
+															const std::vector<double>& singlePoint);
 
+	// Copies the point; trajectoryView::TrajectoryView reads it in place
 	std::vector<double> getTrajectoryPoint(const double* trajectoryPointer, 
 											const unsigned timeIndex,
-											const unsigned pointDimension) {
-		auto startIndex = trajectoryPointer + timeIndex * pointDimension;
-		std::vector<double> point(pointDimension);
-		std::copy_n(startIndex, pointDimension, std::begin(point));
-		return point;
-	}
+											const unsigned pointDimension);
 
 	std::tuple<std::vector<double>, std::vector<double>, std::vector<double>>
 		getPointPositionVelocityControl(const std::vector<double> point,
 										const unsigned positionDimension,
 										const unsigned velocityDimension,
-										const unsigned controlDimension) {
-			const unsigned pointDimension = positionDimension+velocityDimension+controlDimension;
-			assert (point.size()==pointDimension);
-			std::vector<double> position(positionDimension);
-			std::vector<double> velocity(velocityDimension);
-			std::vector<double> control(controlDimension);
-
-			auto begin =std::begin(point);
-			auto positionBegin = begin;
-			auto velocityBegin = positionBegin+positionDimension;
-			auto controlBegin = velocityBegin+velocityDimension;
-
-			std::copy_n(positionBegin, positionDimension, std::begin(position));
-			std::copy_n(velocityBegin, velocityDimension, std::begin(velocity));
-			std::copy_n(controlBegin, controlDimension, std::begin(control));
-			return {position, velocity, control};
-	}
+										const unsigned controlDimension);
 
+	// Controls are whatever follows position and velocity in a point, pointDimension - 2 * worldDimension
 	void outputPositionVelocityControlToFiles(const double* trajectoryPointer,
 												const unsigned numberOfPoints,
 												const unsigned pointDimension,
 												const unsigned worldDimension,
 												const char* positionFilename,
 												const char* velocityFilename,
-												const char* controlFilename) {
-		std::ofstream positionFile, velocityFile, controlFile;
-		positionFile.open(positionFilename, std::ios::out | std::ios::trunc);
-		velocityFile.open(velocityFilename, std::ios::out | std::ios::trunc);
-		controlFile.open(controlFilename, std::ios::out | std::ios::trunc);
-		for (int timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
-			auto const point = getTrajectoryPoint(trajectoryPointer, timeIndex, pointDimension);
-			auto const [position, velocity, control] = getPointPositionVelocityControl(point,
-																						worldDimension,
-																						worldDimension,
-																						worldDimension);
-			for (int i = 0; i < worldDimension; i++) {
-				positionFile << position[i] << " ";
-				velocityFile << velocity[i] << " ";
-				controlFile << control[i] << " ";
-			}
-			positionFile << std::endl;
-			velocityFile << std::endl;
-			controlFile << std::endl;
-		}
-		positionFile.close();
-		velocityFile.close();
-		controlFile.close();
-	}
+												const char* controlFilename);
 
 	void plotTrajectory(const unsigned worldDimension,
 						const char* positionFilename,
 						const char* velocityFilename,
-						const char* controlFilename) {
-		const char* plotDimensionFormat = "set title 'Position (dim %d)'; \
-											plot '%s' using %d notitle; \
-											set title 'Velocity (dim %d)'; \
-											plot '%s' using %d notitle; \
-											set title 'Control (dim %d)'; \
-											plot '%s' using %d notitle;";
-
-		std::stringstream plotCommand;
-		plotCommand << "gnuplot -e ";
-		plotCommand << "\"set multiplot layout 3, ";
-		plotCommand << worldDimension;
-		plotCommand << " title 'Trajectory' font ',14'; set tmargin 3; set xlabel 'timeIndex';";
+						const char* controlFilename);
 
-		const int plotDimensionMaxLength = 1024;
-		char plotDimension[plotDimensionMaxLength];
-		for (int dim = 1; dim <= worldDimension; dim++) {
-			snprintf(plotDimension,
-						plotDimensionMaxLength,
-						plotDimensionFormat,
-						dim,
-						positionFilename,
-						dim,
-						dim,
-						velocityFilename,
-						dim,
-						dim,
-						controlFilename,
-						dim);
-			plotCommand << plotDimension;
-		}
+	// numberOfPoints evenly spaced knot times from 0 to finalTime
+	std::vector<double> getUniformKnotTimes(const unsigned numberOfPoints, const double finalTime);
 
-		plotCommand << "unset multiplot; \
-						pause -1;\"";
+	// Interval of the increasing knot times that time falls into and the fraction tau of it already
+	// passed; times outside the span are clamped to the first or last interval's end
+	std::tuple<unsigned, double> findInterval(const std::vector<double>& knotTimes, const double time);
 
-		system(plotCommand.str().c_str());
-	}
+	// Point at tau * h into an interval of length h between two points: the first cubicDimension values
+	// follow the cubic Hermite curve with the given slopes at both ends, the rest are linear
+	std::vector<double> interpolateHermitePoint(const double* now,
+												const double* next,
+												const double* nowSlope,
+												const double* nextSlope,
+												const unsigned cubicDimension,
+												const unsigned pointDimension,
+												const double h,
+												const double tau);
 
 }
@@ -0,0 +1,57 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "trajectoryOptimization/telemetry.hpp"
+
+using namespace trajectoryOptimization;
+
+// Follows the telemetry a solve publishes, e.g. the sample's "/trajectoryOptimization" segment.
+// Prints one line per iteration; with --plot it also keeps a gnuplot window up to date.
+int main(int argc, char* argv[])
+{
+  if (argc < 2 || argc > 4) {
+    std::cerr << "usage: " << argv[0] << " <segment name> [--plot [positionDimension]]" << std::endl;
+    return 2;
+  }
+  const bool plot = argc >= 3 && !std::strcmp(argv[2], "--plot");
+  const unsigned positionDimension = argc == 4 ? std::atoi(argv[3]) : 0;
+  const auto pollInterval = std::chrono::milliseconds(100);
+
+  // Wait for the solver to create the segment
+  std::unique_ptr<telemetry::TelemetryReader> reader;
+  while (!reader || !reader->isOpen()) {
+    reader = std::make_unique<telemetry::TelemetryReader>(argv[1]);
+    if (!reader->isOpen()) {
+      std::this_thread::sleep_for(pollInterval);
+    }
+  }
+
+  const auto livePlot = plot ? std::make_unique<telemetry::LivePlot>() : nullptr;
+  std::vector<telemetry::Record> records;
+  std::printf("%6s %14s %10s %10s %10s %10s %10s\n", "iter", "objective", "inf_pr", "inf_du", "lg(mu)", "seconds", "delta");
+  while (true) {
+    const size_t previousSize = records.size();
+    if (reader->poll(records) > 0) {
+      for (size_t index = previousSize; index < records.size(); index++) {
+        const auto& sample = records[index].sample;
+        std::printf("%5d%c %14.7e %10.3e %10.3e %10.2f %10.4f %10.4f\n", sample.iteration, sample.restoration ? 'r' : ' ',
+                    sample.objectiveValue, sample.primalInfeasibility, sample.dualInfeasibility,
+                    sample.mu > 0 ? std::log10(sample.mu) : 0.0, sample.seconds, sample.iterationSeconds);
+      }
+      if (reader->getLost() > 0) {
+        std::printf("(%lu samples lost)\n", (unsigned long) reader->getLost());
+      }
+      std::fflush(stdout);
+      if (livePlot) {
+        livePlot->plot(records, positionDimension);
+      }
+    }
+    std::this_thread::sleep_for(pollInterval);
+  }
+}
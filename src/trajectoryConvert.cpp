@@ -0,0 +1,38 @@
+#include <cstring>
+#include <iostream>
+
+#include "trajectoryOptimization/trajectoryFile.hpp"
+
+using namespace trajectoryOptimization;
+
+// Prints the records of a binary trajectory file as CSV (one line per point) or as text
+int main(int argc, char* argv[])
+{
+  if (argc < 2 || argc > 3 || (argc == 3 && std::strcmp(argv[2], "csv") && std::strcmp(argv[2], "text"))) {
+    std::cerr << "usage: " << argv[0] << " <trajectory file> [csv|text]" << std::endl;
+    return 2;
+  }
+
+  std::ifstream file(argv[1], std::ios::binary);
+  if (!file) {
+    std::cerr << "cannot open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  std::vector<trajectoryFile::TrajectoryRecord> records;
+  trajectoryFile::TrajectoryRecord record;
+  while (trajectoryFile::readRecord(file, record)) {
+    records.push_back(record);
+  }
+  if (!file.eof()) {
+    std::cerr << "malformed record " << records.size() << " in " << argv[1] << std::endl;
+  }
+
+  std::cout.precision(17);
+  if (argc == 3 && !std::strcmp(argv[2], "text")) {
+    trajectoryFile::writeText(std::cout, records);
+  } else {
+    trajectoryFile::writeCsv(std::cout, records);
+  }
+  return file.eof() ? 0 : 1;
+}
@@ -0,0 +1,8 @@
+#include "trajectoryOptimization/arena.hpp"
+
+namespace trajectoryOptimization::arena {
+	Arena& getThreadArena() {
+		thread_local Arena arena;
+		return arena;
+	}
+}
@@ -0,0 +1,80 @@
+#include "trajectoryOptimization/asyncSolve.hpp"
+
+namespace trajectoryOptimization::async {
+	bool isBetterIterate(const Iterate& candidate, const Iterate& incumbent, const Number feasibilityTolerance) {
+		const bool candidateFeasible = candidate.primalInfeasibility <= feasibilityTolerance;
+		const bool incumbentFeasible = incumbent.primalInfeasibility <= feasibilityTolerance;
+		if (candidateFeasible != incumbentFeasible) {
+			return candidateFeasible;
+		}
+		return candidateFeasible ? candidate.objectiveValue < incumbent.objectiveValue :
+									candidate.primalInfeasibility < incumbent.primalInfeasibility;
+	}
+
+	SolveHandle solveAsync(const SmartPtr<IpoptApplication>& app,
+							const SmartPtr<TrajectoryOptimizer>& trajectoryOptimizer,
+							const Clock::time_point deadline,
+							const Number feasibilityTolerance) {
+		const auto state = std::make_shared<detail::SharedState>(deadline, feasibilityTolerance);
+		const IntermediateFunction userIntermediateFunction = trajectoryOptimizer->getIntermediateFunction();
+		// Not a SmartPtr, the optimizer would own a reference to itself
+		TrajectoryOptimizer* const optimizer = GetRawPtr(trajectoryOptimizer);
+
+		optimizer->setIterateTracking(true);
+		optimizer->setIntermediateFunction([state, userIntermediateFunction, optimizer](AlgorithmMode mode, Index iteration,
+																						Number objValue, Number primalInfeasibility,
+																						Number dualInfeasibility, Number mu,
+																						Number stepNorm, Number regularizationSize,
+																						Number dualStepSize, Number primalStepSize,
+																						Index lineSearchTrials, const IpoptData* ipData,
+																						IpoptCalculatedQuantities* ipCalculatedQuantities) {
+			// The restoration phase reports on its own problem
+			if (mode == RegularMode) {
+				Iterate candidate = {iteration, objValue, primalInfeasibility, {}};
+				std::lock_guard<std::mutex> lock(state->mutex);
+				const bool better = !state->bestIterate ||
+									isBetterIterate(candidate, *state->bestIterate, state->feasibilityTolerance);
+				if (better && optimizer->getCurrentIterate(candidate.x)) {
+					state->bestIterate = std::move(candidate);
+				}
+			}
+
+			if (userIntermediateFunction &&
+					!userIntermediateFunction(mode, iteration, objValue, primalInfeasibility, dualInfeasibility, mu, stepNorm,
+												regularizationSize, dualStepSize, primalStepSize, lineSearchTrials, ipData,
+												ipCalculatedQuantities)) {
+				return false;
+			}
+			if (state->cancelRequested) {
+				return false;
+			}
+			if (Clock::now() >= state->deadline) {
+				state->deadlineReached = true;
+				return false;
+			}
+			return true;
+		});
+
+		setHessianApproximation(app, trajectoryOptimizer->getSparsityStructure());
+		auto result = std::async(std::launch::async, [app, trajectoryOptimizer, state, userIntermediateFunction]() {
+			const auto start = Clock::now();
+			const ApplicationReturnStatus status = app->OptimizeTNLP(trajectoryOptimizer);
+			trajectoryOptimizer->setIntermediateFunction(userIntermediateFunction);
+			trajectoryOptimizer->setIterateTracking(false);
+
+			const StopReason stopReason = state->deadlineReached ? DEADLINE_REACHED :
+											state->cancelRequested && status == User_Requested_Stop ? CANCELLED : FINISHED;
+			const std::chrono::duration<double> elapsed = Clock::now() - start;
+			std::lock_guard<std::mutex> lock(state->mutex);
+			return AsyncResult{status, stopReason, trajectoryOptimizer->getSolution(), state->bestIterate, elapsed.count()};
+		});
+		return SolveHandle(state, std::move(result));
+	}
+
+	SolveHandle solveAsync(const SmartPtr<IpoptApplication>& app,
+							const SmartPtr<TrajectoryOptimizer>& trajectoryOptimizer,
+							const Clock::duration budget,
+							const Number feasibilityTolerance) {
+		return solveAsync(app, trajectoryOptimizer, Clock::now() + budget, feasibilityTolerance);
+	}
+}
@@ -0,0 +1,40 @@
+#include "trajectoryOptimization/constraint.hpp"
+
+namespace trajectoryOptimization::constraint {
+	std::vector<ConstraintFunction> applyKinematicViolationConstraints(std::vector<ConstraintFunction> constraints,
+																		const DynamicFunction blockDynamics,
+							                                            const unsigned timePointDimension,
+							                                            const unsigned worldDimension,
+							                                            const unsigned timeIndexStart,
+							                                            const unsigned timeIndexEndExclusive,
+							                                            const double timeStepSize) {
+			for (int timeIndex = timeIndexStart; timeIndex < timeIndexEndExclusive; timeIndex++) {
+			    constraints.push_back(constraint::GetKinematicViolation(blockDynamics,
+			                                                            timePointDimension,
+			                                                            worldDimension,
+			                                                            timeIndex,
+			                                                            timeStepSize));
+			}
+
+			return constraints;
+		}
+
+	std::vector<ConstraintFunction> applyKinematicViolationConstraints(std::vector<ConstraintFunction> constraints,
+																		const DynamicFunction blockDynamics,
+																		const unsigned timePointDimension,
+																		const unsigned worldDimension,
+																		const unsigned timeIndexStart,
+																		const unsigned timeIndexEndExclusive,
+																		const std::vector<double>& timeStepSizes) {
+			assert(timeStepSizes.size() == timeIndexEndExclusive - timeIndexStart);
+			for (unsigned timeIndex = timeIndexStart; timeIndex < timeIndexEndExclusive; timeIndex++) {
+				constraints.push_back(constraint::GetKinematicViolation(blockDynamics,
+																		timePointDimension,
+																		worldDimension,
+																		timeIndex,
+																		timeStepSizes[timeIndex - timeIndexStart]));
+			}
+
+			return constraints;
+		}
+}
@@ -0,0 +1,8 @@
+#include "trajectoryOptimization/cost.hpp"
+
+namespace trajectoryOptimization::cost {
+	template class WeightedCostSum<GetControlSquareSum>;
+	template class WeightedCostSum<GetControlSquareSum, GetControlRateSquareSum>;
+	template class WeightedCostSum<GetControlSquareSum, GetKinematicTrackingSquareSum>;
+	template class WeightedCostSum<GetControlSquareSum, GetControlRateSquareSum, GetKinematicTrackingSquareSum>;
+}
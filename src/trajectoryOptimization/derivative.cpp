@@ -0,0 +1,25 @@
+#include "trajectoryOptimization/derivative.hpp"
+
+namespace trajectoryOptimization::derivative {
+	double calculateH(const double* x, const unsigned partialIndex) {
+		return (x[partialIndex] != 0 ? SQRT_EPSILON * x[partialIndex] : FALLBACK_H_IF_X_ZERO);
+	}
+
+	double calculateDerivative(const double h, const double f2, const double f1) {
+		return (f2 - f1)/(2*h);
+	}
+
+	std::tuple<const std::vector<int>,
+				const std::vector<int>,
+				const VectorToVectorFunction>
+					getSparsityPatternAndJacobianFunctionOfVectorToVectorFunction(const VectorToVectorFunction f,
+																		const unsigned numberVariablesInput) {
+		const auto [jacobianRows, jacobianCols] = GetSparsityPatternOfVectorToVectorFunction(f, numberVariablesInput)();
+		auto getJacobian = GetJacobianOfVectorToVectorFunctionUsingSparsityPattern(f,
+																					numberVariablesInput,
+																					jacobianRows,
+																					jacobianCols);
+
+		return {jacobianRows, jacobianCols, getJacobian};
+	}
+}
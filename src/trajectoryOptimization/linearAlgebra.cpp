@@ -0,0 +1,230 @@
+#include "trajectoryOptimization/linearAlgebra.hpp"
+
+namespace trajectoryOptimization::linearAlgebra {
+	Matrix identity(const unsigned dimension, const double diagonal) {
+		Matrix identityMatrix(dimension, dimension);
+		for (unsigned index = 0; index < dimension; index++) {
+			identityMatrix(index, index) = diagonal;
+		}
+		return identityMatrix;
+	}
+
+	Matrix transpose(const Matrix& A) {
+		Matrix transposed(A.cols(), A.rows());
+		for (unsigned row = 0; row < A.rows(); row++) {
+			for (unsigned col = 0; col < A.cols(); col++) {
+				transposed(col, row) = A(row, col);
+			}
+		}
+		return transposed;
+	}
+
+	Matrix multiply(const Matrix& A, const Matrix& B) {
+		assert(A.cols() == B.rows());
+		Matrix product(A.rows(), B.cols());
+		for (unsigned row = 0; row < A.rows(); row++) {
+			for (unsigned inner = 0; inner < A.cols(); inner++) {
+				const double a = A(row, inner);
+				if (a == 0) {
+					continue;
+				}
+				for (unsigned col = 0; col < B.cols(); col++) {
+					product(row, col) += a * B(inner, col);
+				}
+			}
+		}
+		return product;
+	}
+
+	Matrix multiplyTransposed(const Matrix& A, const Matrix& B) {
+		assert(A.rows() == B.rows());
+		Matrix product(A.cols(), B.cols());
+		for (unsigned inner = 0; inner < A.rows(); inner++) {
+			for (unsigned row = 0; row < A.cols(); row++) {
+				const double a = A(inner, row);
+				if (a == 0) {
+					continue;
+				}
+				for (unsigned col = 0; col < B.cols(); col++) {
+					product(row, col) += a * B(inner, col);
+				}
+			}
+		}
+		return product;
+	}
+
+	std::vector<double> multiply(const Matrix& A, const std::vector<double>& v) {
+		assert(A.cols() == v.size());
+		std::vector<double> product(A.rows());
+		for (unsigned row = 0; row < A.rows(); row++) {
+			for (unsigned col = 0; col < A.cols(); col++) {
+				product[row] += A(row, col) * v[col];
+			}
+		}
+		return product;
+	}
+
+	std::vector<double> multiplyTransposed(const Matrix& A, const std::vector<double>& v) {
+		assert(A.rows() == v.size());
+		std::vector<double> product(A.cols());
+		for (unsigned row = 0; row < A.rows(); row++) {
+			for (unsigned col = 0; col < A.cols(); col++) {
+				product[col] += A(row, col) * v[row];
+			}
+		}
+		return product;
+	}
+
+	Matrix add(const Matrix& A, const Matrix& B, const double scaleB) {
+		assert(A.rows() == B.rows() && A.cols() == B.cols());
+		Matrix sum = A;
+		for (unsigned row = 0; row < A.rows(); row++) {
+			for (unsigned col = 0; col < A.cols(); col++) {
+				sum(row, col) += scaleB * B(row, col);
+			}
+		}
+		return sum;
+	}
+
+	std::vector<double> add(const std::vector<double>& a, const std::vector<double>& b, const double scaleB) {
+		assert(a.size() == b.size());
+		std::vector<double> sum = a;
+		for (unsigned index = 0; index < a.size(); index++) {
+			sum[index] += scaleB * b[index];
+		}
+		return sum;
+	}
+
+	Matrix symmetrize(const Matrix& A) {
+		assert(A.rows() == A.cols());
+		Matrix symmetric = A;
+		for (unsigned row = 0; row < A.rows(); row++) {
+			for (unsigned col = 0; col < row; col++) {
+				const double average = 0.5 * (A(row, col) + A(col, row));
+				symmetric(row, col) = average;
+				symmetric(col, row) = average;
+			}
+		}
+		return symmetric;
+	}
+
+	bool choleskyFactorize(const Matrix& A, Matrix& L) {
+		assert(A.rows() == A.cols());
+		const unsigned dimension = A.rows();
+		L = Matrix(dimension, dimension);
+		for (unsigned col = 0; col < dimension; col++) {
+			double diagonal = A(col, col);
+			for (unsigned inner = 0; inner < col; inner++) {
+				diagonal -= L(col, inner) * L(col, inner);
+			}
+			if (!(diagonal > 0)) {
+				return false;
+			}
+			L(col, col) = std::sqrt(diagonal);
+			for (unsigned row = col + 1; row < dimension; row++) {
+				double value = A(row, col);
+				for (unsigned inner = 0; inner < col; inner++) {
+					value -= L(row, inner) * L(col, inner);
+				}
+				L(row, col) = value / L(col, col);
+			}
+		}
+		return true;
+	}
+
+	std::vector<double> choleskySolve(const Matrix& L, std::vector<double> b) {
+		const unsigned dimension = L.rows();
+		assert(b.size() == dimension);
+		for (unsigned row = 0; row < dimension; row++) {
+			for (unsigned col = 0; col < row; col++) {
+				b[row] -= L(row, col) * b[col];
+			}
+			b[row] /= L(row, row);
+		}
+		for (unsigned row = dimension; row-- > 0;) {
+			for (unsigned col = row + 1; col < dimension; col++) {
+				b[row] -= L(col, row) * b[col];
+			}
+			b[row] /= L(row, row);
+		}
+		return b;
+	}
+
+	Matrix choleskySolve(const Matrix& L, const Matrix& B) {
+		Matrix solution(B.rows(), B.cols());
+		std::vector<double> column(B.rows());
+		for (unsigned col = 0; col < B.cols(); col++) {
+			for (unsigned row = 0; row < B.rows(); row++) {
+				column[row] = B(row, col);
+			}
+			const auto solvedColumn = choleskySolve(L, column);
+			for (unsigned row = 0; row < B.rows(); row++) {
+				solution(row, col) = solvedColumn[row];
+			}
+		}
+		return solution;
+	}
+
+	bool bandedLuFactorize(BandedMatrix& A, std::vector<unsigned>& pivots) {
+		const unsigned dimension = A.dimension();
+		const unsigned lower = A.lowerBandwidth();
+		const unsigned reach = A.lowerBandwidth() + A.upperBandwidth();
+		pivots.resize(dimension);
+
+		for (unsigned col = 0; col < dimension; col++) {
+			const unsigned lastRow = std::min(dimension - 1, col + lower);
+			const unsigned lastCol = std::min(dimension - 1, col + reach);
+
+			unsigned pivotRow = col;
+			for (unsigned row = col + 1; row <= lastRow; row++) {
+				if (std::abs(A(row, col)) > std::abs(A(pivotRow, col))) {
+					pivotRow = row;
+				}
+			}
+			if (!(std::abs(A(pivotRow, col)) > 0)) {
+				return false;
+			}
+			pivots[col] = pivotRow;
+			if (pivotRow != col) {
+				for (unsigned swapCol = col; swapCol <= lastCol; swapCol++) {
+					std::swap(A(col, swapCol), A(pivotRow, swapCol));
+				}
+			}
+
+			const double pivot = A(col, col);
+			for (unsigned row = col + 1; row <= lastRow; row++) {
+				const double multiplier = A(row, col) / pivot;
+				A(row, col) = multiplier;
+				if (multiplier == 0) {
+					continue;
+				}
+				for (unsigned updateCol = col + 1; updateCol <= lastCol; updateCol++) {
+					A(row, updateCol) -= multiplier * A(col, updateCol);
+				}
+			}
+		}
+		return true;
+	}
+
+	void bandedLuSolve(const BandedMatrix& LU, const std::vector<unsigned>& pivots, std::vector<double>& b) {
+		const unsigned dimension = LU.dimension();
+		const unsigned lower = LU.lowerBandwidth();
+		const unsigned reach = LU.lowerBandwidth() + LU.upperBandwidth();
+		assert(b.size() == dimension && pivots.size() == dimension);
+
+		for (unsigned col = 0; col < dimension; col++) {
+			std::swap(b[col], b[pivots[col]]);
+			const unsigned lastRow = std::min(dimension - 1, col + lower);
+			for (unsigned row = col + 1; row <= lastRow; row++) {
+				b[row] -= LU(row, col) * b[col];
+			}
+		}
+		for (unsigned row = dimension; row-- > 0;) {
+			const unsigned lastCol = std::min(dimension - 1, row + reach);
+			for (unsigned col = row + 1; col <= lastCol; col++) {
+				b[row] -= LU(row, col) * b[col];
+			}
+			b[row] /= LU(row, row);
+		}
+	}
+}
@@ -0,0 +1,106 @@
+#include "trajectoryOptimization/linearQuadratic.hpp"
+
+namespace trajectoryOptimization::lq {
+	namespace detail {
+		bool isClose(const double expected, const double actual, const double tolerance) {
+			return std::abs(expected - actual) <= tolerance * std::max(1.0, std::abs(expected));
+		}
+
+		numberVector multiplyLowerTriangle(const indexVector& rows, const indexVector& cols,
+											const numberVector& values, const numberVector& x) {
+			numberVector product(x.size(), 0);
+			for (unsigned entry = 0; entry < values.size(); entry++) {
+				product[rows[entry]] += values[entry] * x[cols[entry]];
+				if (rows[entry] != cols[entry]) {
+					product[cols[entry]] += values[entry] * x[rows[entry]];
+				}
+			}
+			return product;
+		}
+	}
+
+	std::optional<LinearQuadraticProblem> detectLinearQuadratic(const numberVector& xLowerBounds,
+																const numberVector& xUpperBounds,
+																const numberVector& gLowerBounds,
+																const numberVector& gUpperBounds,
+																const EvaluateObjectiveFunction& objectiveFunction,
+																const EvaluateGradientInPlaceFunction& gradientFunction,
+																const EvaluateConstraintInPlaceFunction& constraintFunction,
+																const GetJacobianValueInPlaceFunction& jacobianValueFunction,
+																const indexVector& jacobianRows,
+																const indexVector& jacobianCols,
+																const GetHessianValueInPlaceFunction& objectiveHessianValueFunction,
+																const indexVector& hessianRows,
+																const indexVector& hessianCols,
+																const double tolerance) {
+		const Index n = xLowerBounds.size();
+		const Index m = gLowerBounds.size();
+		const Index numberElementsJacobian = jacobianRows.size();
+		const Index numberElementsHessian = hessianRows.size();
+		for (Index row = 0; row < m; row++) {
+			if (gLowerBounds[row] != gUpperBounds[row]) {
+				return std::nullopt;
+			}
+		}
+
+		const numberVector zeros(n, 0);
+		numberVector probe(n);
+		for (Index index = 0; index < n; index++) {
+			probe[index] = 1 + 0.1 * (index % 7);
+		}
+
+		LinearQuadraticProblem problem = {n, m, hessianRows, hessianCols, numberVector(numberElementsHessian),
+											numberVector(n), objectiveFunction(n, zeros.data()),
+											jacobianRows, jacobianCols, numberVector(numberElementsJacobian),
+											numberVector(m), gLowerBounds, xLowerBounds, xUpperBounds};
+
+		jacobianValueFunction(n, zeros.data(), m, numberElementsJacobian, problem.jacobianValues.data());
+		numberVector probeJacobian(numberElementsJacobian);
+		jacobianValueFunction(n, probe.data(), m, numberElementsJacobian, probeJacobian.data());
+		for (Index entry = 0; entry < numberElementsJacobian; entry++) {
+			if (!detail::isClose(problem.jacobianValues[entry], probeJacobian[entry], tolerance)) {
+				return std::nullopt;
+			}
+		}
+
+		constraintFunction(n, zeros.data(), m, problem.constraintOffsets.data());
+		numberVector probeConstraints(m);
+		constraintFunction(n, probe.data(), m, probeConstraints.data());
+		numberVector predictedConstraints = problem.constraintOffsets;
+		for (Index entry = 0; entry < numberElementsJacobian; entry++) {
+			predictedConstraints[jacobianRows[entry]] += problem.jacobianValues[entry] * probe[jacobianCols[entry]];
+		}
+		for (Index row = 0; row < m; row++) {
+			if (!detail::isClose(predictedConstraints[row], probeConstraints[row], tolerance)) {
+				return std::nullopt;
+			}
+		}
+
+		const numberVector noMultipliers(m, 0);
+		objectiveHessianValueFunction(n, probe.data(), 1, m, noMultipliers.data(),
+										numberElementsHessian, problem.hessianValues.data());
+		gradientFunction(n, zeros.data(), problem.linearCost.data());
+		numberVector probeGradient(n);
+		gradientFunction(n, probe.data(), probeGradient.data());
+		const auto predictedGradient = add(problem.linearCost,
+											detail::multiplyLowerTriangle(hessianRows, hessianCols, problem.hessianValues, probe));
+		for (Index index = 0; index < n; index++) {
+			if (!detail::isClose(predictedGradient[index], probeGradient[index], tolerance)) {
+				return std::nullopt;
+			}
+		}
+
+		return problem;
+	}
+
+	LinearQuadraticSolution solveLinearQuadratic(const LinearQuadraticProblem& problem) {
+		return FactorizeLinearQuadratic(problem)(problem.xLowerBounds);
+	}
+
+	void reportLinearQuadraticSolution(const LinearQuadraticSolution& result, const FinalizerFunction& finalizerFunction) {
+		finalizerFunction(result.status, result.solution.x.size(), result.solution.x.data(),
+							result.solution.zLower.data(), result.solution.zUpper.data(),
+							result.constraints.size(), result.constraints.data(), result.solution.lambda.data(),
+							result.objectiveValue, NULL, NULL);
+	}
+}
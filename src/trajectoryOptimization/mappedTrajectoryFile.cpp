@@ -0,0 +1,30 @@
+#include "trajectoryOptimization/mappedTrajectoryFile.hpp"
+
+namespace trajectoryOptimization::trajectoryFile {
+	numberVector resampleTrajectory(const MappedRecord& record, const std::vector<double>& newKnotTimes) {
+		const unsigned positionDimension = record.header->positionDimension;
+		const unsigned pointDimension = record.getPointDimension();
+		const auto knotTimes = record.getKnotTimes();
+		assert(knotTimes.size() > 1);
+
+		numberVector x;
+		x.reserve(newKnotTimes.size() * pointDimension);
+		for (const double time: newKnotTimes) {
+			const auto [interval, tau] = utilities::findInterval(knotTimes, time);
+			const double h = knotTimes[interval + 1] - knotTimes[interval];
+			const double* now = record.getPoint(interval);
+			const double* next = record.getPoint(interval + 1);
+
+			// Velocities are the positions' slopes
+			const auto point = utilities::interpolateHermitePoint(now, next, now + positionDimension, next + positionDimension,
+																	positionDimension, pointDimension, h, tau);
+			x.insert(x.end(), point.begin(), point.end());
+		}
+		return x;
+	}
+
+	numberVector resampleTrajectory(const MappedRecord& record, const unsigned numberOfPoints) {
+		assert(numberOfPoints > 1);
+		return resampleTrajectory(record, utilities::getUniformKnotTimes(numberOfPoints, record.getKnotTimes().back()));
+	}
+}
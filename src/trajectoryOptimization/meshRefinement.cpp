@@ -0,0 +1,106 @@
+#include "trajectoryOptimization/meshRefinement.hpp"
+
+namespace trajectoryOptimization::mesh {
+	std::vector<double> getTimeStepSizes(const std::vector<double>& knotTimes) {
+		assert(knotTimes.size() > 1);
+		std::vector<double> timeStepSizes(knotTimes.size() - 1);
+		for (unsigned interval = 0; interval < timeStepSizes.size(); interval++) {
+			timeStepSizes[interval] = knotTimes[interval + 1] - knotTimes[interval];
+			assert(timeStepSizes[interval] > 0);
+		}
+		return timeStepSizes;
+	}
+
+	unsigned findKnotIndex(const std::vector<double>& knotTimes, const double time, const double tolerance) {
+		const auto knot = std::lower_bound(knotTimes.begin(), knotTimes.end(), time - tolerance);
+		assert(knot != knotTimes.end() && std::abs(*knot - time) <= tolerance);
+		return knot - knotTimes.begin();
+	}
+	namespace detail {
+		std::vector<double> getStateDerivative(const double* point,
+												const unsigned positionDimension,
+												const unsigned controlDimension,
+												const DynamicFunction& dynamics) {
+			const double* velocity = point + positionDimension;
+			const double* acceleration = dynamics(point, positionDimension, velocity, positionDimension,
+													velocity + positionDimension, controlDimension);
+			std::vector<double> derivative(velocity, velocity + positionDimension);
+			derivative.insert(derivative.end(), acceleration, acceleration + positionDimension);
+			return derivative;
+		}
+	}
+
+	std::vector<double> getIntervalDefects(const numberVector& x,
+											const std::vector<double>& knotTimes,
+											const unsigned positionDimension,
+											const unsigned controlDimension,
+											const DynamicFunction& dynamics) {
+		const unsigned pointDimension = 2 * positionDimension + controlDimension;
+		const unsigned stateDimension = 2 * positionDimension;
+		assert(x.size() == knotTimes.size() * pointDimension);
+
+		std::vector<double> defects(knotTimes.size() - 1);
+		auto nextDerivative = detail::getStateDerivative(x.data(), positionDimension, controlDimension, dynamics);
+		for (unsigned interval = 0; interval < defects.size(); interval++) {
+			const double* now = x.data() + interval * pointDimension;
+			const double* next = now + pointDimension;
+			const double h = knotTimes[interval + 1] - knotTimes[interval];
+			const auto nowDerivative = nextDerivative;
+			nextDerivative = detail::getStateDerivative(next, positionDimension, controlDimension, dynamics);
+
+			const auto midpoint = utilities::interpolateHermitePoint(now, next, nowDerivative.data(), nextDerivative.data(),
+																		stateDimension, pointDimension, h, 0.5);
+			const auto midpointDerivative = detail::getStateDerivative(midpoint.data(), positionDimension,
+																		controlDimension, dynamics);
+			double defect = 0;
+			for (unsigned index = 0; index < stateDimension; index++) {
+				const double interpolantSlope = 1.5 * (next[index] - now[index]) / h
+												- 0.25 * (nowDerivative[index] + nextDerivative[index]);
+				defect = std::max(defect, std::abs(interpolantSlope - midpointDerivative[index]) * h);
+			}
+			defects[interval] = defect;
+		}
+		return defects;
+	}
+
+	std::vector<double> refineKnotTimes(const std::vector<double>& knotTimes,
+										const std::vector<double>& defects,
+										const double defectTolerance) {
+		assert(defects.size() + 1 == knotTimes.size());
+		std::vector<double> refinedKnotTimes = {knotTimes.front()};
+		for (unsigned interval = 0; interval < defects.size(); interval++) {
+			if (defects[interval] > defectTolerance) {
+				refinedKnotTimes.push_back(0.5 * (knotTimes[interval] + knotTimes[interval + 1]));
+			}
+			refinedKnotTimes.push_back(knotTimes[interval + 1]);
+		}
+		return refinedKnotTimes;
+	}
+
+	numberVector interpolateTrajectory(const numberVector& x,
+										const std::vector<double>& knotTimes,
+										const std::vector<double>& newKnotTimes,
+										const unsigned positionDimension,
+										const unsigned controlDimension,
+										const DynamicFunction& dynamics) {
+		const unsigned pointDimension = 2 * positionDimension + controlDimension;
+		assert(x.size() == knotTimes.size() * pointDimension);
+
+		numberVector interpolated;
+		interpolated.reserve(newKnotTimes.size() * pointDimension);
+		for (const double time: newKnotTimes) {
+			assert(time >= knotTimes.front() - 1e-9 && time <= knotTimes.back() + 1e-9);
+			const auto [interval, tau] = utilities::findInterval(knotTimes, time);
+			const double* now = x.data() + interval * pointDimension;
+			const double* next = now + pointDimension;
+			const double h = knotTimes[interval + 1] - knotTimes[interval];
+
+			const auto point = utilities::interpolateHermitePoint(now, next,
+																	detail::getStateDerivative(now, positionDimension, controlDimension, dynamics).data(),
+																	detail::getStateDerivative(next, positionDimension, controlDimension, dynamics).data(),
+																	2 * positionDimension, pointDimension, h, tau);
+			interpolated.insert(interpolated.end(), point.begin(), point.end());
+		}
+		return interpolated;
+	}
+}
@@ -0,0 +1,74 @@
+#include "trajectoryOptimization/modelPredictiveControl.hpp"
+
+namespace trajectoryOptimization::mpc {
+	indexVector getConstraintShiftMap(const unsigned numberConstraints,
+										const unsigned blockStartRow,
+										const unsigned rowsPerPoint,
+										const unsigned numberOfBlocks) {
+		const unsigned blockEndRow = blockStartRow + rowsPerPoint * numberOfBlocks;
+		const unsigned lastBlockStartRow = blockEndRow - rowsPerPoint;
+		assert(blockEndRow <= numberConstraints);
+
+		indexVector shiftMap(numberConstraints);
+		for (unsigned row = 0; row < numberConstraints; row++) {
+			const bool shifts = row >= blockStartRow && row < lastBlockStartRow;
+			shiftMap[row] = shifts ? row + rowsPerPoint : row;
+		}
+		return shiftMap;
+	}
+
+	numberVector shiftPointsByOne(const numberVector& values, const unsigned pointDimension) {
+		if (values.empty()) {
+			return values;
+		}
+		assert(values.size() % pointDimension == 0);
+		assert(values.size() >= pointDimension);
+
+		numberVector shiftedValues(values.size());
+		std::copy(values.begin() + pointDimension, values.end(), shiftedValues.begin());
+		std::copy(values.end() - pointDimension, values.end(), shiftedValues.end() - pointDimension);
+		return shiftedValues;
+	}
+
+	PrimalDualPoint shiftPrimalDualPoint(const PrimalDualPoint& primalDualPoint,
+											const unsigned pointDimension,
+											const indexVector& constraintShiftMap) {
+		numberVector shiftedLambda(constraintShiftMap.size());
+		if (!primalDualPoint.lambda.empty()) {
+			assert(primalDualPoint.lambda.size() == constraintShiftMap.size());
+			std::transform(constraintShiftMap.begin(), constraintShiftMap.end(),
+							shiftedLambda.begin(),
+							[&](const Index sourceRow) { return primalDualPoint.lambda[sourceRow]; });
+		}
+
+		return {shiftPointsByOne(primalDualPoint.x, pointDimension),
+				shiftPointsByOne(primalDualPoint.zLower, pointDimension),
+				shiftPointsByOne(primalDualPoint.zUpper, pointDimension),
+				shiftedLambda};
+	}
+
+	LatencyStatistics getLatencyStatistics(std::vector<double> latencies, const unsigned deadlineMisses) {
+		if (latencies.empty()) {
+			return {0, deadlineMisses, 0, 0, 0, 0, 0, 0};
+		}
+
+		const double last = latencies.back();
+		double sum = 0;
+		for (const auto latency: latencies) {
+			sum += latency;
+		}
+		std::sort(latencies.begin(), latencies.end());
+		const auto percentile = [&latencies](const double fraction) {
+			return latencies[std::min<size_t>(latencies.size() - 1, fraction * latencies.size())];
+		};
+
+		return {(unsigned) latencies.size(),
+				deadlineMisses,
+				last,
+				sum / latencies.size(),
+				latencies.front(),
+				latencies.back(),
+				percentile(0.5),
+				percentile(0.99)};
+	}
+}
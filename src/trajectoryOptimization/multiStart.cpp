@@ -0,0 +1,67 @@
+#include "trajectoryOptimization/multiStart.hpp"
+
+namespace trajectoryOptimization::multistart {
+	numberVector perturbStartingPoint(const numberVector& x,
+										const numberVector& xLowerBounds,
+										const numberVector& xUpperBounds,
+										const double magnitude,
+										const unsigned seed) {
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<double> noise(-1, 1);
+		numberVector perturbed(x.size());
+		for (unsigned index = 0; index < x.size(); index++) {
+			const double scale = magnitude * std::max(1.0, std::abs(x[index]));
+			perturbed[index] = std::clamp(x[index] + scale * noise(generator), xLowerBounds[index], xUpperBounds[index]);
+		}
+		return perturbed;
+	}
+
+	numberVector interpolateStartingPoint(const numberVector& startKinematics,
+											const numberVector& goalKinematics,
+											const unsigned numberOfPoints,
+											const unsigned pointDimension) {
+		assert(startKinematics.size() == goalKinematics.size() && startKinematics.size() <= pointDimension);
+		assert(numberOfPoints > 1);
+		numberVector x(numberOfPoints * pointDimension, 0);
+		for (unsigned timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
+			const double fraction = (double) timeIndex / (numberOfPoints - 1);
+			for (unsigned index = 0; index < startKinematics.size(); index++) {
+				x[timeIndex * pointDimension + index] = (1 - fraction) * startKinematics[index] + fraction * goalKinematics[index];
+			}
+		}
+		return x;
+	}
+
+	numberVector rollOutStartingPoint(const numberVector& startKinematics,
+										const numberVector& controls,
+										const DynamicFunction& dynamics,
+										const unsigned positionDimension,
+										const unsigned controlDimension,
+										const double dt) {
+		const unsigned stateDimension = 2 * positionDimension;
+		const unsigned pointDimension = stateDimension + controlDimension;
+		assert(startKinematics.size() == stateDimension);
+		assert(controls.size() % controlDimension == 0);
+		const unsigned numberOfPoints = controls.size() / controlDimension;
+
+		numberVector x(numberOfPoints * pointDimension);
+		std::copy(startKinematics.begin(), startKinematics.end(), x.begin());
+		for (unsigned timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
+			double* point = x.data() + timeIndex * pointDimension;
+			std::copy(controls.begin() + timeIndex * controlDimension,
+						controls.begin() + (timeIndex + 1) * controlDimension,
+						point + stateDimension);
+			if (timeIndex + 1 == numberOfPoints) {
+				break;
+			}
+			const double* acceleration = dynamics(point, positionDimension, point + positionDimension, positionDimension,
+													point + stateDimension, controlDimension);
+			double* nextPoint = point + pointDimension;
+			for (unsigned index = 0; index < positionDimension; index++) {
+				nextPoint[index] = point[index] + point[positionDimension + index] * dt;
+				nextPoint[positionDimension + index] = point[positionDimension + index] + acceleration[index] * dt;
+			}
+		}
+		return x;
+	}
+}
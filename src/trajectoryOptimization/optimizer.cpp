@@ -0,0 +1,60 @@
+#include "trajectoryOptimization/optimizer.hpp"
+
+namespace trajectoryOptimization::optimizer {
+	EvaluateGradientInPlaceFunction adaptGradientFunction(const EvaluateGradientFunction gradientFunction) {
+		return [gradientFunction](Index n, const Number* x, Number* gradient) {
+			const numberVector gradientValues = gradientFunction(n, x);
+			assert(n == gradientValues.size());
+			std::copy(gradientValues.begin(), gradientValues.end(), gradient);
+		};
+	}
+
+	EvaluateConstraintInPlaceFunction adaptConstraintFunction(const EvaluateConstraintFunction constraintFunction) {
+		return [constraintFunction](Index n, const Number* x, Index m, Number* g) {
+			const numberVector constraintValues = constraintFunction(n, x, m);
+			assert(m == constraintValues.size());
+			std::copy(constraintValues.begin(), constraintValues.end(), g);
+		};
+	}
+
+	GetJacobianValueInPlaceFunction adaptJacobianValueFunction(const GetJacobianValueFunction jacobianValueFunction) {
+		return [jacobianValueFunction](Index n, const Number* x, Index m, Index numberElementsJacobian, Number* values) {
+			const numberVector jacobianValues = jacobianValueFunction(n, x, m, numberElementsJacobian);
+			assert(numberElementsJacobian == jacobianValues.size());
+			std::copy(jacobianValues.begin(), jacobianValues.end(), values);
+		};
+	}
+
+	GetHessianValueInPlaceFunction adaptHessianValueFunction(const GetHessianValueFunction hessianValueFunction) {
+		return [hessianValueFunction](Index n, const Number* x, const Number objFactor, Index m, const Number* lambda,
+										Index numberElementsHessian, Number* values) {
+			const numberVector hessianValues = hessianValueFunction(n, x, objFactor, m, lambda, numberElementsHessian);
+			assert(numberElementsHessian == hessianValues.size());
+			std::copy(hessianValues.begin(), hessianValues.end(), values);
+		};
+	}
+
+	std::shared_ptr<const SparsityStructure> makeSparsityStructure(const indexVector& jacobianRows,
+																	const indexVector& jacobianCols,
+																	const indexVector& hessianRows,
+																	const indexVector& hessianCols) {
+		assert(jacobianRows.size() == jacobianCols.size());
+		assert(hessianRows.size() == hessianCols.size());
+		return std::make_shared<const SparsityStructure>(SparsityStructure{jacobianRows, jacobianCols, hessianRows, hessianCols});
+	}
+
+	void enableWarmStart(const SmartPtr<IpoptApplication>& app, const Number boundPush, const Number muInit) {
+		app->Options()->SetStringValue("warm_start_init_point", "yes");
+		app->Options()->SetNumericValue("warm_start_bound_push", boundPush);
+		app->Options()->SetNumericValue("warm_start_bound_frac", boundPush);
+		app->Options()->SetNumericValue("warm_start_slack_bound_push", boundPush);
+		app->Options()->SetNumericValue("warm_start_slack_bound_frac", boundPush);
+		app->Options()->SetNumericValue("warm_start_mult_bound_push", boundPush);
+		app->Options()->SetNumericValue("mu_init", muInit);
+	}
+
+	void setHessianApproximation(const SmartPtr<IpoptApplication>& app, const SparsityStructure& sparsityStructure) {
+		app->Options()->SetStringValue("hessian_approximation",
+										sparsityStructure.hessianRows.empty() ? "limited-memory" : "exact");
+	}
+}
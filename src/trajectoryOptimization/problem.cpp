@@ -0,0 +1,12 @@
+#include "trajectoryOptimization/problem.hpp"
+
+namespace trajectoryOptimization::problem {
+	template Objective makeObjective(const cost::WeightedCostSum<cost::GetControlSquareSum>);
+	template Objective makeObjective(const cost::WeightedCostSum<cost::GetControlSquareSum,
+																cost::GetControlRateSquareSum>);
+	template Objective makeObjective(const cost::WeightedCostSum<cost::GetControlSquareSum,
+																cost::GetKinematicTrackingSquareSum>);
+	template Objective makeObjective(const cost::WeightedCostSum<cost::GetControlSquareSum,
+																cost::GetControlRateSquareSum,
+																cost::GetKinematicTrackingSquareSum>);
+}
@@ -0,0 +1,113 @@
+#include "trajectoryOptimization/scaling.hpp"
+
+namespace trajectoryOptimization::scaling {
+	numberVector getVariableScalingFromBounds(const numberVector& xLowerBounds, const numberVector& xUpperBounds) {
+		assert(xLowerBounds.size() == xUpperBounds.size());
+		numberVector xScaling(xLowerBounds.size(), 1);
+		for (unsigned index = 0; index < xScaling.size(); index++) {
+			if (xLowerBounds[index] == xUpperBounds[index]) {
+				continue;
+			}
+			double magnitude = 0;
+			if (xLowerBounds[index] > -boundInfinity) {
+				magnitude = std::max(magnitude, std::abs(xLowerBounds[index]));
+			}
+			if (xUpperBounds[index] < boundInfinity) {
+				magnitude = std::max(magnitude, std::abs(xUpperBounds[index]));
+			}
+			if (magnitude > 0) {
+				xScaling[index] = 1 / magnitude;
+			}
+		}
+		return xScaling;
+	}
+
+	numberVector getVariableScalingFromMagnitudes(const unsigned numberOfPoints, const numberVector& pointMagnitudes) {
+		numberVector xScaling(numberOfPoints * pointMagnitudes.size());
+		for (unsigned index = 0; index < xScaling.size(); index++) {
+			const double magnitude = pointMagnitudes[index % pointMagnitudes.size()];
+			assert(magnitude > 0);
+			xScaling[index] = 1 / magnitude;
+		}
+		return xScaling;
+	}
+
+	numberVector getConstraintScalingFromJacobian(const unsigned numberConstraints,
+													const indexVector& jacobianRows,
+													const indexVector& jacobianCols,
+													const numberVector& jacobianValues,
+													const numberVector& xScaling,
+													const Number maxGradient) {
+		numberVector rowMaximum(numberConstraints, 0);
+		for (unsigned entry = 0; entry < jacobianValues.size(); entry++) {
+			const double value = std::abs(jacobianValues[entry] / xScaling[jacobianCols[entry]]);
+			rowMaximum[jacobianRows[entry]] = std::max(rowMaximum[jacobianRows[entry]], value);
+		}
+
+		numberVector gScaling(numberConstraints);
+		std::transform(rowMaximum.begin(), rowMaximum.end(), gScaling.begin(), [maxGradient](const double maximum) {
+			return maximum > maxGradient ? maxGradient / maximum : 1.0;
+		});
+		return gScaling;
+	}
+
+	Number getObjectiveScalingFromGradient(const numberVector& gradient,
+											const numberVector& xScaling,
+											const Number maxGradient) {
+		double maximum = 0;
+		for (unsigned index = 0; index < gradient.size(); index++) {
+			maximum = std::max(maximum, std::abs(gradient[index] / xScaling[index]));
+		}
+		return maximum > maxGradient ? maxGradient / maximum : 1.0;
+	}
+
+	ScalingParameters computeAutomaticScaling(const numberVector& xLowerBounds,
+												const numberVector& xUpperBounds,
+												const numberVector& xStartingPoint,
+												const EvaluateGradientInPlaceFunction& gradientFunction,
+												const GetJacobianValueInPlaceFunction& jacobianValueFunction,
+												const SparsityStructure& sparsityStructure,
+												const unsigned numberConstraints,
+												const numberVector& pointMagnitudes) {
+		const Index n = xStartingPoint.size();
+		const numberVector xScaling = pointMagnitudes.empty() ?
+										getVariableScalingFromBounds(xLowerBounds, xUpperBounds) :
+										getVariableScalingFromMagnitudes(n / pointMagnitudes.size(), pointMagnitudes);
+		assert(xScaling.size() == xStartingPoint.size());
+
+		numberVector jacobianValues(sparsityStructure.jacobianRows.size());
+		jacobianValueFunction(n, xStartingPoint.data(), numberConstraints, jacobianValues.size(), jacobianValues.data());
+		numberVector gradient(n);
+		gradientFunction(n, xStartingPoint.data(), gradient.data());
+
+		return {getObjectiveScalingFromGradient(gradient, xScaling),
+				xScaling,
+				getConstraintScalingFromJacobian(numberConstraints,
+													sparsityStructure.jacobianRows,
+													sparsityStructure.jacobianCols,
+													jacobianValues,
+													xScaling)};
+	}
+
+	std::string describeScaling(const ScalingParameters& scaling) {
+		const auto describeRange = [](const numberVector& factors) {
+			if (factors.empty()) {
+				return std::string("none");
+			}
+			const auto [minimum, maximum] = std::minmax_element(factors.begin(), factors.end());
+			char buffer[64];
+			std::snprintf(buffer, sizeof(buffer), "[%e, %e]", *minimum, *maximum);
+			return std::string(buffer);
+		};
+
+		char objective[32];
+		std::snprintf(objective, sizeof(objective), "%e", scaling.objectiveScaling);
+		return "objective " + std::string(objective)
+				+ ", x " + describeRange(scaling.xScaling)
+				+ ", g " + describeRange(scaling.gScaling);
+	}
+
+	void enableUserScaling(const SmartPtr<IpoptApplication>& app) {
+		app->Options()->SetStringValue("nlp_scaling_method", "user-scaling");
+	}
+}
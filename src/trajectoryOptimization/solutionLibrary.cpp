@@ -0,0 +1,14 @@
+#include "trajectoryOptimization/solutionLibrary.hpp"
+
+namespace trajectoryOptimization::solutionLibrary {
+	numberVector makeKey(const numberVector& start,
+							const numberVector& goal,
+							const std::vector<numberVector>& waypoints) {
+		numberVector key(start);
+		key.insert(key.end(), goal.begin(), goal.end());
+		for (const auto& waypoint: waypoints) {
+			key.insert(key.end(), waypoint.begin(), waypoint.end());
+		}
+		return key;
+	}
+}
@@ -0,0 +1,118 @@
+#include "trajectoryOptimization/sparsity.hpp"
+
+namespace trajectoryOptimization::sparsity {
+	CompressedView compressLines(const unsigned numberLines, const std::vector<int>& lines, const std::vector<int>& indices) {
+		assert(lines.size() == indices.size());
+		CompressedView view = {std::vector<int>(numberLines + 1, 0), std::vector<int>(lines.size()), std::vector<int>(lines.size())};
+		for (const int line: lines) {
+			assert(line >= 0 && line < (int) numberLines);
+			view.offsets[line + 1]++;
+		}
+		std::partial_sum(view.offsets.begin(), view.offsets.end(), view.offsets.begin());
+
+		std::vector<int> next(view.offsets.begin(), view.offsets.end() - 1);
+		for (unsigned entry = 0; entry < lines.size(); entry++) {
+			const int position = next[lines[entry]]++;
+			view.indices[position] = indices[entry];
+			view.entries[position] = entry;
+		}
+		return view;
+	}
+
+	SparsityPattern unite(const SparsityPattern& a, const SparsityPattern& b) {
+		assert(a.getNumberRows() == b.getNumberRows() && a.getNumberCols() == b.getNumberCols());
+		std::vector<int> rows(a.getRows());
+		std::vector<int> cols(a.getCols());
+		rows.insert(rows.end(), b.getRows().begin(), b.getRows().end());
+		cols.insert(cols.end(), b.getCols().begin(), b.getCols().end());
+		return SparsityPattern(a.getNumberRows(), a.getNumberCols(), rows, cols);
+	}
+
+	SparsityPattern unite(const std::vector<SparsityPattern>& patterns) {
+		assert(!patterns.empty());
+		std::size_t numberEntries = 0;
+		for (const auto& pattern: patterns) {
+			assert(pattern.getNumberRows() == patterns[0].getNumberRows() && pattern.getNumberCols() == patterns[0].getNumberCols());
+			numberEntries += pattern.size();
+		}
+		std::vector<int> rows;
+		std::vector<int> cols;
+		rows.reserve(numberEntries);
+		cols.reserve(numberEntries);
+		for (const auto& pattern: patterns) {
+			rows.insert(rows.end(), pattern.getRows().begin(), pattern.getRows().end());
+			cols.insert(cols.end(), pattern.getCols().begin(), pattern.getCols().end());
+		}
+		return SparsityPattern(patterns[0].getNumberRows(), patterns[0].getNumberCols(), rows, cols);
+	}
+
+	std::size_t hashEntries(const std::vector<int>& entryRows, const std::vector<int>& entryCols) {
+		assert(entryRows.size() == entryCols.size());
+		std::size_t hash = std::hash<std::size_t>()(entryRows.size());
+		for (unsigned entry = 0; entry < entryRows.size(); entry++) {
+			hash = combineHash(hash, std::hash<int>()(entryRows[entry]));
+			hash = combineHash(hash, std::hash<int>()(entryCols[entry]));
+		}
+		return hash;
+	}
+
+	std::size_t hashPattern(const SparsityPattern& pattern) {
+		const std::size_t hash = combineHash(std::hash<unsigned>()(pattern.getNumberRows()),
+												std::hash<unsigned>()(pattern.getNumberCols()));
+		return combineHash(hash, hashEntries(pattern.getRows(), pattern.getCols()));
+	}
+
+	SparsityPattern placeBlock(const SparsityPattern& block,
+								const unsigned numberRows,
+								const unsigned numberCols,
+								const unsigned rowOffset,
+								const unsigned colOffset) {
+		assert(rowOffset + block.getNumberRows() <= numberRows && colOffset + block.getNumberCols() <= numberCols);
+		std::vector<int> rows(block.getRows());
+		std::vector<int> cols(block.getCols());
+		for (unsigned entry = 0; entry < rows.size(); entry++) {
+			rows[entry] += rowOffset;
+			cols[entry] += colOffset;
+		}
+		return SparsityPattern(numberRows, numberCols, rows, cols);
+	}
+
+	SparsityPattern getLowerTriangle(const SparsityPattern& symmetric) {
+		assert(symmetric.getNumberRows() == symmetric.getNumberCols());
+		std::vector<int> rows(symmetric.size());
+		std::vector<int> cols(symmetric.size());
+		for (unsigned entry = 0; entry < symmetric.size(); entry++) {
+			rows[entry] = std::max(symmetric.getRows()[entry], symmetric.getCols()[entry]);
+			cols[entry] = std::min(symmetric.getRows()[entry], symmetric.getCols()[entry]);
+		}
+		return SparsityPattern(symmetric.getNumberRows(), symmetric.getNumberCols(), rows, cols);
+	}
+
+	IndexMap getIndexMap(const std::vector<int>& entryRows,
+							const std::vector<int>& entryCols,
+							const SparsityPattern& pattern,
+							const unsigned rowOffset,
+							const unsigned colOffset,
+							const bool lowerTriangle) {
+		assert(entryRows.size() == entryCols.size());
+		IndexMap indexMap(entryRows.size());
+		for (unsigned entry = 0; entry < entryRows.size(); entry++) {
+			int row = entryRows[entry] + rowOffset;
+			int col = entryCols[entry] + colOffset;
+			if (lowerTriangle && row < col) {
+				std::swap(row, col);
+			}
+			indexMap[entry] = pattern.find(row, col);
+			assert(indexMap[entry] >= 0);
+		}
+		return indexMap;
+	}
+
+	IndexMap getIndexMap(const SparsityPattern& block,
+							const SparsityPattern& pattern,
+							const unsigned rowOffset,
+							const unsigned colOffset,
+							const bool lowerTriangle) {
+		return getIndexMap(block.getRows(), block.getCols(), pattern, rowOffset, colOffset, lowerTriangle);
+	}
+}
@@ -0,0 +1,43 @@
+#include "trajectoryOptimization/telemetry.hpp"
+
+namespace trajectoryOptimization::telemetry {
+	IntermediateFunction makeTelemetryFunction(const std::shared_ptr<TelemetryWriter> writer,
+												const SmartPtr<TrajectoryOptimizer>& trajectoryOptimizer,
+												const unsigned pointDimension) {
+		const IntermediateFunction next = trajectoryOptimizer->getIntermediateFunction();
+		// Not a SmartPtr, the optimizer would own a reference to itself
+		TrajectoryOptimizer* const optimizer = GetRawPtr(trajectoryOptimizer);
+		if (writer->getNumberOfStoredPoints() > 0) {
+			optimizer->setIterateTracking(true);
+		}
+		auto start = std::make_shared<Clock::time_point>(Clock::now());
+		auto previous = std::make_shared<Clock::time_point>(*start);
+		auto x = std::make_shared<numberVector>();
+
+		return [writer, next, optimizer, pointDimension, start, previous, x](AlgorithmMode mode, Index iteration,
+																			Number objValue, Number primalInfeasibility,
+																			Number dualInfeasibility, Number mu,
+																			Number stepNorm, Number regularizationSize,
+																			Number dualStepSize, Number primalStepSize,
+																			Index lineSearchTrials, const IpoptData* ipData,
+																			IpoptCalculatedQuantities* ipCalculatedQuantities) {
+			const auto now = Clock::now();
+			if (iteration == 0 && mode == RegularMode) {
+				*start = now;
+				*previous = now;
+			}
+			const Sample sample = {iteration, mode == RestorationPhaseMode, objValue, primalInfeasibility,
+									dualInfeasibility, mu, stepNorm,
+									Seconds(now - *start).count(), Seconds(now - *previous).count(), 0, 0};
+			*previous = now;
+
+			const bool trajectory = writer->getNumberOfStoredPoints() > 0 && mode == RegularMode &&
+									optimizer->getCurrentIterate(*x);
+			writer->publish(sample, trajectory ? x->data() : nullptr, trajectory ? x->size() / pointDimension : 0);
+
+			return !next || next(mode, iteration, objValue, primalInfeasibility, dualInfeasibility, mu, stepNorm,
+									regularizationSize, dualStepSize, primalStepSize, lineSearchTrials, ipData,
+									ipCalculatedQuantities);
+		};
+	}
+}
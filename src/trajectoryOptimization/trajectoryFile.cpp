@@ -0,0 +1,117 @@
+#include "trajectoryOptimization/trajectoryFile.hpp"
+
+namespace trajectoryOptimization::trajectoryFile {
+	bool readRecord(std::istream& stream, TrajectoryRecord& record) {
+		RecordHeader header;
+		if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+			return false;
+		}
+		if (header.magic != magic || header.version != version) {
+			stream.setstate(std::ios::failbit);
+			return false;
+		}
+
+		const auto readDoubles = [&stream](numberVector& values, const size_t count) {
+			values.resize(count);
+			return bool(stream.read(reinterpret_cast<char*>(values.data()), count * sizeof(Number)));
+		};
+		const size_t n = (size_t) header.numberOfPoints * (2 * header.positionDimension + header.controlDimension);
+		record.positionDimension = header.positionDimension;
+		record.controlDimension = header.controlDimension;
+		record.timeStepSize = header.timeStepSize;
+		record.status = (SolverReturn) header.status;
+		record.objectiveValue = header.objectiveValue;
+		record.timeStepSizes.clear();
+		record.solution = {};
+
+		bool complete = readDoubles(record.solution.x, n);
+		if (header.flags & HAS_TIME_STEP_SIZES) {
+			complete = complete && header.numberOfPoints > 0 && readDoubles(record.timeStepSizes, header.numberOfPoints - 1);
+		}
+		if (header.flags & HAS_BOUND_MULTIPLIERS) {
+			complete = complete && readDoubles(record.solution.zLower, n) && readDoubles(record.solution.zUpper, n);
+		}
+		if (header.flags & HAS_CONSTRAINT_MULTIPLIERS) {
+			complete = complete && readDoubles(record.solution.lambda, header.numberConstraints);
+		}
+		return complete;
+	}
+
+	std::vector<TrajectoryRecord> readFile(const std::string& filename) {
+		std::ifstream file(filename, std::ios::binary);
+		std::vector<TrajectoryRecord> records;
+		TrajectoryRecord record;
+		while (readRecord(file, record)) {
+			records.push_back(record);
+		}
+		return records;
+	}
+
+	void writeCsv(std::ostream& stream, const std::vector<TrajectoryRecord>& records) {
+		unsigned maxPositionDimension = 0;
+		unsigned maxControlDimension = 0;
+		for (const auto& record: records) {
+			maxPositionDimension = std::max(maxPositionDimension, record.positionDimension);
+			maxControlDimension = std::max(maxControlDimension, record.controlDimension);
+		}
+		stream << "record,timeIndex,time";
+		for (unsigned index = 0; index < maxPositionDimension; index++) {
+			stream << ",position" << index;
+		}
+		for (unsigned index = 0; index < maxPositionDimension; index++) {
+			stream << ",velocity" << index;
+		}
+		for (unsigned index = 0; index < maxControlDimension; index++) {
+			stream << ",control" << index;
+		}
+		stream << '\n';
+
+		for (unsigned recordIndex = 0; recordIndex < records.size(); recordIndex++) {
+			const auto& record = records[recordIndex];
+			const unsigned pointDimension = record.getPointDimension();
+			double time = 0;
+			for (unsigned timeIndex = 0; timeIndex < record.getNumberOfPoints(); timeIndex++) {
+				const double* point = record.solution.x.data() + timeIndex * pointDimension;
+				stream << recordIndex << ',' << timeIndex << ',' << time;
+				const auto writeBlock = [&stream](const double* values, const unsigned count, const unsigned width) {
+					for (unsigned index = 0; index < width; index++) {
+						stream << ',';
+						if (index < count) {
+							stream << values[index];
+						}
+					}
+				};
+				writeBlock(point, record.positionDimension, maxPositionDimension);
+				writeBlock(point + record.positionDimension, record.positionDimension, maxPositionDimension);
+				writeBlock(point + 2 * record.positionDimension, record.controlDimension, maxControlDimension);
+				stream << '\n';
+				time += record.timeStepSizes.empty() ? record.timeStepSize :
+						timeIndex < record.timeStepSizes.size() ? record.timeStepSizes[timeIndex] : 0;
+			}
+		}
+	}
+
+	void writeText(std::ostream& stream, const std::vector<TrajectoryRecord>& records) {
+		for (unsigned recordIndex = 0; recordIndex < records.size(); recordIndex++) {
+			const auto& record = records[recordIndex];
+			const unsigned pointDimension = record.getPointDimension();
+			stream << "# record " << recordIndex
+					<< "\n# points " << record.getNumberOfPoints()
+					<< " position " << record.positionDimension
+					<< " control " << record.controlDimension
+					<< "\n# timeStepSize " << record.timeStepSize << (record.timeStepSizes.empty() ? "" : " (per interval)")
+					<< "\n# status " << record.status
+					<< " objective " << record.objectiveValue
+					<< " multipliers " << (record.solution.zLower.empty() ? "no" : "bounds")
+					<< ' ' << (record.solution.lambda.empty() ? "no" : "constraints") << '\n';
+			for (unsigned timeIndex = 0; timeIndex < record.getNumberOfPoints(); timeIndex++) {
+				const double* point = record.solution.x.data() + timeIndex * pointDimension;
+				for (unsigned index = 0; index < pointDimension; index++) {
+					stream << (index ? " " : "") << point[index];
+				}
+				stream << '\n';
+			}
+			stream << '\n';
+		}
+	}
+}
@@ -0,0 +1,10 @@
+#include "trajectoryOptimization/trajectoryView.hpp"
+
+namespace trajectoryOptimization::trajectoryView {
+	template class Span<const double>;
+	template class Span<double>;
+	template class StridedSpan<const double>;
+	template class StridedSpan<double>;
+	template class BasicTrajectoryView<const double>;
+	template class BasicTrajectoryView<double>;
+}
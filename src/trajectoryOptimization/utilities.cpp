@@ -0,0 +1,161 @@
+#include "trajectoryOptimization/utilities.hpp"
+#include <fstream>
+#include <sstream>
+#include <range/v3/view.hpp>
+
+namespace trajectoryOptimization::utilities {
+	using namespace ranges;
+
+	std::vector<double> createTrajectoryWithIdenticalPoints(unsigned numberOfPoints,
+															const std::vector<double>& singlePoint) {
+
+		auto trajectoryDimension = numberOfPoints * singlePoint.size();
+		auto trajectoryWithIdenticalPoints_Range = view::all(singlePoint)
+													| view::cycle
+													| view::take(trajectoryDimension);
+		std::vector<double> trajectoryWithIdenticalPoints
+										= yield_from(trajectoryWithIdenticalPoints_Range);
+		return trajectoryWithIdenticalPoints;
+	}
+
+	std::vector<double> getTrajectoryPoint(const double* trajectoryPointer, 
+											const unsigned timeIndex,
+											const unsigned pointDimension) {
+		auto startIndex = trajectoryPointer + timeIndex * pointDimension;
+		std::vector<double> point(pointDimension);
+		std::copy_n(startIndex, pointDimension, std::begin(point));
+		return point;
+	}
+
+	std::tuple<std::vector<double>, std::vector<double>, std::vector<double>>
+		getPointPositionVelocityControl(const std::vector<double> point,
+										const unsigned positionDimension,
+										const unsigned velocityDimension,
+										const unsigned controlDimension) {
+			const unsigned pointDimension = positionDimension+velocityDimension+controlDimension;
+			assert (point.size()==pointDimension);
+			std::vector<double> position(positionDimension);
+			std::vector<double> velocity(velocityDimension);
+			std::vector<double> control(controlDimension);
+
+			auto begin =std::begin(point);
+			auto positionBegin = begin;
+			auto velocityBegin = positionBegin+positionDimension;
+			auto controlBegin = velocityBegin+velocityDimension;
+
+			std::copy_n(positionBegin, positionDimension, std::begin(position));
+			std::copy_n(velocityBegin, velocityDimension, std::begin(velocity));
+			std::copy_n(controlBegin, controlDimension, std::begin(control));
+			return {position, velocity, control};
+	}
+
+	void outputPositionVelocityControlToFiles(const double* trajectoryPointer,
+												const unsigned numberOfPoints,
+												const unsigned pointDimension,
+												const unsigned worldDimension,
+												const char* positionFilename,
+												const char* velocityFilename,
+												const char* controlFilename) {
+		assert(pointDimension >= 2 * worldDimension);
+		const trajectoryView::TrajectoryView trajectory(trajectoryPointer, numberOfPoints, worldDimension,
+														pointDimension - 2 * worldDimension);
+		std::ofstream positionFile(positionFilename, std::ios::out | std::ios::trunc);
+		std::ofstream velocityFile(velocityFilename, std::ios::out | std::ios::trunc);
+		std::ofstream controlFile(controlFilename, std::ios::out | std::ios::trunc);
+
+		const auto writeLine = [](std::ofstream& file, const trajectoryView::Span<const double> values) {
+			for (const double value: values) {
+				file << value << ' ';
+			}
+			file << '\n';
+		};
+		for (const auto knot: trajectory) {
+			writeLine(positionFile, knot.position);
+			writeLine(velocityFile, knot.velocity);
+			writeLine(controlFile, knot.control);
+		}
+	}
+
+	void plotTrajectory(const unsigned worldDimension,
+						const char* positionFilename,
+						const char* velocityFilename,
+						const char* controlFilename) {
+		const char* plotDimensionFormat = "set title 'Position (dim %d)'; \
+											plot '%s' using %d notitle; \
+											set title 'Velocity (dim %d)'; \
+											plot '%s' using %d notitle; \
+											set title 'Control (dim %d)'; \
+											plot '%s' using %d notitle;";
+
+		std::stringstream plotCommand;
+		plotCommand << "gnuplot -e ";
+		plotCommand << "\"set multiplot layout 3, ";
+		plotCommand << worldDimension;
+		plotCommand << " title 'Trajectory' font ',14'; set tmargin 3; set xlabel 'timeIndex';";
+
+		const int plotDimensionMaxLength = 1024;
+		char plotDimension[plotDimensionMaxLength];
+		for (int dim = 1; dim <= worldDimension; dim++) {
+			snprintf(plotDimension,
+						plotDimensionMaxLength,
+						plotDimensionFormat,
+						dim,
+						positionFilename,
+						dim,
+						dim,
+						velocityFilename,
+						dim,
+						dim,
+						controlFilename,
+						dim);
+			plotCommand << plotDimension;
+		}
+
+		plotCommand << "unset multiplot; \
+						pause -1;\"";
+
+		system(plotCommand.str().c_str());
+	}
+
+	std::vector<double> getUniformKnotTimes(const unsigned numberOfPoints, const double finalTime) {
+		assert(numberOfPoints > 1);
+		std::vector<double> knotTimes(numberOfPoints);
+		for (unsigned knot = 0; knot < numberOfPoints; knot++) {
+			knotTimes[knot] = finalTime * knot / (numberOfPoints - 1);
+		}
+		return knotTimes;
+	}
+
+	std::tuple<unsigned, double> findInterval(const std::vector<double>& knotTimes, const double time) {
+		assert(knotTimes.size() > 1);
+		const unsigned upper = std::upper_bound(knotTimes.begin(), knotTimes.end() - 1, time) - knotTimes.begin();
+		const unsigned interval = std::max(upper, 1u) - 1;
+		const double h = knotTimes[interval + 1] - knotTimes[interval];
+		return {interval, std::clamp((time - knotTimes[interval]) / h, 0.0, 1.0)};
+	}
+
+	std::vector<double> interpolateHermitePoint(const double* now,
+												const double* next,
+												const double* nowSlope,
+												const double* nextSlope,
+												const unsigned cubicDimension,
+												const unsigned pointDimension,
+												const double h,
+												const double tau) {
+		const double tau2 = tau * tau;
+		const double tau3 = tau2 * tau;
+		const double h00 = 2 * tau3 - 3 * tau2 + 1;
+		const double h10 = tau3 - 2 * tau2 + tau;
+		const double h01 = -2 * tau3 + 3 * tau2;
+		const double h11 = tau3 - tau2;
+
+		std::vector<double> point(pointDimension);
+		for (unsigned index = 0; index < cubicDimension; index++) {
+			point[index] = h00 * now[index] + h10 * h * nowSlope[index] + h01 * next[index] + h11 * h * nextSlope[index];
+		}
+		for (unsigned index = cubicDimension; index < pointDimension; index++) {
+			point[index] = (1 - tau) * now[index] + tau * next[index];
+		}
+		return point;
+	}
+}
@@ -1,15 +1,22 @@
 #include "coin/IpIpoptApplication.hpp"
 #include "coin/IpSolveStatistics.hpp"
+#include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 #include <functional>
 #include <range/v3/view.hpp>
 
-#include "trajectoryOptimization/constraint.hpp"
 #include "trajectoryOptimization/cost.hpp"
-#include "trajectoryOptimization/derivative.hpp"
 #include "trajectoryOptimization/dynamic.hpp"
+#include "trajectoryOptimization/instrumentation.hpp"
+#include "trajectoryOptimization/linearQuadratic.hpp"
 #include "trajectoryOptimization/optimizer.hpp"
+#include "trajectoryOptimization/problem.hpp"
+#include "trajectoryOptimization/scaling.hpp"
+#include "trajectoryOptimization/telemetry.hpp"
+#include "trajectoryOptimization/trajectoryFile.hpp"
+#include "trajectoryOptimization/trajectoryView.hpp"
 #include "trajectoryOptimization/utilities.hpp"
 
 using namespace Ipopt;
@@ -22,6 +29,11 @@ int main(int argv, char* argc[])
   const char* positionFilename = "position.txt";
   const char* velocityFilename = "velocity.txt";
   const char* controlFilename = "control.txt";
+  const char* instrumentationFilename = "instrumentation.json";
+  // Convert with trajectoryConvert trajectory.traj csv
+  const char* trajectoryFilename = "trajectory.traj";
+  // With --linear-quadratic the problem is solved directly if it is linear-quadratic, without Ipopt
+  const bool solveLinearQuadratic = argv > 1 && !std::strcmp(argc[1], "--linear-quadratic");
 
   const int worldDimension = 3;
   // pos, vel, acc (control)
@@ -29,104 +41,44 @@ int main(int argv, char* argc[])
   const int controlDimension = worldDimension;
   const int timePointDimension = kinematicDimension + controlDimension;
   const int numTimePoints = 50;
-  const int timeStepSize = 1;
+  const double timeStepSize = 1;
 
-  const dynamic::DynamicFunction blockDynamics = dynamic::BlockDynamics;
-
-  const int numberVariablesX = timePointDimension * numTimePoints;
-
-  const int startTimeIndex = 0;
   const numberVector startPoint = {0, 0, 0, 0, 0, 0, 0, 0, 0};
   const int goalTimeIndex = numTimePoints - 1;
   const numberVector goalPoint = {50, 40, 30, 0, 0, 0, 0, 0, 0};
-
-  const numberVector xLowerBounds(numberVariablesX, -100);
-  const numberVector xUpperBounds(numberVariablesX, 100);
-
-  const numberVector xStartingPoint(numberVariablesX, 0);
-
-  const auto costFunction = cost::GetControlSquareSum(numTimePoints, timePointDimension, controlDimension);
-  EvaluateObjectiveFunction objectiveFunction = [costFunction](Index n, const Number* x) {
-    return costFunction(x);
-  };
-
-  const auto costGradientFunction = derivative::GetGradientOfVectorToDoubleFunction(costFunction, numberVariablesX);
-  EvaluateGradientFunction gradientFunction = [costGradientFunction](Index n, const Number* x) {
-    return costGradientFunction(x);
-  };
-
-  std::vector<constraint::ConstraintFunction> constraints;
-
-  constraints.push_back(constraint::GetToKinematicGoalSquare(numTimePoints,
-                                                              timePointDimension,
-                                                              kinematicDimension,
-                                                              startTimeIndex,
-                                                              startPoint));
-
   const unsigned randomTargetTimeIndex = 25;
   const std::vector<double> randomTarget = {-10, 20, 30, 0, 0, 0, -10, 20, 30};
-  constraints.push_back(constraint::GetToKinematicGoalSquare(numTimePoints,
-                                                              timePointDimension,
-                                                              kinematicDimension,
-                                                              randomTargetTimeIndex,
-                                                              randomTarget));
-
-  const unsigned kinematicViolationConstraintStartIndex = 0;
-  const unsigned kinematicViolationConstraintEndIndex = kinematicViolationConstraintStartIndex + numTimePoints - 1;
-  constraints = constraint::applyKinematicViolationConstraints(constraints,
-                                                                blockDynamics,
-                                                                timePointDimension,
-                                                                worldDimension,
-                                                                kinematicViolationConstraintStartIndex,
-                                                                kinematicViolationConstraintEndIndex,
-                                                                timeStepSize);
-                
-  constraints.push_back(constraint::GetToKinematicGoalSquare(numTimePoints,
-                                                                timePointDimension,
-                                                                kinematicDimension,
-                                                                goalTimeIndex,
-                                                                goalPoint));
-
-  const constraint::ConstraintFunction stackedConstraintFunction = constraint::StackConstriants(numberVariablesX, constraints);
-  const unsigned numberConstraintsG = stackedConstraintFunction(xStartingPoint.data()).size();
-  const numberVector gLowerBounds(numberConstraintsG);
-  const numberVector gUpperBounds(numberConstraintsG);
-  EvaluateConstraintFunction constraintFunction = [stackedConstraintFunction](Index n, const Number* x, Index m) {
-    return stackedConstraintFunction(x);
-  };
-
-  indexVector jacStructureRows, jacStructureCols;
-  constraint::ConstraintGradientFunction evaluateJacobianValueFunction;
-  std::tie(jacStructureRows, jacStructureCols, evaluateJacobianValueFunction) =
-      derivative::getSparsityPatternAndJacobianFunctionOfVectorToVectorFunction(stackedConstraintFunction, numberVariablesX);
-
-  const int numberNonzeroJacobian = jacStructureRows.size();
-  GetJacobianValueFunction jacobianValueFunction = [evaluateJacobianValueFunction](Index n, const Number* x, Index m,
-                            Index numberElementsJacobian) {
-    return evaluateJacobianValueFunction(x);
-  };
-
-
-  const int numberNonzeroHessian = 0;
-  indexVector hessianStructureRows;
-  indexVector hessianStructureCols;
-
-  GetHessianValueFunction hessianValueFunction = [](Index n, const Number* x,
-                          const Number objFactor, Index m, const Number* lambda,
-                          Index numberElementsHessian) {
-    numberVector values;
-    return values;
-  };
 
+  const double controlWeight = 1;
+  const auto costFunction = cost::WeightedCostSum(numTimePoints,
+                                                  cost::WeightedCostTerm("control",
+                                                                          controlWeight,
+                                                                          cost::GetControlSquareSum(numTimePoints,
+                                                                                                    timePointDimension,
+                                                                                                    controlDimension)));
+
+  // Block dynamics and goals are linear, so the objective's Hessian is the Hessian of the Lagrangian
+  problem::TrajectoryProblem trajectoryProblem(numTimePoints, worldDimension, controlDimension, timeStepSize,
+                                               dynamic::BlockDynamics);
+  trajectoryProblem.addKinematicGoal(0, kinematicDimension, startPoint)
+                   .addKinematicGoal(randomTargetTimeIndex, kinematicDimension, randomTarget)
+                   .addKinematicGoal(goalTimeIndex, kinematicDimension, goalPoint)
+                   .setObjective(costFunction, true)
+                   .setPointBounds(numberVector(timePointDimension, -100), numberVector(timePointDimension, 100));
+
+  problem::StructureCache structureCache;
+  const auto functions = trajectoryProblem.getFunctions(structureCache);
+  const auto& sparsityStructure = *functions.structure->sparsityStructure;
+
+  trajectoryFile::TrajectoryWriter trajectoryWriter(trajectoryFilename);
   FinalizerFunction finalizerFunction = [&](SolverReturn status, Index n, const Number* x,
                         const Number* zLower, const Number* zUpper,
                         Index m, const Number* g, const Number* lambda,
                         Number objValue, const IpoptData* ipData,
                         IpoptCalculatedQuantities* ipCalculatedQuantities) {
-    printf("\n\nSolution of the primal variables, x\n");
-    for (Index i=0; i<n; i++) {
-      printf("x[%d] = %e\n", i, x[i]); 
-    }
+    trajectoryWriter.write(worldDimension, controlDimension, timeStepSize, nullptr, status,
+                           n, x, zLower, zUpper, m, lambda, objValue);
+    trajectoryWriter.flush();
 
     utilities::outputPositionVelocityControlToFiles(x,
                                                     numTimePoints,
@@ -136,35 +88,80 @@ int main(int argv, char* argc[])
                                                     velocityFilename,
                                                     controlFilename);
 
+    const trajectoryView::TrajectoryView trajectory(x, numTimePoints, worldDimension, controlDimension);
+    const auto finalKnot = trajectory.knot(numTimePoints - 1);
+    printf("\n\nFinal position\n");
+    for (const double position: finalKnot.position) {
+      printf("%e ", position);
+    }
+
     printf("\n\nObjective value\n");
     printf("f(x*) = %e\n", objValue); 
+
+    printf("\n\nObjective terms\n");
+    for (const auto& costTermReport: costFunction.report(x)) {
+      printf("%s: weight %e, value %e, %e s\n", costTermReport.name.c_str(), costTermReport.weight,
+             costTermReport.value, costTermReport.seconds);
+    }
   };
 
-  SmartPtr<TNLP> trajectoryOptimizer = new TrajectoryOptimizer(numberVariablesX,
-                        numberConstraintsG,
-                        numberNonzeroJacobian,
-                        numberNonzeroHessian,
-                        xLowerBounds,
-                        xUpperBounds,
-                        gLowerBounds,
-                        gUpperBounds,
-                        xStartingPoint,
-                        objectiveFunction,
-                        gradientFunction,
-                        constraintFunction,
-                        jacStructureRows,
-                        jacStructureCols,
-                        jacobianValueFunction,
-                        hessianStructureRows,
-                        hessianStructureCols,
-                        hessianValueFunction,
-                        finalizerFunction);
+
+  if (solveLinearQuadratic) {
+    const auto linearQuadraticProblem = lq::detectLinearQuadratic(functions.xLowerBounds,
+                                                                  functions.xUpperBounds,
+                                                                  functions.gLowerBounds,
+                                                                  functions.gUpperBounds,
+                                                                  functions.objectiveFunction,
+                                                                  functions.gradientFunction,
+                                                                  functions.constraintFunction,
+                                                                  functions.jacobianValueFunction,
+                                                                  sparsityStructure.jacobianRows,
+                                                                  sparsityStructure.jacobianCols,
+                                                                  functions.hessianValueFunction,
+                                                                  sparsityStructure.hessianRows,
+                                                                  sparsityStructure.hessianCols);
+    if (linearQuadraticProblem) {
+      const auto linearQuadraticSolution = lq::solveLinearQuadratic(*linearQuadraticProblem);
+      if (linearQuadraticSolution.status == SUCCESS) {
+        std::cout << std::endl << std::endl << "*** Solved as a linear-quadratic problem" << std::endl;
+        lq::reportLinearQuadraticSolution(linearQuadraticSolution, finalizerFunction);
+        utilities::plotTrajectory(worldDimension, positionFilename, velocityFilename, controlFilename);
+        return 0;
+      }
+    }
+    std::cout << std::endl << "*** Not solvable as a linear-quadratic problem, solving with Ipopt" << std::endl;
+  }
+
+  SmartPtr<TrajectoryOptimizer> trajectoryOptimizer = trajectoryProblem.build(finalizerFunction, structureCache);
+
+  // Positions reach the tens, velocities and accelerations stay around one
+  const numberVector pointMagnitudes = {50, 50, 50, 5, 5, 5, 1, 1, 1};
+  const auto scalingParameters = scaling::computeAutomaticScaling(functions.xLowerBounds,
+                                                                  functions.xUpperBounds,
+                                                                  functions.xStartingPoint,
+                                                                  functions.gradientFunction,
+                                                                  functions.jacobianValueFunction,
+                                                                  sparsityStructure,
+                                                                  functions.structure->numberConstraints,
+                                                                  pointMagnitudes);
+  trajectoryOptimizer->setScaling(scalingParameters);
+  std::cout << std::endl << "*** Scaling: " << scaling::describeScaling(scalingParameters) << std::endl;
+
+  const auto solveInstrumentation = std::make_shared<instrumentation::Instrumentation>();
+  trajectoryOptimizer->setInstrumentation(solveInstrumentation);
+
+  // Follow the solve with: telemetryMonitor /trajectoryOptimization --plot 3
+  const auto telemetryWriter = std::make_shared<telemetry::TelemetryWriter>("/trajectoryOptimization", 1024, 32,
+                                                                            timePointDimension);
+  trajectoryOptimizer->setIntermediateFunction(
+    telemetry::makeTelemetryFunction(telemetryWriter, trajectoryOptimizer, timePointDimension));
 
   SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
 
   app->Options()->SetNumericValue("tol", 1e-9);
   app->Options()->SetStringValue("mu_strategy", "adaptive");
-  app->Options()->SetStringValue("hessian_approximation", "limited-memory");
+  scaling::enableUserScaling(app);
+  setHessianApproximation(app, sparsityStructure);
 
   ApplicationReturnStatus status;
   status = app->Initialize();
@@ -181,6 +178,9 @@ int main(int argv, char* argc[])
       final_obj = app->Statistics()->FinalObjective();
       std::cout << std::endl << std::endl << "*** The final value of the objective function is " << final_obj << '.' << std::endl;
     }
+
+    std::ofstream instrumentationFile(instrumentationFilename);
+    solveInstrumentation->toJson(instrumentationFile);
   }
 
   utilities::plotTrajectory(worldDimension, positionFilename, velocityFilename, controlFilename);
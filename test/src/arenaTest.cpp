@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+#include "trajectoryOptimization/arena.hpp"
+#include "trajectoryOptimization/derivative.hpp"
+
+using namespace testing;
+using namespace trajectoryOptimization;
+using namespace trajectoryOptimization::arena;
+
+// Every heap allocation of this test program, the arena's blocks included
+std::atomic<unsigned long> heapAllocations(0);
+
+// The replacements below are the program's global new and delete, so free is always given memory from
+// malloc. GCC still takes new for the builtin one once it inlines delete into a caller and warns.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+// Before GCC 11 there is no such warning
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+	heapAllocations++;
+	if (void* memory = std::malloc(size ? size : 1)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+TEST(arenaTest, AlignsAndCountsAllocations) {
+	Arena arena(1024);
+	const char* byte = arena.allocate<char>(1);
+	const double* values = arena.allocate<double>(3);
+	EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(values) % alignof(double));
+	EXPECT_GT((const void*) values, (const void*) byte);
+
+	const auto& statistics = arena.getStatistics();
+	EXPECT_EQ(2u, statistics.allocations);
+	EXPECT_EQ(1u + 3 * sizeof(double), statistics.bytesAllocated);
+	EXPECT_EQ(1u, statistics.blockAllocations);
+}
+
+TEST(arenaTest, ScopesReleaseOnlyTheirOwnAllocations) {
+	Arena arena(1024);
+	ArenaScope outer(arena);
+	double* kept = outer.allocate<double>(2);
+	kept[0] = 1;
+	kept[1] = 2;
+	double* released;
+	{
+		ArenaScope inner(arena);
+		released = inner.allocate<double>(4);
+	}
+	EXPECT_EQ(released, arena.allocate<double>(4));
+	EXPECT_THAT(std::vector<double>(kept, kept + 2), ElementsAre(1, 2));
+	EXPECT_EQ(1u, arena.getStatistics().releases);
+}
+
+TEST(arenaTest, MergesBlocksSoTheNextRoundNeedsNoHeap) {
+	Arena arena(64);
+	for (unsigned allocation = 0; allocation < 4; allocation++) {
+		arena.allocate<double>(6);
+	}
+	EXPECT_GT(arena.getStatistics().blockAllocations, 1u);
+	arena.reset();
+	const std::size_t capacity = arena.capacity();
+
+	arena.resetStatistics();
+	for (unsigned allocation = 0; allocation < 4; allocation++) {
+		arena.allocate<double>(6);
+	}
+	arena.reset();
+	EXPECT_EQ(0u, arena.getStatistics().blockAllocations);
+	EXPECT_EQ(capacity, arena.capacity());
+	EXPECT_EQ(4 * 6 * sizeof(double), arena.getStatistics().peakBytes);
+}
+
+TEST(arenaTest, EveryThreadHasItsOwnArena) {
+	const Arena* mainArena = &getThreadArena();
+	const Arena* otherArena = nullptr;
+	std::thread thread([&]() { otherArena = &getThreadArena(); });
+	thread.join();
+	EXPECT_NE(mainArena, otherArena);
+	EXPECT_EQ(mainArena, &getThreadArena());
+}
+
+TEST(arenaTest, RepeatedJacobianOnlyAllocatesFunctionValues) {
+	const derivative::VectorToVectorFunction f = [](const double* x) {
+		return std::vector<double>{x[0] * x[1], x[2] * x[2]};
+	};
+	const derivative::GetJacobianOfVectorToVectorFunctionUsingSparsityPattern getJacobian(f, 3, {0, 0, 1}, {0, 1, 2});
+	const std::vector<double> x = {1, 2, 3};
+	std::vector<double> jacobian(3);
+
+	Arena& arena = getThreadArena();
+	getJacobian(x.data(), jacobian.data());
+	arena.resetStatistics();
+	const unsigned long heapAllocationsBefore = heapAllocations;
+	getJacobian(x.data(), jacobian.data());
+	const unsigned long jacobianHeapAllocations = heapAllocations - heapAllocationsBefore;
+
+	// The vectors f returns at x - h and x + h for each of the three columns, nothing else
+	EXPECT_EQ(6u, jacobianHeapAllocations);
+	EXPECT_EQ(0u, arena.getStatistics().blockAllocations);
+	EXPECT_EQ(1u, arena.getStatistics().allocations);
+	EXPECT_NEAR(2, jacobian[0], 1e-6);
+	EXPECT_NEAR(1, jacobian[1], 1e-6);
+	EXPECT_NEAR(6, jacobian[2], 1e-6);
+}
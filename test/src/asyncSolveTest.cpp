@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cmath>
+#include <future>
+#include "trajectoryOptimization/asyncSolve.hpp"
+
+using namespace trajectoryOptimization::async;
+using namespace testing;
+
+class asyncSolveTest : public::testing::Test {
+	protected:
+		SmartPtr<IpoptApplication> app;
+
+		void SetUp() {
+			app = IpoptApplicationFactory();
+			app->Options()->SetNumericValue("tol", 1e-9);
+			app->Options()->SetIntegerValue("print_level", 0);
+			ASSERT_EQ(Solve_Succeeded, app->Initialize());
+		}
+
+		// (x0 - 3)^4 + (x1 - 3)^2 subject to x0 + x1 = 2, from far away
+		SmartPtr<TrajectoryOptimizer> createOptimizer() {
+			return new TrajectoryOptimizer(numberVector{-100, -100},
+											numberVector{100, 100},
+											numberVector{2},
+											numberVector{2},
+											numberVector{50, -50},
+											[](Index n, const Number* x) { return std::pow(x[0] - 3, 4) + std::pow(x[1] - 3, 2); },
+											[](Index n, const Number* x) {
+												return numberVector{4 * std::pow(x[0] - 3, 3), 2 * (x[1] - 3)};
+											},
+											[](Index n, const Number* x, Index m) { return numberVector{x[0] + x[1]}; },
+											[](Index n, const Number* x, Index m, Index numberElementsJacobian) {
+												return numberVector{1, 1};
+											},
+											[](Index n, const Number* x, Number objFactor, Index m, const Number* lambda,
+												Index numberElementsHessian) {
+												return numberVector{12 * objFactor * std::pow(x[0] - 3, 2), 2 * objFactor};
+											},
+											[](SolverReturn status, Index n, const Number* x, const Number* zLower,
+												const Number* zUpper, Index m, const Number* g, const Number* lambda,
+												Number objValue, const IpoptData* ipData,
+												IpoptCalculatedQuantities* ipCalculatedQuantities) {},
+											makeSparsityStructure({0, 0}, {0, 1}, {0, 1}, {0, 1}));
+		}
+};
+
+TEST(iterateOrderTest, FeasibleBeatsInfeasible) {
+	const Iterate feasible = {1, 10, 1e-9, {}};
+	const Iterate feasibleLower = {2, 5, 1e-8, {}};
+	const Iterate infeasible = {3, 1, 1e-2, {}};
+	const Iterate lessInfeasible = {4, 100, 1e-3, {}};
+
+	EXPECT_TRUE(isBetterIterate(feasible, infeasible, 1e-6));
+	EXPECT_FALSE(isBetterIterate(infeasible, feasible, 1e-6));
+	EXPECT_TRUE(isBetterIterate(feasibleLower, feasible, 1e-6));
+	EXPECT_TRUE(isBetterIterate(lessInfeasible, infeasible, 1e-6));
+	EXPECT_FALSE(isBetterIterate(infeasible, lessInfeasible, 1e-6));
+}
+
+TEST_F(asyncSolveTest, FinishesWithoutDeadline) {
+	const auto trajectoryOptimizer = createOptimizer();
+	auto handle = solveAsync(app, trajectoryOptimizer);
+	const auto result = handle.get();
+
+	EXPECT_EQ(Solve_Succeeded, result.status);
+	EXPECT_EQ(FINISHED, result.stopReason);
+	ASSERT_TRUE(result.bestIterate.has_value());
+	EXPECT_NEAR(0, result.bestIterate->primalInfeasibility, 1e-6);
+	EXPECT_NEAR(2, result.solution.x[0] + result.solution.x[1], 1e-8);
+}
+
+TEST_F(asyncSolveTest, StopsAtDeadlineWithBestIterate) {
+	const auto trajectoryOptimizer = createOptimizer();
+	auto handle = solveAsync(app, trajectoryOptimizer, Clock::now());
+	const auto result = handle.get();
+
+	EXPECT_EQ(User_Requested_Stop, result.status);
+	EXPECT_EQ(DEADLINE_REACHED, result.stopReason);
+	ASSERT_TRUE(result.bestIterate.has_value());
+	EXPECT_EQ(2u, result.bestIterate->x.size());
+}
+
+TEST_F(asyncSolveTest, CancelStopsAtNextIteration) {
+	std::promise<void> firstIteration;
+	std::promise<void> cancelled;
+	auto cancelledFuture = cancelled.get_future().share();
+	const auto trajectoryOptimizer = createOptimizer();
+	trajectoryOptimizer->setIntermediateFunction([&firstIteration, cancelledFuture](AlgorithmMode mode, Index iteration,
+																					Number objValue, Number primalInfeasibility,
+																					Number dualInfeasibility, Number mu,
+																					Number stepNorm, Number regularizationSize,
+																					Number dualStepSize, Number primalStepSize,
+																					Index lineSearchTrials, const IpoptData* ipData,
+																					IpoptCalculatedQuantities* ipCalculatedQuantities) {
+		if (iteration == 0) {
+			firstIteration.set_value();
+			cancelledFuture.wait();
+		}
+		return true;
+	});
+
+	auto handle = solveAsync(app, trajectoryOptimizer);
+	ASSERT_EQ(std::future_status::ready, firstIteration.get_future().wait_for(std::chrono::seconds(10)));
+	EXPECT_FALSE(handle.isFinished());
+	EXPECT_TRUE(handle.getBestIterate().has_value());
+	handle.cancel();
+	cancelled.set_value();
+	const auto result = handle.get();
+
+	EXPECT_EQ(User_Requested_Stop, result.status);
+	EXPECT_EQ(CANCELLED, result.stopReason);
+	EXPECT_EQ(0, result.bestIterate->iteration);
+	EXPECT_TRUE(trajectoryOptimizer->getIntermediateFunction() != nullptr);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h> 
+#include <gmock/gmock.h>
+#include <cmath>
+#include "trajectoryOptimization/batch.hpp"
+
+using namespace trajectoryOptimization::batch;
+using namespace testing;
+
+class batchTest : public::testing::Test {
+	protected:
+		const std::shared_ptr<const SparsityStructure> sparsityStructure = makeSparsityStructure({0, 0}, {0, 1}, {0, 1}, {0, 1});
+		// Several workers only where the linear solver allows concurrent solves
+		const unsigned numberOfWorkers = MUMPS_IS_THREAD_SAFE ? 3 : 1;
+		const ConfigureApplicationFunction configureApplication = [](const SmartPtr<IpoptApplication>& app) {
+			app->Options()->SetStringValue("linear_solver", "mumps");
+			app->Options()->SetNumericValue("tol", 1e-9);
+			app->Options()->SetIntegerValue("print_level", 0);
+		};
+
+		// (x0 - goal)^2 + (x1 - goal)^2 subject to x0 + x1 = 2
+		BatchProblem createProblem(const double goal) {
+			EvaluateObjectiveFunction objectiveFunction = [goal](Index n, const Number* x) {
+				return std::pow(x[0] - goal, 2) + std::pow(x[1] - goal, 2);
+			};
+			EvaluateGradientFunction gradientFunction = [goal](Index n, const Number* x) {
+				numberVector gradient = {2 * (x[0] - goal), 2 * (x[1] - goal)};
+				return gradient;
+			};
+			EvaluateConstraintFunction constraintFunction = [](Index n, const Number* x, Index m) {
+				numberVector g = {x[0] + x[1]};
+				return g;
+			};
+			GetJacobianValueFunction jacobianValueFunction = [](Index n, const Number* x, Index m,
+																Index numberElementsJacobian) {
+				numberVector values = {1, 1};
+				return values;
+			};
+			GetHessianValueFunction hessianValueFunction = [](Index n, const Number* x,
+															Number objFactor, Index m, const Number* lambda,
+															Index numberElementsHessian) {
+				numberVector values = {2 * objFactor, 2 * objFactor};
+				return values;
+			};
+
+			return {{-10, -10}, {10, 10}, {2}, {2}, {0, 0},
+					objectiveFunction, gradientFunction, constraintFunction,
+					jacobianValueFunction, hessianValueFunction,
+					sparsityStructure};
+		}
+};
+
+TEST_F(batchTest, SolvesEveryProblemInOrder) {
+	std::vector<BatchProblem> problems;
+	const std::vector<double> goals = {0, 1, 2, 3, 4, 5, 6, 7};
+	for (const auto goal: goals) {
+		problems.push_back(createProblem(goal));
+	}
+
+	const auto results = SolveBatch(numberOfWorkers, configureApplication)(problems);
+
+	ASSERT_EQ(goals.size(), results.size());
+	for (unsigned problemIndex = 0; problemIndex < goals.size(); problemIndex++) {
+		const auto& result = results[problemIndex];
+		EXPECT_EQ(Solve_Succeeded, result.status);
+		EXPECT_EQ(SUCCESS, result.solverStatus);
+		EXPECT_NEAR(2 * std::pow(1 - goals[problemIndex], 2), result.objectiveValue, 1e-6);
+		ASSERT_EQ(2, result.solution.x.size());
+		EXPECT_NEAR(1, result.solution.x[0], 1e-6);
+		EXPECT_GE(result.seconds, 0);
+	}
+}
+
+TEST_F(batchTest, EmptyBatchHasNoResults) {
+	const auto results = SolveBatch(4, configureApplication)({});
+	EXPECT_TRUE(results.empty());
+}
@@ -94,6 +94,36 @@ TEST_F(kinematicGoalConstraintTest, twoKinematicGoalConstraints){
 							ElementsAre(1, 4, 9, 16, 9, 16, 25, 36));
 }
 
+TEST_F(kinematicGoalConstraintTest, linearGoalIsSignedDifference){
+	const unsigned goalTimeIndex = 1; 
+	std::vector<double> kinematicGoal = {{-1, -1, -1, -1}};
+	auto getToKinematicGoal =
+		GetToKinematicGoal(numberOfPoints,
+							pointDimension,
+							kinematicDimension,
+							goalTimeIndex,
+							kinematicGoal);
+
+	auto toGoal = getToKinematicGoal(trajectory.data());
+	EXPECT_THAT(toGoal, ElementsAre(3, 4, 5, 6));
+}
+
+TEST_F(kinematicGoalConstraintTest, twoKinematicGoalConstraintsStackedInPlace){
+	std::vector<double> kinematicGoalOne = {{1, 2, 3, 4}};
+	std::vector<double> kinematicGoalTwo = {{-1, -1, -1, -1}};
+
+	std::vector<ConstraintFunction> twoGoalConstraintFunctions =
+		{GetToKinematicGoalSquare(numberOfPoints, pointDimension, kinematicDimension, 0, kinematicGoalOne),
+		 GetToKinematicGoalSquare(numberOfPoints, pointDimension, kinematicDimension, 1, kinematicGoalTwo)};
+	auto stackConstriants = StackConstriants(trajectory.size(), twoGoalConstraintFunctions);
+
+	std::vector<double> squaredDistanceToTwoGoals(stackConstriants.size());
+	stackConstriants(trajectory.data(), squaredDistanceToTwoGoals.data());
+
+	EXPECT_THAT(squaredDistanceToTwoGoals,
+							ElementsAre(1, 4, 9, 16, 9, 16, 25, 36));
+}
+
 class blockDynamic:public::Test{
 	protected:
 		const unsigned numberOfPoints = 3;    
@@ -184,6 +214,23 @@ TEST_F(blockDynamic, twoTimeStepsViolationUsingApplyFunction){
 }
 
 
+TEST_F(blockDynamic, twoTimeStepsViolationWithPerIntervalStepSizes){
+	std::vector<ConstraintFunction> twoStepConstraintFunctions;
+	twoStepConstraintFunctions = applyKinematicViolationConstraints(twoStepConstraintFunctions,
+																	BlockDynamics,
+																	pointDimension,
+																	positionDimension,
+																	0,
+																	numberOfPoints - 1,
+																	std::vector<double>{dt, 2 * dt});
+
+	auto getStackConstriants = StackConstriants(trajectory.size(), twoStepConstraintFunctions);
+	auto twoStepKinematicViolations = getStackConstriants(trajectoryPtr);
+
+	EXPECT_THAT(twoStepKinematicViolations,
+							ElementsAre(-0.125, -0.25, -0.25, -0.5, -3, -4.5, -1.5, -3.5));
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -1,11 +1,15 @@
 #include <array>
 #include <cassert>
 #include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <range/v3/view.hpp>
 #include "trajectoryOptimization/cost.hpp"
+#include "trajectoryOptimization/derivative.hpp"
 #include "trajectoryOptimization/utilities.hpp"
 
 using namespace trajectoryOptimization::cost;
 using namespace trajectoryOptimization::utilities;
+using namespace trajectoryOptimization::derivative;
 
 TEST(costTest, controlSquare_isZero_whenControlsAreAllZero) { 
 	const unsigned numberOfPoints = 3;
@@ -83,7 +87,133 @@ TEST(costTest, controlSquareIs24WhenControlsAreThreeTwoTwo) {
 													controlDimension);
 	EXPECT_EQ(24, getControlSquareSum(trajectoryWithControlTwoTwo_ptr));
 }
- 
+
+TEST(costTest, controlRateSquareIsEightWhenControlsAreZeroTwoZero) {
+	const unsigned numberOfPoints = 3;
+	const unsigned pointDimension = 3;
+	const unsigned controlDimension = 1;
+	const std::vector<double> trajectory = {0, 0, 0,
+											0, 0, 2,
+											0, 0, 0};
+
+	auto getControlRateSquareSum = GetControlRateSquareSum(numberOfPoints,
+															pointDimension,
+															controlDimension);
+	EXPECT_EQ(8, getControlRateSquareSum(trajectory.data()));
+}
+
+TEST(costTest, toKinematicGoalSquareSumCountsEveryPoint) {
+	const unsigned numberOfPoints = 2;
+	const unsigned pointDimension = 3;
+	const unsigned kinematicDimension = 2;
+	const std::vector<double> kinematicGoal = {1, 1};
+	const std::vector<double> trajectory = {0, 1, 5,
+											1, 3, 5};
+
+	auto getToKinematicGoalSquareSum = GetToKinematicGoalSquareSum(numberOfPoints,
+																	pointDimension,
+																	kinematicDimension,
+																	kinematicGoal);
+	EXPECT_EQ(5, getToKinematicGoalSquareSum(trajectory.data()));
+}
+
+TEST(costTest, controlSquareFootprintIsControlIndices) {
+	const unsigned numberOfPoints = 3;
+	const unsigned pointDimension = 4;
+	const unsigned controlDimension = 2;
+
+	auto getControlSquareSum = GetControlSquareSum(numberOfPoints,
+													pointDimension,
+													controlDimension);
+	EXPECT_THAT(getControlSquareSum.footprint(), testing::ElementsAre(2, 3, 6, 7, 10, 11));
+}
+
+class weightedCostSumTest : public::testing::Test {
+	protected:
+		const unsigned numberOfPoints = 3;
+		const unsigned pointDimension = 3;
+		const unsigned controlDimension = 1;
+		const unsigned kinematicDimension = 2;
+		const unsigned numberVariables = numberOfPoints * pointDimension;
+		const std::vector<double> referenceKinematics = {0, 0, 1, 1, 2, 2};
+		const std::vector<double> trajectory = {0, 1, 1,
+												1, 1, -2,
+												3, 2, 0.5};
+		const double effortWeight = 2;
+		const double rateWeight = 0.5;
+		const double trackingWeight = 3;
+
+		const GetControlSquareSum getControlSquareSum = GetControlSquareSum(numberOfPoints, pointDimension, controlDimension);
+		const GetControlRateSquareSum getControlRateSquareSum = GetControlRateSquareSum(numberOfPoints, pointDimension, controlDimension);
+		const GetKinematicTrackingSquareSum getTrackingSquareSum = GetKinematicTrackingSquareSum(numberOfPoints,
+																									pointDimension,
+																									kinematicDimension,
+																									referenceKinematics);
+		const WeightedCostSum<GetControlSquareSum, GetControlRateSquareSum, GetKinematicTrackingSquareSum> costSum =
+			WeightedCostSum(numberOfPoints,
+							WeightedCostTerm("effort", effortWeight, getControlSquareSum),
+							WeightedCostTerm("smoothness", rateWeight, getControlRateSquareSum),
+							WeightedCostTerm("tracking", trackingWeight, getTrackingSquareSum));
+};
+
+TEST_F(weightedCostSumTest, valueIsWeightedSumOfTerms) {
+	const double expectedCost = effortWeight * getControlSquareSum(trajectory.data())
+								+ rateWeight * getControlRateSquareSum(trajectory.data())
+								+ trackingWeight * getTrackingSquareSum(trajectory.data());
+	EXPECT_DOUBLE_EQ(expectedCost, costSum(trajectory.data()));
+}
+
+TEST_F(weightedCostSumTest, gradientMatchesNumericalGradient) {
+	const auto getNumericalGradient = GetGradientOfVectorToDoubleFunction(costSum, numberVariables);
+	const auto numericalGradient = getNumericalGradient(trajectory.data());
+	const auto gradient = costSum.gradient(trajectory.data(), numberVariables);
+
+	ASSERT_EQ(numberVariables, gradient.size());
+	for (unsigned index = 0; index < numberVariables; index++) {
+		EXPECT_NEAR(numericalGradient[index], gradient[index], 1e-6);
+	}
+}
+
+TEST_F(weightedCostSumTest, footprintGradientMatchesFullGradient) {
+	// Only the controls, the last entry of every point
+	const auto controlCostSum = WeightedCostSum(numberOfPoints,
+												WeightedCostTerm("effort", effortWeight, getControlSquareSum),
+												WeightedCostTerm("smoothness", rateWeight, getControlRateSquareSum));
+	const auto getFullGradient = GetGradientOfVectorToDoubleFunction(controlCostSum, numberVariables);
+	const auto getFootprintGradient = GetGradientOfVectorToDoubleFunction(controlCostSum, numberVariables,
+																			controlCostSum.footprint());
+
+	EXPECT_THAT(controlCostSum.footprint(), testing::ElementsAre(2, 5, 8));
+	EXPECT_THAT(getFootprintGradient(trajectory.data()), testing::ContainerEq(getFullGradient(trajectory.data())));
+	EXPECT_THAT(getFootprintGradient(trajectory.data()), testing::ElementsAre(0, 0, testing::Ne(0),
+																				0, 0, testing::Ne(0),
+																				0, 0, testing::Ne(0)));
+}
+
+TEST_F(weightedCostSumTest, hessianSharesOneLowerTriangularPattern) {
+	const auto& hessianRows = costSum.getHessianRows();
+	const auto& hessianCols = costSum.getHessianCols();
+	const auto hessian = costSum.hessian(1);
+
+	// controls sit at 2, 5, 8; tracked kinematics at 0, 1, 3, 4, 6, 7
+	EXPECT_THAT(hessianRows, testing::ElementsAre(0, 1, 2, 3, 4, 5, 5, 6, 7, 8, 8));
+	EXPECT_THAT(hessianCols, testing::ElementsAre(0, 1, 2, 3, 4, 2, 5, 6, 7, 5, 8));
+	EXPECT_THAT(hessian, testing::ElementsAre(6, 6, 5, 6, 6, -1, 6, 6, 6, -1, 5));
+}
+
+TEST_F(weightedCostSumTest, reportsEveryTerm) {
+	const auto costTermReports = costSum.report(trajectory.data());
+
+	ASSERT_EQ(3, costTermReports.size());
+	EXPECT_EQ("effort", costTermReports[0].name);
+	EXPECT_EQ("smoothness", costTermReports[1].name);
+	EXPECT_EQ("tracking", costTermReports[2].name);
+	EXPECT_DOUBLE_EQ(effortWeight * getControlSquareSum(trajectory.data()), costTermReports[0].value);
+	EXPECT_DOUBLE_EQ(rateWeight * getControlRateSquareSum(trajectory.data()), costTermReports[1].value);
+	EXPECT_DOUBLE_EQ(trackingWeight * getTrackingSquareSum(trajectory.data()), costTermReports[2].value);
+	EXPECT_GE(costTermReports[0].seconds, 0);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
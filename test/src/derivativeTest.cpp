@@ -52,6 +52,20 @@ TEST_F(derivativeTest, gradientOfVectorToDoubleFunction) {
 	EXPECT_THAT(gradient, testing::ElementsAre(1 + x[1], 2 + x[0], 6 * x[2], 0));
 }
 
+TEST_F(derivativeTest, gradientOfVectorToDoubleFunctionOnlyEvaluatesFootprint) {
+	unsigned numberOfEvaluations = 0;
+	const VectorToDoubleFunction countingFn = [&](const double* x) {
+		numberOfEvaluations++;
+		return vectorToDoubleFn(x);
+	};
+	const std::vector<int> footprint = {0, 2};
+
+	auto getGradient = GetGradientOfVectorToDoubleFunction(countingFn, numberVariables, footprint);
+	std::vector<double> gradient = getGradient(x);
+	EXPECT_THAT(gradient, testing::ElementsAre(1 + x[1], 0, 6 * x[2], 0));
+	EXPECT_EQ(2 * footprint.size(), numberOfEvaluations);
+}
+
 TEST_F(derivativeTest, partialOfVectorToVectorFunction) {
 	auto getPartialDerivative = GetPartialDerivativeOfVectorToVectorFunction(vectorToVectorFn, numberVariables);
 	int variableIndex = 0;
@@ -162,6 +176,19 @@ TEST_F(derivativeTest, jacobianOfVectorToVectorFunctionUsingSparsityPattern) {
 	EXPECT_THAT(jacobian, testing::ContainerEq(expectedOutput));
 }
 
+TEST_F(derivativeTest, jacobianOfVectorToVectorFunctionWrittenInPlace) {
+	const auto [jacobianRows, jacobianCols] = GetSparsityPatternOfVectorToVectorFunction(vectorToVectorFn, numberVariables)();
+	auto getJacobian = GetJacobianOfVectorToVectorFunctionUsingSparsityPattern(vectorToVectorFn,
+																				numberVariables,
+																				jacobianRows,
+																				jacobianCols);
+
+	std::vector<double> jacobian(jacobianRows.size());
+	getJacobian(x, jacobian.data());
+
+	EXPECT_THAT(jacobian, testing::ContainerEq(getJacobian(x)));
+}
+
 TEST_F(derivativeTest, jacobianAndSparsityPatternOfVectorToVectorFunction) {
 	const auto [jacobianRows, jacobianCols, getJacobian] = getSparsityPatternAndJacobianFunctionOfVectorToVectorFunction(vectorToVectorFn, numberVariables);
 
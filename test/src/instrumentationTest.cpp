@@ -0,0 +1,134 @@
+#include <gtest/gtest.h> 
+#include <gmock/gmock.h>
+#include <sstream>
+#include "trajectoryOptimization/constraint.hpp"
+#include "trajectoryOptimization/dynamic.hpp"
+#include "trajectoryOptimization/instrumentation.hpp"
+#include "trajectoryOptimization/optimizer.hpp"
+
+using namespace trajectoryOptimization::instrumentation;
+using namespace trajectoryOptimization::optimizer;
+using namespace testing;
+
+TEST(instrumentationTest, HistogramBucketsAreLog2Nanoseconds) {
+	CallStatistics statistics;
+	statistics.record(0.5e-9);
+	statistics.record(3e-9);
+	statistics.record(1e-6);
+	statistics.record(1e6);
+
+	EXPECT_EQ(4u, statistics.calls);
+	EXPECT_DOUBLE_EQ(1e6, statistics.maxSeconds);
+	EXPECT_EQ(1u, statistics.histogram[0]);
+	EXPECT_EQ(1u, statistics.histogram[1]);
+	EXPECT_EQ(1u, statistics.histogram[9]);
+	EXPECT_EQ(1u, statistics.histogram[numberOfHistogramBuckets - 1]);
+}
+
+TEST(instrumentationTest, WrappersCountBlocksAndDynamics) {
+	const auto instrumentation = std::make_shared<Instrumentation>();
+	const trajectoryOptimization::dynamic::DynamicFunction dynamics =
+		instrumentDynamics(trajectoryOptimization::dynamic::BlockDynamics, instrumentation);
+	const trajectoryOptimization::constraint::ConstraintFunction constraint =
+		instrumentBlock(trajectoryOptimization::constraint::GetKinematicViolation(dynamics, 3, 1, 0, 0.1),
+						instrumentation, "dynamics 0");
+
+	const std::vector<double> trajectory = {0, 1, 2, 3, 4, 5};
+	constraint(trajectory.data());
+	constraint(trajectory.data());
+
+	ASSERT_EQ(1u, instrumentation->getBlocks().size());
+	EXPECT_EQ("dynamics 0", instrumentation->getBlocks()[0].name);
+	EXPECT_EQ(2u, instrumentation->getBlocks()[0].calls);
+	EXPECT_EQ(4u, instrumentation->getDynamicsEvaluations());
+}
+
+class instrumentedOptimizerTest : public::testing::Test {
+	protected:
+		const std::shared_ptr<Instrumentation> instrumentation = std::make_shared<Instrumentation>();
+		SmartPtr<TrajectoryOptimizer> trajectoryOptimizer;
+
+		void SetUp() {
+			trajectoryOptimizer = new TrajectoryOptimizer({-1, -1}, {1, 1}, {0}, {0}, {0, 0},
+															[](Index n, const Number* x) { return x[0] * x[0] + x[1] * x[1]; },
+															[](Index n, const Number* x, Number* gradient) {
+																gradient[0] = 2 * x[0];
+																gradient[1] = 2 * x[1];
+															},
+															[](Index n, const Number* x, Index m, Number* g) { g[0] = x[0] - x[1]; },
+															[](Index n, const Number* x, Index m, Index numberElementsJacobian,
+																Number* values) {
+																values[0] = 1;
+																values[1] = -1;
+															},
+															[](Index n, const Number* x, const Number objFactor, Index m,
+																const Number* lambda, Index numberElementsHessian, Number* values) {},
+															[](SolverReturn status, Index n, const Number* x,
+																const Number* zLower, const Number* zUpper,
+																Index m, const Number* g, const Number* lambda,
+																Number objValue, const IpoptData* ipData,
+																IpoptCalculatedQuantities* ipCalculatedQuantities) {},
+															makeSparsityStructure({0, 0}, {0, 1}, {}, {}));
+		}
+};
+
+TEST_F(instrumentedOptimizerTest, RecordsCallbacksAndIterations) {
+	trajectoryOptimizer->setInstrumentation(instrumentation);
+	Index n, m, nnzJacobian, nnzHessian;
+	TNLP::IndexStyleEnum indexStyle;
+	trajectoryOptimizer->get_nlp_info(n, m, nnzJacobian, nnzHessian, indexStyle);
+
+	const numberVector x = {0.5, 0.25};
+	Number objective;
+	numberVector g(1), jacobianValues(2);
+	trajectoryOptimizer->eval_f(n, x.data(), true, objective);
+	trajectoryOptimizer->eval_f(n, x.data(), false, objective);
+	trajectoryOptimizer->eval_g(n, x.data(), false, m, g.data());
+	trajectoryOptimizer->eval_jac_g(n, x.data(), false, m, nnzJacobian, NULL, NULL, jacobianValues.data());
+	trajectoryOptimizer->intermediate_callback(RegularMode, 3, objective, 0.25, 0.1, 1e-2, 0.5, 0, 1, 0.5, 2, NULL, NULL);
+
+	EXPECT_EQ(1u, instrumentation->getCallback(GET_NLP_INFO).calls);
+	EXPECT_EQ(2u, instrumentation->getCallback(EVAL_F).calls);
+	EXPECT_EQ(1u, instrumentation->getCallback(EVAL_G).calls);
+	EXPECT_EQ(1u, instrumentation->getCallback(EVAL_JAC_G).calls);
+	EXPECT_EQ(0u, instrumentation->getCallback(EVAL_H).calls);
+
+	ASSERT_EQ(1u, instrumentation->getIterations().size());
+	const auto& record = instrumentation->getIterations()[0];
+	EXPECT_EQ(3, record.iteration);
+	EXPECT_DOUBLE_EQ(0.3125, record.objective);
+	EXPECT_DOUBLE_EQ(0.25, record.primalInfeasibility);
+	EXPECT_DOUBLE_EQ(0.5, record.primalStepSize);
+	EXPECT_EQ(2, record.lineSearchTrials);
+
+	std::ostringstream json;
+	instrumentation->toJson(json);
+	EXPECT_THAT(json.str(), HasSubstr("{\"name\":\"eval_f\",\"calls\":2,"));
+	EXPECT_THAT(json.str(), HasSubstr("\"iteration\":3"));
+
+	std::ostringstream csv;
+	instrumentation->callsToCsv(csv);
+	EXPECT_THAT(csv.str(), HasSubstr("callback,eval_g,1,"));
+}
+
+TEST_F(instrumentedOptimizerTest, NewSolveStartsFreshRecord) {
+	trajectoryOptimizer->setInstrumentation(instrumentation);
+	Index n, m, nnzJacobian, nnzHessian;
+	TNLP::IndexStyleEnum indexStyle;
+	const numberVector x = {0.5, 0.25};
+	Number objective;
+
+	trajectoryOptimizer->get_nlp_info(n, m, nnzJacobian, nnzHessian, indexStyle);
+	trajectoryOptimizer->eval_f(n, x.data(), true, objective);
+	trajectoryOptimizer->get_nlp_info(n, m, nnzJacobian, nnzHessian, indexStyle);
+
+	EXPECT_EQ(0u, instrumentation->getCallback(EVAL_F).calls);
+}
+
+TEST_F(instrumentedOptimizerTest, DisabledByDefault) {
+	EXPECT_FALSE(trajectoryOptimizer->getInstrumentation());
+	Number objective;
+	const numberVector x = {0.5, 0.25};
+	EXPECT_TRUE(trajectoryOptimizer->eval_f(2, x.data(), true, objective));
+	EXPECT_EQ(0u, instrumentation->getCallback(EVAL_F).calls);
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h> 
+#include <gmock/gmock.h>
+#include <cmath>
+#include "trajectoryOptimization/cost.hpp"
+#include "trajectoryOptimization/iterativeLqr.hpp"
+
+using namespace trajectoryOptimization::ilqr;
+using namespace trajectoryOptimization::cost;
+using namespace testing;
+
+TEST(linearAlgebraTest, CholeskySolveInvertsSymmetricPositiveDefiniteMatrix) {
+	Matrix A(3, 3);
+	const double values[3][3] = {{4, 2, 0.4}, {2, 5, 1}, {0.4, 1, 3}};
+	for (unsigned row = 0; row < 3; row++) {
+		for (unsigned col = 0; col < 3; col++) {
+			A(row, col) = values[row][col];
+		}
+	}
+	const std::vector<double> b = {1, -2, 3};
+
+	Matrix L;
+	ASSERT_TRUE(choleskyFactorize(A, L));
+	const auto x = choleskySolve(L, b);
+	const auto Ax = multiply(A, x);
+	for (unsigned index = 0; index < 3; index++) {
+		EXPECT_NEAR(b[index], Ax[index], 1e-12);
+	}
+}
+
+TEST(linearAlgebraTest, CholeskyRejectsIndefiniteMatrix) {
+	Matrix A = identity(2);
+	A(1, 1) = -1;
+	Matrix L;
+	EXPECT_FALSE(choleskyFactorize(A, L));
+}
+
+class iterativeLqrTest : public::testing::Test {
+	protected:
+		const unsigned numberOfPoints = 21;
+		const unsigned positionDimension = 1;
+		const unsigned controlDimension = 1;
+		const unsigned pointDimension = 3;
+		const double dt = 0.1;
+		const GetControlSquareSum getControlSquareSum = GetControlSquareSum(numberOfPoints, pointDimension, controlDimension);
+		const StageCostFunction stageCost = [this](const double* trajectoryPointer, const unsigned timeIndex) {
+			return getControlSquareSum.atPoint(trajectoryPointer, timeIndex);
+		};
+		const std::vector<double> goal = {1, 0};
+		const numberVector startingTrajectory = numberVector(numberOfPoints * pointDimension, 0);
+		const FinalizerFunction ignoreSolution = [](SolverReturn status, Index n, const Number* x,
+													const Number* zLower, const Number* zUpper,
+													Index m, const Number* g, const Number* lambda,
+													Number objValue, const IpoptData* ipData,
+													IpoptCalculatedQuantities* ipCalculatedQuantities) {};
+};
+
+TEST_F(iterativeLqrTest, ReachesGoalWithMinimumEffort) {
+	const IterativeLqr iterativeLqr(trajectoryOptimization::dynamic::BlockDynamics, stageCost,
+									numberOfPoints, positionDimension, controlDimension, dt,
+									{{numberOfPoints - 1, goal}});
+	const auto result = iterativeLqr(startingTrajectory, ignoreSolution);
+
+	ASSERT_EQ(SUCCESS, result.status);
+	const auto lastPoint = result.x.data() + (numberOfPoints - 1) * pointDimension;
+	EXPECT_NEAR(goal[0], lastPoint[0], 1e-5);
+	EXPECT_NEAR(goal[1], lastPoint[1], 1e-5);
+
+	// The final state is linear in the controls, q = sum dt^2 (N - 1 - t) u_t and v = sum dt u_t,
+	// so the least-norm controls are u_t = a (N - 1 - t) + b with [a, b] solving the 2x2 normal equations.
+	const unsigned numberOfSteps = numberOfPoints - 1;
+	Matrix normalMatrix(2, 2);
+	for (unsigned timeIndex = 0; timeIndex < numberOfSteps; timeIndex++) {
+		const double positionGain = dt * dt * (numberOfSteps - 1 - timeIndex);
+		normalMatrix(0, 0) += positionGain * positionGain;
+		normalMatrix(0, 1) += positionGain * dt;
+		normalMatrix(1, 0) += positionGain * dt;
+		normalMatrix(1, 1) += dt * dt;
+	}
+	Matrix L;
+	ASSERT_TRUE(choleskyFactorize(normalMatrix, L));
+	const auto coefficients = choleskySolve(L, goal);
+	for (unsigned timeIndex = 0; timeIndex < numberOfSteps; timeIndex++) {
+		const double expectedControl = coefficients[0] * dt * dt * (numberOfSteps - 1 - timeIndex) + coefficients[1] * dt;
+		EXPECT_NEAR(expectedControl, result.x[timeIndex * pointDimension + 2], 1e-3);
+	}
+}
+
+TEST_F(iterativeLqrTest, PassesThroughWaypoint) {
+	const std::vector<double> waypoint = {-0.5};
+	const IterativeLqr iterativeLqr(trajectoryOptimization::dynamic::BlockDynamics, stageCost,
+									numberOfPoints, positionDimension, controlDimension, dt,
+									{{10, waypoint}, {numberOfPoints - 1, goal}});
+	const auto result = iterativeLqr(startingTrajectory, ignoreSolution);
+
+	ASSERT_EQ(SUCCESS, result.status);
+	EXPECT_NEAR(waypoint[0], result.x[10 * pointDimension], 1e-5);
+	EXPECT_NEAR(goal[0], result.x[(numberOfPoints - 1) * pointDimension], 1e-5);
+}
+
+TEST_F(iterativeLqrTest, ReportsThroughFinalizer) {
+	const IterativeLqr iterativeLqr(trajectoryOptimization::dynamic::BlockDynamics, stageCost,
+									numberOfPoints, positionDimension, controlDimension, dt,
+									{{numberOfPoints - 1, goal}});
+	SolverReturn reportedStatus = INTERNAL_ERROR;
+	Index reportedN = 0, reportedM = 0;
+	Number reportedObjective = 0;
+	const FinalizerFunction finalizerFunction = [&](SolverReturn status, Index n, const Number* x,
+													const Number* zLower, const Number* zUpper,
+													Index m, const Number* g, const Number* lambda,
+													Number objValue, const IpoptData* ipData,
+													IpoptCalculatedQuantities* ipCalculatedQuantities) {
+		reportedStatus = status;
+		reportedN = n;
+		reportedM = m;
+		reportedObjective = objValue;
+	};
+	const auto result = iterativeLqr(startingTrajectory, finalizerFunction);
+
+	EXPECT_EQ(result.status, reportedStatus);
+	EXPECT_EQ(numberOfPoints * pointDimension, reportedN);
+	EXPECT_EQ(2, reportedM);
+	EXPECT_DOUBLE_EQ(result.objectiveValue, reportedObjective);
+	EXPECT_DOUBLE_EQ(getControlSquareSum(result.x.data()), result.objectiveValue);
+}
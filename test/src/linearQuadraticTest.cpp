@@ -0,0 +1,196 @@
+#include <gtest/gtest.h> 
+#include <gmock/gmock.h>
+#include <cmath>
+#include "coin/IpIpoptApplication.hpp"
+#include "trajectoryOptimization/constraint.hpp"
+#include "trajectoryOptimization/cost.hpp"
+#include "trajectoryOptimization/derivative.hpp"
+#include "trajectoryOptimization/linearQuadratic.hpp"
+
+using namespace trajectoryOptimization;
+using namespace trajectoryOptimization::lq;
+using namespace testing;
+
+TEST(bandedMatrixTest, LuSolveWithPivoting) {
+	// Tridiagonal with a zero leading pivot
+	BandedMatrix A(4, 1, 1);
+	const double values[4][4] = {{0, 2, 0, 0}, {1, 1, 3, 0}, {0, 4, 2, 1}, {0, 0, 1, 5}};
+	for (unsigned row = 0; row < 4; row++) {
+		for (unsigned col = 0; col < 4; col++) {
+			if (A.inBand(row, col)) {
+				A(row, col) = values[row][col];
+			}
+		}
+	}
+	const std::vector<double> x = {1, -2, 0.5, 3};
+	std::vector<double> b(4, 0);
+	for (unsigned row = 0; row < 4; row++) {
+		for (unsigned col = 0; col < 4; col++) {
+			b[row] += values[row][col] * x[col];
+		}
+	}
+
+	std::vector<unsigned> pivots;
+	ASSERT_TRUE(bandedLuFactorize(A, pivots));
+	bandedLuSolve(A, pivots, b);
+	for (unsigned index = 0; index < 4; index++) {
+		EXPECT_NEAR(x[index], b[index], 1e-12);
+	}
+}
+
+TEST(bandedMatrixTest, SingularMatrixFails) {
+	BandedMatrix A(2, 1, 1);
+	A(0, 0) = 1;
+	A(0, 1) = 2;
+	A(1, 0) = 2;
+	A(1, 1) = 4;
+	std::vector<unsigned> pivots;
+	EXPECT_FALSE(bandedLuFactorize(A, pivots));
+}
+
+// Block in one dimension from rest at 0 to rest at 1 with minimum control effort
+class linearQuadraticTest : public::testing::Test {
+	protected:
+		const unsigned numberOfPoints = 11;
+		const unsigned worldDimension = 1;
+		const unsigned kinematicDimension = 2;
+		const unsigned controlDimension = 1;
+		const unsigned pointDimension = 3;
+		const unsigned numberVariables = numberOfPoints * pointDimension;
+		const double timeStepSize = 0.1;
+		const numberVector xLowerBounds = numberVector(numberVariables, -100);
+		const numberVector xUpperBounds = numberVector(numberVariables, 100);
+		const cost::WeightedCostSum<cost::GetControlSquareSum> costSum =
+			cost::WeightedCostSum(numberOfPoints,
+									cost::WeightedCostTerm("control", 1.0,
+															cost::GetControlSquareSum(numberOfPoints, pointDimension, controlDimension)));
+
+		std::vector<constraint::ConstraintFunction> constraints;
+		numberVector gBounds;
+		indexVector jacobianRows, jacobianCols;
+		EvaluateObjectiveFunction objectiveFunction;
+		EvaluateGradientInPlaceFunction gradientFunction;
+		EvaluateConstraintInPlaceFunction constraintFunction;
+		GetJacobianValueInPlaceFunction jacobianValueFunction;
+		GetHessianValueInPlaceFunction hessianValueFunction;
+
+		void SetUp() {
+			constraints.push_back(constraint::GetToKinematicGoal(numberOfPoints, pointDimension, kinematicDimension, 0, {0, 0}));
+			constraints = constraint::applyKinematicViolationConstraints(constraints, dynamic::BlockDynamics, pointDimension,
+																			worldDimension, 0, numberOfPoints - 1, timeStepSize);
+			constraints.push_back(constraint::GetToKinematicGoal(numberOfPoints, pointDimension, kinematicDimension,
+																	numberOfPoints - 1, {1, 0}));
+			setConstraints(constraints);
+
+			objectiveFunction = [this](Index n, const Number* x) { return costSum(x); };
+			gradientFunction = [this](Index n, const Number* x, Number* gradient) { costSum.gradient(x, n, gradient); };
+			hessianValueFunction = [this](Index n, const Number* x, const Number objFactor, Index m, const Number* lambda,
+											Index numberElementsHessian, Number* values) {
+				costSum.hessian(objFactor, values);
+			};
+		}
+
+		void setConstraints(const std::vector<constraint::ConstraintFunction>& constraintFunctions) {
+			auto stackedConstraints = constraint::StackConstriants(numberVariables, constraintFunctions);
+			const constraint::ConstraintFunction stackedConstraintFunction = stackedConstraints;
+			gBounds = numberVector(stackedConstraints.size(), 0);
+			constraintFunction = [stackedConstraints](Index n, const Number* x, Index m, Number* g) mutable {
+				stackedConstraints(x, g);
+			};
+			std::tie(jacobianRows, jacobianCols) =
+				derivative::GetSparsityPatternOfVectorToVectorFunction(stackedConstraintFunction, numberVariables)();
+			const auto evaluateJacobian =
+				derivative::GetJacobianOfVectorToVectorFunctionUsingSparsityPattern(stackedConstraintFunction, numberVariables,
+																					jacobianRows, jacobianCols);
+			jacobianValueFunction = [evaluateJacobian](Index n, const Number* x, Index m, Index numberElementsJacobian,
+														Number* values) {
+				evaluateJacobian(x, values);
+			};
+		}
+
+		std::optional<LinearQuadraticProblem> detect() {
+			return detectLinearQuadratic(xLowerBounds, xUpperBounds, gBounds, gBounds,
+											objectiveFunction, gradientFunction, constraintFunction, jacobianValueFunction,
+											jacobianRows, jacobianCols,
+											hessianValueFunction, costSum.getHessianRows(), costSum.getHessianCols());
+		}
+};
+
+TEST_F(linearQuadraticTest, DetectsBlockProblem) {
+	EXPECT_TRUE(detect().has_value());
+}
+
+TEST_F(linearQuadraticTest, RejectsSquaredGoals) {
+	constraints.push_back(constraint::GetToKinematicGoalSquare(numberOfPoints, pointDimension, kinematicDimension,
+																numberOfPoints / 2, {0.5, 0}));
+	setConstraints(constraints);
+	EXPECT_FALSE(detect().has_value());
+}
+
+TEST_F(linearQuadraticTest, SolutionSatisfiesKktConditions) {
+	const auto problem = detect();
+	ASSERT_TRUE(problem.has_value());
+	const auto result = solveLinearQuadratic(*problem);
+	ASSERT_EQ(SUCCESS, result.status);
+	const numberVector& x = result.solution.x;
+
+	numberVector g(gBounds.size());
+	constraintFunction(numberVariables, x.data(), g.size(), g.data());
+	for (const auto constraintValue: g) {
+		EXPECT_NEAR(0, constraintValue, 1e-8);
+	}
+
+	numberVector stationarity(numberVariables);
+	gradientFunction(numberVariables, x.data(), stationarity.data());
+	numberVector jacobianValues(jacobianRows.size());
+	jacobianValueFunction(numberVariables, x.data(), g.size(), jacobianValues.size(), jacobianValues.data());
+	for (unsigned entry = 0; entry < jacobianValues.size(); entry++) {
+		stationarity[jacobianCols[entry]] += jacobianValues[entry] * result.solution.lambda[jacobianRows[entry]];
+	}
+	// The Jacobian is a finite difference
+	for (const auto value: stationarity) {
+		EXPECT_NEAR(0, value, 1e-4);
+	}
+	EXPECT_NEAR(costSum(x.data()), result.objectiveValue, 1e-9);
+}
+
+TEST_F(linearQuadraticTest, FixedVariablesKeepTheirBounds) {
+	auto problem = detect();
+	ASSERT_TRUE(problem.has_value());
+	problem->xLowerBounds[2] = problem->xUpperBounds[2] = 0.25;
+	const auto result = solveLinearQuadratic(*problem);
+	ASSERT_EQ(SUCCESS, result.status);
+	EXPECT_DOUBLE_EQ(0.25, result.solution.x[2]);
+}
+
+TEST_F(linearQuadraticTest, MatchesIpoptSolution) {
+	const auto problem = detect();
+	ASSERT_TRUE(problem.has_value());
+	const auto result = solveLinearQuadratic(*problem);
+
+	numberVector ipoptSolution;
+	FinalizerFunction finalizerFunction = [&](SolverReturn status, Index n, const Number* x,
+												const Number* zLower, const Number* zUpper,
+												Index m, const Number* g, const Number* lambda,
+												Number objValue, const IpoptData* ipData,
+												IpoptCalculatedQuantities* ipCalculatedQuantities) {
+		ipoptSolution.assign(x, x + n);
+	};
+	SmartPtr<TNLP> trajectoryOptimizer = new TrajectoryOptimizer(xLowerBounds, xUpperBounds, gBounds, gBounds,
+																	numberVector(numberVariables, 0),
+																	objectiveFunction, gradientFunction, constraintFunction,
+																	jacobianValueFunction, hessianValueFunction, finalizerFunction,
+																	makeSparsityStructure(jacobianRows, jacobianCols,
+																						costSum.getHessianRows(),
+																						costSum.getHessianCols()));
+	SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
+	app->Options()->SetNumericValue("tol", 1e-10);
+	app->Options()->SetIntegerValue("print_level", 0);
+	ASSERT_EQ(Solve_Succeeded, app->Initialize());
+	ASSERT_EQ(Solve_Succeeded, app->OptimizeTNLP(trajectoryOptimizer));
+
+	ASSERT_EQ(result.solution.x.size(), ipoptSolution.size());
+	for (unsigned index = 0; index < ipoptSolution.size(); index++) {
+		EXPECT_NEAR(ipoptSolution[index], result.solution.x[index], 1e-6);
+	}
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cmath>
+#include <fstream>
+#include "trajectoryOptimization/mappedTrajectoryFile.hpp"
+
+using namespace trajectoryOptimization::trajectoryFile;
+using namespace testing;
+
+class mappedTrajectoryFileTest : public::testing::Test {
+	protected:
+		const std::string filename = ::testing::TempDir() + "mappedTrajectoryFileTest.traj";
+		// One position, one control; position t^3, velocity 3 t^2, control t
+		const TrajectoryRecord cubic = {1, 1, 1, {}, SUCCESS, 2, {{0, 0, 0, 1, 3, 1, 8, 12, 2}, {}, {}, {7, 8}}};
+		const TrajectoryRecord nonUniform = {1, 1, 0, {0.5, 1.5}, MAXITER_EXCEEDED, 5,
+												{{0, 0, 0, 1, 1, 1, 2, 2, 2}, {1, 1, 1, 1, 1, 1, 1, 1, 1}, {2, 2, 2, 2, 2, 2, 2, 2, 2}, {}}};
+
+		void SetUp() {
+			TrajectoryWriter writer(filename);
+			writer.write(cubic);
+			writer.write(nonUniform);
+		}
+};
+
+TEST_F(mappedTrajectoryFileTest, IndexesEveryRecord) {
+	const MappedTrajectoryFile file(filename);
+	ASSERT_EQ(2u, file.getNumberOfRecords());
+	EXPECT_TRUE(file.isComplete());
+
+	const auto& first = file[0];
+	EXPECT_EQ(3u, first.getNumberOfPoints());
+	EXPECT_EQ(SUCCESS, first.header->status);
+	EXPECT_DOUBLE_EQ(2, first.header->objectiveValue);
+	EXPECT_DOUBLE_EQ(8, *first.getPosition(2));
+	EXPECT_DOUBLE_EQ(12, *first.getVelocity(2));
+	EXPECT_DOUBLE_EQ(2, *first.getControl(2));
+	EXPECT_EQ(nullptr, first.zLower);
+	EXPECT_THAT(first.toPrimalDualPoint().lambda, ElementsAre(7, 8));
+
+	const auto& second = file[1];
+	EXPECT_THAT(second.getKnotTimes(), ElementsAre(0, 0.5, 2));
+	EXPECT_THAT(second.toPrimalDualPoint().zUpper, Each(2));
+	EXPECT_EQ(nullptr, second.lambda);
+}
+
+TEST_F(mappedTrajectoryFileTest, TruncatedTailIsNotIndexed) {
+	{
+		std::ofstream file(filename, std::ios::binary | std::ios::app);
+		file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+	}
+	const MappedTrajectoryFile file(filename);
+	EXPECT_EQ(2u, file.getNumberOfRecords());
+	EXPECT_FALSE(file.isComplete());
+}
+
+TEST_F(mappedTrajectoryFileTest, MissingFileHasNoRecords) {
+	const MappedTrajectoryFile file(filename + ".missing");
+	EXPECT_EQ(0u, file.getNumberOfRecords());
+	EXPECT_FALSE(file.isComplete());
+}
+
+TEST_F(mappedTrajectoryFileTest, ResamplingFollowsCubicPositions) {
+	const MappedTrajectoryFile file(filename);
+	const auto x = resampleTrajectory(file[0], 5);
+	ASSERT_EQ(15u, x.size());
+	for (unsigned knot = 0; knot < 5; knot++) {
+		const double t = 0.5 * knot;
+		EXPECT_NEAR(std::pow(t, 3), x[3 * knot], 1e-12);
+		EXPECT_NEAR(t, x[3 * knot + 2], 1e-12);
+	}
+	// Velocity is linear between the stored knots
+	EXPECT_NEAR(1.5, x[3 * 1 + 1], 1e-12);
+}
+
+TEST_F(mappedTrajectoryFileTest, ResamplingKeepsKnotsOfNonUniformMesh) {
+	const MappedTrajectoryFile file(filename);
+	const auto x = resampleTrajectory(file[1], std::vector<double>{0.5, 2});
+	EXPECT_THAT(x, ElementsAre(DoubleNear(1, 1e-12), DoubleNear(1, 1e-12), DoubleNear(1, 1e-12),
+								DoubleNear(2, 1e-12), DoubleNear(2, 1e-12), DoubleNear(2, 1e-12)));
+}
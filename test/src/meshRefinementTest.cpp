@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cmath>
+#include "trajectoryOptimization/cost.hpp"
+#include "trajectoryOptimization/meshRefinement.hpp"
+
+using namespace trajectoryOptimization;
+using namespace trajectoryOptimization::mesh;
+using namespace testing;
+
+// Spring with one oscillation per second, driven by the control. Its optimal trajectories are
+// trigonometric, so no mesh makes them exact and refinement has work to do.
+const double* SpringDynamics(const double* position,
+								const unsigned positionDimension,
+								const double* velocity,
+								const unsigned velocityDimension,
+								const double* control,
+								const unsigned controlDimension) {
+	thread_local double acceleration;
+	const double omega = 2 * std::acos(-1);
+	acceleration = control[0] - omega * omega * position[0];
+	return &acceleration;
+}
+
+// Block in one dimension; points are [position, velocity, control]
+class meshRefinementTest : public::testing::Test {
+	protected:
+		const unsigned positionDimension = 1;
+		const unsigned controlDimension = 1;
+		const unsigned pointDimension = 3;
+
+		// Exact trajectory with control t^2: velocity t^3 / 3, position t^4 / 12
+		numberVector sampleQuadraticControl(const std::vector<double>& knotTimes) {
+			numberVector x;
+			for (const double t: knotTimes) {
+				x.insert(x.end(), {std::pow(t, 4) / 12, std::pow(t, 3) / 3, t * t});
+			}
+			return x;
+		}
+
+		// Exact trajectory with control t: velocity t^2 / 2, position t^3 / 6
+		numberVector sampleLinearControl(const std::vector<double>& knotTimes) {
+			numberVector x;
+			for (const double t: knotTimes) {
+				x.insert(x.end(), {std::pow(t, 3) / 6, t * t / 2, t});
+			}
+			return x;
+		}
+};
+
+TEST_F(meshRefinementTest, StepSizesFromKnotTimes) {
+	const std::vector<double> knotTimes = {0, 0.5, 0.75, 2};
+	EXPECT_THAT(getTimeStepSizes(knotTimes), ElementsAre(0.5, 0.25, 1.25));
+	EXPECT_THAT(getUniformKnotTimes(5, 2), ElementsAre(0, 0.5, 1, 1.5, 2));
+	EXPECT_EQ(2u, findKnotIndex(knotTimes, 0.75));
+	EXPECT_EQ(3u, findKnotIndex(knotTimes, 2));
+}
+
+TEST_F(meshRefinementTest, NoDefectForCubicStates) {
+	const auto knotTimes = getUniformKnotTimes(5, 2);
+	const auto defects = getIntervalDefects(sampleLinearControl(knotTimes), knotTimes,
+											positionDimension, controlDimension, dynamic::BlockDynamics);
+	EXPECT_THAT(defects, Each(DoubleNear(0, 1e-12)));
+}
+
+TEST_F(meshRefinementTest, DefectShrinksWithCubeOfStepSize) {
+	const std::vector<double> knotTimes = {0, 0.5, 1.5};
+	const auto defects = getIntervalDefects(sampleQuadraticControl(knotTimes), knotTimes,
+											positionDimension, controlDimension, dynamic::BlockDynamics);
+	// The linear control is off by h^2 / 4 at the midpoint
+	EXPECT_THAT(defects, ElementsAre(DoubleNear(std::pow(0.5, 3) / 4, 1e-12), DoubleNear(1.0 / 4, 1e-12)));
+}
+
+TEST_F(meshRefinementTest, BisectsOnlyInaccurateIntervals) {
+	const std::vector<double> knotTimes = {0, 1, 2, 4};
+	EXPECT_THAT(refineKnotTimes(knotTimes, {1e-2, 1e-5, 1e-1}, 1e-3), ElementsAre(0, 0.5, 1, 2, 3, 4));
+	EXPECT_THAT(refineKnotTimes(knotTimes, {1e-4, 1e-5, 1e-4}, 1e-3), ElementsAre(0, 1, 2, 4));
+}
+
+TEST_F(meshRefinementTest, InterpolationKeepsKnotsAndIsExactForCubicStates) {
+	const auto knotTimes = getUniformKnotTimes(3, 2);
+	const std::vector<double> newKnotTimes = {0, 0.25, 1, 1.7, 2};
+	const auto interpolated = interpolateTrajectory(sampleLinearControl(knotTimes), knotTimes, newKnotTimes,
+													positionDimension, controlDimension, dynamic::BlockDynamics);
+	const auto expected = sampleLinearControl(newKnotTimes);
+	ASSERT_EQ(expected.size(), interpolated.size());
+	for (unsigned index = 0; index < expected.size(); index++) {
+		EXPECT_NEAR(expected[index], interpolated[index], 1e-12);
+	}
+}
+
+TEST_F(meshRefinementTest, PerIntervalStepSizesInProblem) {
+	const std::vector<double> knotTimes = {0, 0.5, 1.5};
+	problem::TrajectoryProblem trajectoryProblem(positionDimension, controlDimension, getTimeStepSizes(knotTimes),
+													dynamic::BlockDynamics);
+	const unsigned numberOfPoints = knotTimes.size();
+	trajectoryProblem.setObjective(cost::WeightedCostSum(numberOfPoints,
+															cost::WeightedCostTerm("control", 1.0,
+																					cost::GetControlSquareSum(numberOfPoints,
+																												pointDimension,
+																												controlDimension))),
+									true);
+	problem::StructureCache cache;
+	const auto functions = trajectoryProblem.getFunctions(cache);
+
+	// Constant acceleration 1 from rest, exact for the trapezoidal rule on any mesh
+	numberVector x;
+	for (const double t: knotTimes) {
+		x.insert(x.end(), {t * t / 2, t, 1});
+	}
+	numberVector g(functions.structure->numberConstraints);
+	functions.constraintFunction(x.size(), x.data(), g.size(), g.data());
+	EXPECT_THAT(g, Each(DoubleNear(0, 1e-12)));
+}
+
+TEST_F(meshRefinementTest, RefinesUntilDefectsAreBelowTolerance) {
+	const double finalTime = 1;
+	const ProblemFactory problemFactory = [this, finalTime](const std::vector<double>& knotTimes) {
+		const unsigned numberOfPoints = knotTimes.size();
+		problem::TrajectoryProblem trajectoryProblem(positionDimension, controlDimension, getTimeStepSizes(knotTimes),
+														SpringDynamics);
+		// The spring is linear, so the objective's Hessian is still the Hessian of the Lagrangian
+		trajectoryProblem.addKinematicGoal(0, 2, {0, 0})
+							.addKinematicGoal(findKnotIndex(knotTimes, finalTime), 2, {1, 0})
+							.setObjective(cost::WeightedCostSum(numberOfPoints,
+																cost::WeightedCostTerm("control", 1.0,
+																						cost::GetControlSquareSum(numberOfPoints,
+																													pointDimension,
+																													controlDimension))),
+											true)
+							.setPointBounds({-10, -10, -10}, {10, 10, 10});
+		return trajectoryProblem;
+	};
+
+	SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
+	app->Options()->SetNumericValue("tol", 1e-9);
+	app->Options()->SetIntegerValue("print_level", 0);
+	ASSERT_EQ(Solve_Succeeded, app->Initialize());
+
+	MeshRefinementOptions options;
+	options.defectTolerance = 1e-3;
+	const auto result = RefineMesh(problemFactory, positionDimension, controlDimension,
+									SpringDynamics, options)(app, getUniformKnotTimes(5, finalTime));
+
+	EXPECT_EQ(Solve_Succeeded, result.status);
+	ASSERT_GT(result.levels.size(), 1u);
+	EXPECT_GT(result.levels.front().maxDefect, options.defectTolerance);
+	EXPECT_GT(result.knotTimes.size(), 5u);
+	ASSERT_EQ(result.knotTimes.size() * pointDimension, result.solution.x.size());
+	EXPECT_THAT(getIntervalDefects(result.solution.x, result.knotTimes, positionDimension, controlDimension, SpringDynamics),
+				Each(Le(options.defectTolerance)));
+	EXPECT_NEAR(1, result.solution.x[(result.knotTimes.size() - 1) * pointDimension], 1e-6);
+}
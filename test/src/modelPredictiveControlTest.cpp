@@ -0,0 +1,108 @@
+#include <gtest/gtest.h> 
+#include <gmock/gmock.h>
+#include "trajectoryOptimization/cost.hpp"
+#include "trajectoryOptimization/dynamic.hpp"
+#include "trajectoryOptimization/modelPredictiveControl.hpp"
+#include "trajectoryOptimization/problem.hpp"
+
+using namespace trajectoryOptimization;
+using namespace trajectoryOptimization::mpc;
+using namespace testing;
+
+TEST(modelPredictiveControlTest, shiftPointsByOneRepeatsLastPoint) {
+	const unsigned pointDimension = 2;
+	const numberVector trajectory = {1, 2, 3, 4, 5, 6};
+
+	EXPECT_THAT(shiftPointsByOne(trajectory, pointDimension), ElementsAre(3, 4, 5, 6, 5, 6));
+}
+
+TEST(modelPredictiveControlTest, constraintShiftMapMovesOnlyPerPointBlock) {
+	const unsigned numberConstraints = 8;
+	const unsigned blockStartRow = 2;
+	const unsigned rowsPerPoint = 2;
+	const unsigned numberOfBlocks = 3;
+
+	const auto shiftMap = getConstraintShiftMap(numberConstraints, blockStartRow, rowsPerPoint, numberOfBlocks);
+	EXPECT_THAT(shiftMap, ElementsAre(0, 1, 4, 5, 6, 7, 6, 7));
+}
+
+TEST(modelPredictiveControlTest, shiftPrimalDualPointShiftsPrimalsAndMultipliers) {
+	const unsigned pointDimension = 1;
+	const PrimalDualPoint primalDualPoint = {{1, 2, 3}, {0.1, 0.2, 0.3}, {0.4, 0.5, 0.6}, {10, 20, 30}};
+	const indexVector shiftMap = getConstraintShiftMap(3, 1, 1, 2);
+
+	const auto shifted = shiftPrimalDualPoint(primalDualPoint, pointDimension, shiftMap);
+	EXPECT_THAT(shifted.x, ElementsAre(2, 3, 3));
+	EXPECT_THAT(shifted.zLower, ElementsAre(0.2, 0.3, 0.3));
+	EXPECT_THAT(shifted.zUpper, ElementsAre(0.5, 0.6, 0.6));
+	EXPECT_THAT(shifted.lambda, ElementsAre(10, 30, 30));
+}
+
+TEST(modelPredictiveControlTest, latencyStatistics) {
+	const std::vector<double> latencies = {0.03, 0.01, 0.02, 0.04};
+
+	const auto statistics = getLatencyStatistics(latencies, 1);
+	EXPECT_EQ(4, statistics.numberOfTicks);
+	EXPECT_EQ(1, statistics.deadlineMisses);
+	EXPECT_DOUBLE_EQ(0.04, statistics.last);
+	EXPECT_DOUBLE_EQ(0.025, statistics.mean);
+	EXPECT_DOUBLE_EQ(0.01, statistics.min);
+	EXPECT_DOUBLE_EQ(0.04, statistics.max);
+	EXPECT_DOUBLE_EQ(0.03, statistics.median);
+	EXPECT_DOUBLE_EQ(0.04, statistics.percentile99);
+}
+
+TEST(modelPredictiveControlTest, ticksPinFirstStateAndReturnItsControl) {
+	// A block from rest at 0 to rest at 1; the plant applies each returned control for one time step
+	const unsigned numberOfPoints = 10;
+	const unsigned pointDimension = 3;
+	const unsigned kinematicDimension = 2;
+	const double timeStepSize = 0.1;
+	const auto controlCost = cost::WeightedCostSum(numberOfPoints,
+													cost::WeightedCostTerm("control", 1,
+																			cost::GetControlSquareSum(numberOfPoints,
+																										pointDimension, 1)));
+	problem::StructureCache structureCache;
+	const FinalizerFunction ignoreSolution = [](SolverReturn status, Index n, const Number* x,
+												const Number* zLower, const Number* zUpper,
+												Index m, const Number* g, const Number* lambda,
+												Number objValue, const IpoptData* ipData,
+												IpoptCalculatedQuantities* ipCalculatedQuantities) {};
+	const SmartPtr<TrajectoryOptimizer> trajectoryOptimizer =
+		problem::TrajectoryProblem(numberOfPoints, 1, 1, timeStepSize, dynamic::BlockDynamics)
+			.addKinematicGoal(numberOfPoints - 1, kinematicDimension, {1, 0})
+			.setObjective(controlCost, true)
+			.setPointBounds({-100, -100, -100}, {100, 100, 100})
+			.build(ignoreSolution, structureCache);
+
+	SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
+	app->Options()->SetIntegerValue("print_level", 0);
+	ASSERT_EQ(Solve_Succeeded, app->Initialize());
+
+	// Dynamics rows come first, one block of kinematicDimension rows per interval
+	const unsigned numberConstraints = (numberOfPoints - 1) * kinematicDimension + kinematicDimension;
+	ModelPredictiveControl modelPredictiveControl(trajectoryOptimizer, app, pointDimension, kinematicDimension,
+													getConstraintShiftMap(numberConstraints, 0, kinematicDimension,
+																			numberOfPoints - 1),
+													std::chrono::seconds(1));
+
+	std::vector<double> position = {0};
+	std::vector<double> velocity = {0};
+	const unsigned numberOfTicks = 4;
+	for (unsigned tick = 0; tick < numberOfTicks; tick++) {
+		const auto tickResult = modelPredictiveControl.tick({position[0], velocity[0]});
+		ASSERT_EQ(Solve_Succeeded, tickResult.status);
+
+		const auto& x = modelPredictiveControl.getSolution().x;
+		EXPECT_NEAR(position[0], x[0], 1e-9);
+		EXPECT_NEAR(velocity[0], x[1], 1e-9);
+		ASSERT_THAT(tickResult.control, ElementsAre(DoubleEq(x[2])));
+
+		std::tie(position, velocity) = dynamic::stepForward(position, velocity, tickResult.control, timeStepSize);
+	}
+
+	// Pushed towards the goal, ticks counted
+	EXPECT_GT(position[0], 0);
+	EXPECT_GT(velocity[0], 0);
+	EXPECT_EQ(numberOfTicks, modelPredictiveControl.getLatencyStatistics().numberOfTicks);
+}
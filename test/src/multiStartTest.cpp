@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <atomic>
+#include <cmath>
+#include "trajectoryOptimization/multiStart.hpp"
+
+using namespace trajectoryOptimization;
+using namespace trajectoryOptimization::multistart;
+using namespace testing;
+
+TEST(startingPointTest, PerturbationStaysInBounds) {
+	const numberVector x = {0, 5, -5};
+	const auto perturbed = perturbStartingPoint(x, {-0.1, 4, -5}, {0.1, 6, 5}, 1, 3);
+	EXPECT_THAT(perturbed, ElementsAre(AllOf(Ge(-0.1), Le(0.1)), AllOf(Ge(4), Le(6)), AllOf(Ge(-5), Le(5))));
+	EXPECT_EQ(perturbed, perturbStartingPoint(x, {-0.1, 4, -5}, {0.1, 6, 5}, 1, 3));
+	EXPECT_NE(perturbed, perturbStartingPoint(x, {-0.1, 4, -5}, {0.1, 6, 5}, 1, 4));
+}
+
+TEST(startingPointTest, InterpolationBetweenKinematics) {
+	const auto x = interpolateStartingPoint({0, 0}, {2, 4}, 3, 3);
+	EXPECT_THAT(x, ElementsAre(0, 0, 0, 1, 2, 0, 2, 4, 0));
+}
+
+TEST(startingPointTest, RollOutAppliesControls) {
+	const auto x = rollOutStartingPoint({0, 1}, {2, 2, 0}, dynamic::BlockDynamics, 1, 1, 0.5);
+	EXPECT_THAT(x, ElementsAre(0, 1, 2, 0.5, 2, 2, 1.5, 3, 0));
+}
+
+// A double well tilted towards x = -1: (x^2 - 1)^2 + 0.3 x, the minimum near x = 1 is only local
+class multiStartTest : public::testing::Test {
+	protected:
+		// Several workers only where the linear solver allows concurrent solves
+		const unsigned numberOfWorkers = batch::MUMPS_IS_THREAD_SAFE ? 2 : 1;
+		const ConfigureApplicationFunction configureApplication = [](const SmartPtr<IpoptApplication>& app) {
+			app->Options()->SetStringValue("linear_solver", "mumps");
+			app->Options()->SetNumericValue("tol", 1e-9);
+			app->Options()->SetIntegerValue("print_level", 0);
+		};
+		problem::ProblemFunctions functions = {
+			{-3},
+			{3},
+			{},
+			{},
+			{0},
+			[](Index n, const Number* x) { return std::pow(x[0] * x[0] - 1, 2) + 0.3 * x[0]; },
+			[](Index n, const Number* x, Number* gradient) { gradient[0] = 4 * x[0] * (x[0] * x[0] - 1) + 0.3; },
+			[](Index n, const Number* x, Index m, Number* g) {},
+			[](Index n, const Number* x, Index m, Index numberElementsJacobian, Number* values) {},
+			[](Index n, const Number* x, const Number objFactor, Index m, const Number* lambda,
+				Index numberElementsHessian, Number* values) {
+				values[0] = objFactor * (12 * x[0] * x[0] - 4);
+			},
+			std::make_shared<const problem::ProblemStructure>(
+				problem::ProblemStructure{0, {}, makeSparsityStructure({}, {}, {0}, {0})})};
+};
+
+TEST_F(multiStartTest, PicksTheGlobalMinimum) {
+	MultiStartOptions options;
+	options.numberOfWorkers = numberOfWorkers;
+	const auto result = SolveMultiStart(configureApplication, options)(functions, {{2}, {-2}, {1.5}});
+
+	ASSERT_EQ(1, result.bestStart);
+	EXPECT_LT(result.solution.x[0], 0);
+	ASSERT_EQ(3u, result.starts.size());
+	EXPECT_EQ(COMPLETED, result.starts[1].outcome);
+	EXPECT_GT(result.starts[0].objectiveValue, result.objectiveValue);
+}
+
+TEST_F(multiStartTest, GoodEnoughSolutionCancelsRemainingStarts) {
+	MultiStartOptions options;
+	options.numberOfWorkers = 1;
+	options.objectiveLowerBound = 0;
+	options.optimalityGap = 10;
+	const auto result = SolveMultiStart(configureApplication, options)(functions, {{2}, {-2}, {1.5}});
+
+	EXPECT_EQ(0, result.bestStart);
+	EXPECT_EQ(COMPLETED, result.starts[0].outcome);
+	EXPECT_EQ(NOT_STARTED, result.starts[1].outcome);
+	EXPECT_EQ(NOT_STARTED, result.starts[2].outcome);
+}
+
+TEST_F(multiStartTest, DominatedStartingPointNeverReachesIpopt) {
+	// The first start converges to f = -0.3 near x = -1, f(2.9) is above 55
+	std::atomic<bool> secondStartEvaluated(false);
+	const auto gradientFunction = functions.gradientFunction;
+	functions.gradientFunction = [&secondStartEvaluated, gradientFunction](Index n, const Number* x, Number* gradient) {
+		if (x[0] > 2.5) {
+			secondStartEvaluated = true;
+		}
+		gradientFunction(n, x, gradient);
+	};
+	MultiStartOptions options;
+	options.numberOfWorkers = 1;
+	options.pruneAfterIterations = 0;
+	const auto result = SolveMultiStart(configureApplication, options)(functions, {{-2}, {2.9}});
+
+	EXPECT_EQ(0, result.bestStart);
+	EXPECT_EQ(COMPLETED, result.starts[0].outcome);
+	EXPECT_EQ(PRUNED, result.starts[1].outcome);
+	EXPECT_EQ(0, result.starts[1].iterationCount);
+	EXPECT_FALSE(secondStartEvaluated);
+}
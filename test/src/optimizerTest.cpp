@@ -1,6 +1,7 @@
 #include <gtest/gtest.h> 
 #include <gmock/gmock.h>
 #include <functional>
+#include <cmath>
 #include "coin/IpIpoptApplication.hpp"
 #include "coin/IpSolveStatistics.hpp"
 #include "trajectoryOptimization/optimizer.hpp"
@@ -294,4 +295,170 @@ TEST(optimizerTest, SolutionForZeroes) {
 
 	EXPECT_THAT(status, Solve_Succeeded);
 	EXPECT_THAT(final_obj, 0);
-}
\ No newline at end of file
+}
+
+TEST(optimizerTest, AdaptedFunctionsWriteInPlace) {
+	const Number x[2] = {1, 2};
+	EvaluateGradientFunction gradientFunction = [](Index n, const Number* x) {
+		numberVector gradient = {2 * x[0], 2 * x[1]};
+		return gradient;
+	};
+	EvaluateConstraintFunction constraintFunction = [](Index n, const Number* x, Index m) {
+		numberVector g = {x[0] + x[1]};
+		return g;
+	};
+
+	Number gradient[2];
+	adaptGradientFunction(gradientFunction)(2, x, gradient);
+	EXPECT_THAT(gradient, ElementsAre(2, 4));
+
+	Number g[1];
+	adaptConstraintFunction(constraintFunction)(2, x, 1, g);
+	EXPECT_THAT(g, ElementsAre(3));
+}
+
+class warmStartTest : public::testing::Test {
+	protected:
+		const int numberVariablesX = 2;
+		const int numberConstraintsG = 1;
+		const int numberNonzeroJacobian = 2;
+		const int numberNonzeroHessian = 2;
+
+		const numberVector xLowerBounds = {-10, -10};
+		const numberVector xUpperBounds = {10, 10};
+		const numberVector gBounds = {2};
+		const numberVector xStartingPoint = {0, 0};
+
+		const indexVector jacobianStructureRows = {0, 0};
+		const indexVector jacobianStructureCols = {0, 1};
+		const indexVector hessianStructureRows = {0, 1};
+		const indexVector hessianStructureCols = {0, 1};
+
+		SmartPtr<TrajectoryOptimizer> createOptimizer() {
+			// (x0 - 1)^2 + (x1 - 2)^2 subject to x0 + x1 = 2
+			EvaluateObjectiveFunction objectiveFunction = [](Index n, const Number* x) {
+				return std::pow(x[0] - 1, 2) + std::pow(x[1] - 2, 2);
+			};
+			EvaluateGradientFunction gradientFunction = [](Index n, const Number* x) {
+				numberVector gradient = {2 * (x[0] - 1), 2 * (x[1] - 2)};
+				return gradient;
+			};
+			EvaluateConstraintFunction constraintFunction = [](Index n, const Number* x, Index m) {
+				numberVector g = {x[0] + x[1]};
+				return g;
+			};
+			GetJacobianValueFunction jacobianValueFunction = [](Index n, const Number* x, Index m,
+																Index numberElementsJacobian) {
+				numberVector values = {1, 1};
+				return values;
+			};
+			GetHessianValueFunction hessianValueFunction = [](Index n, const Number* x,
+															Number objFactor, Index m, const Number* lambda,
+															Index numberElementsHessian) {
+				numberVector values = {2 * objFactor, 2 * objFactor};
+				return values;
+			};
+			FinalizerFunction finalizerFunction = [](SolverReturn status, Index n, const Number* x,
+														const Number* zLower, const Number* zUpper,
+														Index m, const Number* g, const Number* lambda,
+														Number objValue, const IpoptData* ipData,
+														IpoptCalculatedQuantities* ipCalculatedQuantities) {};
+
+			return new TrajectoryOptimizer(numberVariablesX,
+											numberConstraintsG,
+											numberNonzeroJacobian,
+											numberNonzeroHessian,
+											xLowerBounds,
+											xUpperBounds,
+											gBounds,
+											gBounds,
+											xStartingPoint,
+											objectiveFunction,
+											gradientFunction,
+											constraintFunction,
+											jacobianStructureRows,
+											jacobianStructureCols,
+											jacobianValueFunction,
+											hessianStructureRows,
+											hessianStructureCols,
+											hessianValueFunction,
+											finalizerFunction);
+		}
+};
+
+TEST_F(warmStartTest, StartingPointIsHandedToIpopt) {
+	SmartPtr<TrajectoryOptimizer> trajectoryOptimizer = createOptimizer();
+	trajectoryOptimizer->setStartingPoint({{0.5, 1.5}, {0.1, 0.2}, {0.3, 0.4}, {-1}});
+
+	Number x[2], zLower[2], zUpper[2], lambda[1];
+	EXPECT_TRUE(trajectoryOptimizer->get_starting_point(numberVariablesX, true, x, true, zLower, zUpper,
+														numberConstraintsG, true, lambda));
+	EXPECT_THAT(x, ElementsAre(0.5, 1.5));
+	EXPECT_THAT(zLower, ElementsAre(0.1, 0.2));
+	EXPECT_THAT(zUpper, ElementsAre(0.3, 0.4));
+	EXPECT_THAT(lambda, ElementsAre(-1));
+}
+
+TEST_F(warmStartTest, FinalizedSolutionFeedsNextStartingPoint) {
+	SmartPtr<TrajectoryOptimizer> trajectoryOptimizer = createOptimizer();
+	EXPECT_FALSE(trajectoryOptimizer->hasSolution());
+
+	const Number x[2] = {0.5, 1.5};
+	const Number zLower[2] = {0, 0};
+	const Number zUpper[2] = {0, 0};
+	const Number g[1] = {2};
+	const Number lambda[1] = {-1};
+	trajectoryOptimizer->finalize_solution(SUCCESS, numberVariablesX, x, zLower, zUpper,
+											numberConstraintsG, g, lambda, 0.5, NULL, NULL);
+
+	ASSERT_TRUE(trajectoryOptimizer->hasSolution());
+	EXPECT_THAT(trajectoryOptimizer->getSolution().x, ElementsAre(0.5, 1.5));
+	EXPECT_THAT(trajectoryOptimizer->getSolution().lambda, ElementsAre(-1));
+
+	Number startX[2], startZLower[2], startZUpper[2], startLambda[1];
+	trajectoryOptimizer->get_starting_point(numberVariablesX, true, startX, true, startZLower, startZUpper,
+											numberConstraintsG, true, startLambda);
+	EXPECT_THAT(startX, ElementsAre(0.5, 1.5));
+	EXPECT_THAT(startLambda, ElementsAre(-1));
+}
+
+TEST_F(warmStartTest, FailedSolveKeepsStartingPoint) {
+	SmartPtr<TrajectoryOptimizer> trajectoryOptimizer = createOptimizer();
+	trajectoryOptimizer->setStartingPoint({{0.5, 1.5}, {0, 0}, {0, 0}, {-1}});
+
+	const Number x[2] = {9, -9};
+	const Number zLower[2] = {0, 0};
+	const Number zUpper[2] = {0, 0};
+	const Number g[1] = {0};
+	const Number lambda[1] = {100};
+	trajectoryOptimizer->finalize_solution(LOCAL_INFEASIBILITY, numberVariablesX, x, zLower, zUpper,
+											numberConstraintsG, g, lambda, 0, NULL, NULL);
+
+	EXPECT_THAT(trajectoryOptimizer->getSolution().x, ElementsAre(9, -9));
+	EXPECT_THAT(trajectoryOptimizer->getStartingPoint().x, ElementsAre(0.5, 1.5));
+	EXPECT_THAT(trajectoryOptimizer->getStartingPoint().lambda, ElementsAre(-1));
+}
+
+TEST_F(warmStartTest, WarmStartedResolveNeedsFewerIterations) {
+	SmartPtr<TrajectoryOptimizer> trajectoryOptimizer = createOptimizer();
+	SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
+	app->Options()->SetNumericValue("tol", 1e-9);
+	app->Options()->SetIntegerValue("print_level", 0);
+	ASSERT_EQ(Solve_Succeeded, app->Initialize());
+
+	ASSERT_EQ(Solve_Succeeded, app->OptimizeTNLP(trajectoryOptimizer));
+	const Index coldIterations = app->Statistics()->IterationCount();
+	EXPECT_NEAR(0.5, trajectoryOptimizer->getSolution().x[0], 1e-6);
+	EXPECT_NEAR(1.5, trajectoryOptimizer->getSolution().x[1], 1e-6);
+
+	const PrimalDualPoint coldSolution = trajectoryOptimizer->getSolution();
+	EXPECT_THAT(trajectoryOptimizer->getStartingPoint().x, ContainerEq(coldSolution.x));
+	EXPECT_THAT(trajectoryOptimizer->getStartingPoint().lambda, ContainerEq(coldSolution.lambda));
+
+	enableWarmStart(app);
+	ASSERT_EQ(Solve_Succeeded, app->OptimizeTNLP(trajectoryOptimizer));
+	const Index warmIterations = app->Statistics()->IterationCount();
+
+	EXPECT_LT(warmIterations, coldIterations);
+	EXPECT_NEAR(0.5, trajectoryOptimizer->getSolution().x[0], 1e-6);
+}
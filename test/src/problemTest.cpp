@@ -0,0 +1,142 @@
+#include <gtest/gtest.h> 
+#include <gmock/gmock.h>
+#include "coin/IpIpoptApplication.hpp"
+#include "trajectoryOptimization/cost.hpp"
+#include "trajectoryOptimization/problem.hpp"
+
+using namespace trajectoryOptimization;
+using namespace trajectoryOptimization::problem;
+using namespace testing;
+
+class trajectoryProblemTest : public::testing::Test {
+	protected:
+		const unsigned numberOfPoints = 5;
+		const unsigned positionDimension = 1;
+		const unsigned controlDimension = 1;
+		const unsigned pointDimension = 3;
+		const unsigned kinematicDimension = 2;
+		const double timeStepSize = 0.1;
+		const cost::WeightedCostSum<cost::GetControlSquareSum> costSum =
+			cost::WeightedCostSum(numberOfPoints,
+									cost::WeightedCostTerm("control", 1.0,
+															cost::GetControlSquareSum(numberOfPoints, pointDimension, controlDimension)));
+		StructureCache cache;
+
+		TrajectoryProblem createProblem(const std::vector<double>& goal) {
+			TrajectoryProblem trajectoryProblem(numberOfPoints, positionDimension, controlDimension, timeStepSize,
+												dynamic::BlockDynamics);
+			trajectoryProblem.addKinematicGoal(0, kinematicDimension, {0, 0})
+								.addKinematicGoal(numberOfPoints - 1, kinematicDimension, goal)
+								.setObjective(costSum, true)
+								.setPointBounds({-10, -10, -10}, {10, 10, 10});
+			return trajectoryProblem;
+		}
+};
+
+TEST_F(trajectoryProblemTest, StructureIsCachedAcrossGoalValues) {
+	const auto first = createProblem({1, 0}).getFunctions(cache);
+	const auto second = createProblem({2, 0.5}).getFunctions(cache);
+
+	EXPECT_EQ(1u, cache.getMisses());
+	EXPECT_EQ(1u, cache.getHits());
+	EXPECT_EQ(first.structure, second.structure);
+}
+
+TEST_F(trajectoryProblemTest, NewConstraintChangesStructure) {
+	createProblem({1, 0}).getFunctions(cache);
+	auto withWaypoint = createProblem({1, 0});
+	withWaypoint.addKinematicGoal(2, 1, {0.5});
+	const auto functions = withWaypoint.getFunctions(cache);
+
+	EXPECT_EQ(2u, cache.getMisses());
+	EXPECT_EQ(0u, cache.getHits());
+	EXPECT_EQ(2 * (numberOfPoints - 1) + 2 * kinematicDimension + 1, functions.structure->numberConstraints);
+}
+
+TEST_F(trajectoryProblemTest, SignatureFollowsDetectedPatterns) {
+	auto first = createProblem({1, 0});
+	first.addConstraint([](const double* x) { return std::vector<double>{x[2] * x[2] - 1}; });
+	auto samePattern = createProblem({1, 0});
+	samePattern.addConstraint([](const double* x) { return std::vector<double>{x[2] - 2}; });
+	auto otherPattern = createProblem({1, 0});
+	otherPattern.addConstraint([](const double* x) { return std::vector<double>{x[5] - 2}; });
+
+	EXPECT_EQ(first.getStructureSignature(), samePattern.getStructureSignature());
+	EXPECT_NE(first.getStructureSignature(), otherPattern.getStructureSignature());
+	first.getFunctions(cache);
+	const auto functions = samePattern.getFunctions(cache);
+	EXPECT_EQ(1u, cache.getHits());
+
+	numberVector x(numberOfPoints * pointDimension, 0);
+	x[2] = 3;
+	numberVector g(functions.structure->numberConstraints);
+	functions.constraintFunction(x.size(), x.data(), g.size(), g.data());
+	EXPECT_DOUBLE_EQ(1, g.back());
+}
+
+TEST_F(trajectoryProblemTest, DynamicsComeFirstThenGoals) {
+	const std::vector<double> goal = {1, 0};
+	const auto functions = createProblem(goal).getFunctions(cache);
+	const auto& structure = *functions.structure;
+	ASSERT_THAT(structure.blockRowOffsets.size(), Eq(numberOfPoints + 1));
+	EXPECT_EQ(2 * (numberOfPoints - 1), structure.blockRowOffsets[numberOfPoints - 1]);
+
+	const numberVector x(numberOfPoints * pointDimension, 0);
+	numberVector g(structure.numberConstraints);
+	functions.constraintFunction(x.size(), x.data(), g.size(), g.data());
+	const unsigned goalRow = structure.blockRowOffsets[numberOfPoints];
+	EXPECT_DOUBLE_EQ(-goal[0], g[goalRow]);
+	EXPECT_DOUBLE_EQ(-goal[1], g[goalRow + 1]);
+}
+
+TEST_F(trajectoryProblemTest, ExactHessianUsesObjectivePattern) {
+	const auto functions = createProblem({1, 0}).getFunctions(cache);
+	EXPECT_EQ(costSum.getHessianRows(), functions.structure->sparsityStructure->hessianRows);
+	EXPECT_EQ(costSum.getHessianCols(), functions.structure->sparsityStructure->hessianCols);
+
+	auto withoutHessian = createProblem({1, 0});
+	withoutHessian.setObjective(costSum, false);
+	EXPECT_NE(createProblem({1, 0}).getStructureSignature(), withoutHessian.getStructureSignature());
+	EXPECT_TRUE(withoutHessian.getFunctions(cache).structure->sparsityStructure->hessianRows.empty());
+}
+
+TEST_F(trajectoryProblemTest, BuildsOptimizerWithProblemSizes) {
+	const SmartPtr<TrajectoryOptimizer> trajectoryOptimizer =
+		createProblem({1, 0}).build([](SolverReturn status, Index n, const Number* x,
+										const Number* zLower, const Number* zUpper,
+										Index m, const Number* g, const Number* lambda,
+										Number objValue, const IpoptData* ipData,
+										IpoptCalculatedQuantities* ipCalculatedQuantities) {}, cache);
+	Index n, m, nnzJacobian, nnzHessian;
+	TNLP::IndexStyleEnum indexStyle;
+	trajectoryOptimizer->get_nlp_info(n, m, nnzJacobian, nnzHessian, indexStyle);
+
+	EXPECT_EQ(numberOfPoints * pointDimension, n);
+	EXPECT_EQ(2 * (numberOfPoints - 1) + 2 * kinematicDimension, m);
+	EXPECT_EQ(costSum.getHessianRows().size(), nnzHessian);
+	EXPECT_DOUBLE_EQ(-10, trajectoryOptimizer->getVariableLowerBounds()[4]);
+}
+
+TEST_F(trajectoryProblemTest, SolvesWithoutExactHessian) {
+	auto withoutHessian = createProblem({1, 0});
+	withoutHessian.setObjective(costSum, false);
+	numberVector solution;
+	const SmartPtr<TrajectoryOptimizer> trajectoryOptimizer =
+		withoutHessian.build([&solution](SolverReturn status, Index n, const Number* x,
+											const Number* zLower, const Number* zUpper,
+											Index m, const Number* g, const Number* lambda,
+											Number objValue, const IpoptData* ipData,
+											IpoptCalculatedQuantities* ipCalculatedQuantities) {
+									solution.assign(x, x + n);
+								}, cache);
+	SmartPtr<IpoptApplication> app = IpoptApplicationFactory();
+	app->Options()->SetIntegerValue("print_level", 0);
+	ASSERT_EQ(Solve_Succeeded, app->Initialize());
+	setHessianApproximation(app, trajectoryOptimizer->getSparsityStructure());
+	ASSERT_EQ(Solve_Succeeded, app->OptimizeTNLP(trajectoryOptimizer));
+
+	ASSERT_EQ(numberOfPoints * pointDimension, solution.size());
+	const unsigned lastPoint = (numberOfPoints - 1) * pointDimension;
+	EXPECT_NEAR(1, solution[lastPoint], 1e-6);
+	EXPECT_NEAR(0, solution[lastPoint + 1], 1e-6);
+}
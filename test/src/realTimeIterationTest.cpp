@@ -0,0 +1,127 @@
+#include <gtest/gtest.h> 
+#include <gmock/gmock.h>
+#include <cmath>
+#include "trajectoryOptimization/constraint.hpp"
+#include "trajectoryOptimization/cost.hpp"
+#include "trajectoryOptimization/derivative.hpp"
+#include "trajectoryOptimization/realTimeIteration.hpp"
+
+using namespace trajectoryOptimization;
+using namespace trajectoryOptimization::rti;
+using namespace testing;
+
+// Block in one dimension driven to rest at 1 with minimum control effort, the start is measured
+class realTimeIterationTest : public::testing::Test {
+	protected:
+		const unsigned numberOfPoints = 11;
+		const unsigned worldDimension = 1;
+		const unsigned kinematicDimension = 2;
+		const unsigned controlDimension = 1;
+		const unsigned pointDimension = 3;
+		const unsigned numberVariables = numberOfPoints * pointDimension;
+		const double timeStepSize = 0.1;
+		const numberVector xLowerBounds = numberVector(numberVariables, -100);
+		const numberVector xUpperBounds = numberVector(numberVariables, 100);
+		const cost::WeightedCostSum<cost::GetControlSquareSum> costSum =
+			cost::WeightedCostSum(numberOfPoints,
+									cost::WeightedCostTerm("control", 1.0,
+															cost::GetControlSquareSum(numberOfPoints, pointDimension, controlDimension)));
+
+		std::vector<constraint::ConstraintFunction> constraints;
+		numberVector gBounds;
+		std::shared_ptr<const SparsityStructure> sparsityStructure;
+		EvaluateObjectiveFunction objectiveFunction;
+		EvaluateGradientInPlaceFunction gradientFunction;
+		EvaluateConstraintInPlaceFunction constraintFunction;
+		GetJacobianValueInPlaceFunction jacobianValueFunction;
+		GetHessianValueInPlaceFunction hessianValueFunction;
+
+		void SetUp() {
+			constraints = constraint::applyKinematicViolationConstraints(constraints, dynamic::BlockDynamics, pointDimension,
+																			worldDimension, 0, numberOfPoints - 1, timeStepSize);
+			constraints.push_back(constraint::GetToKinematicGoal(numberOfPoints, pointDimension, kinematicDimension,
+																	numberOfPoints - 1, {1, 0}));
+
+			auto stackedConstraints = constraint::StackConstriants(numberVariables, constraints);
+			const constraint::ConstraintFunction stackedConstraintFunction = stackedConstraints;
+			gBounds = numberVector(stackedConstraints.size(), 0);
+			constraintFunction = [stackedConstraints](Index n, const Number* x, Index m, Number* g) mutable {
+				stackedConstraints(x, g);
+			};
+			const auto [jacobianRows, jacobianCols] =
+				derivative::GetSparsityPatternOfVectorToVectorFunction(stackedConstraintFunction, numberVariables)();
+			const auto evaluateJacobian =
+				derivative::GetJacobianOfVectorToVectorFunctionUsingSparsityPattern(stackedConstraintFunction, numberVariables,
+																					jacobianRows, jacobianCols);
+			jacobianValueFunction = [evaluateJacobian](Index n, const Number* x, Index m, Index numberElementsJacobian,
+														Number* values) {
+				evaluateJacobian(x, values);
+			};
+			sparsityStructure = makeSparsityStructure(jacobianRows, jacobianCols,
+														costSum.getHessianRows(), costSum.getHessianCols());
+
+			objectiveFunction = [this](Index n, const Number* x) { return costSum(x); };
+			gradientFunction = [this](Index n, const Number* x, Number* gradient) { costSum.gradient(x, n, gradient); };
+			hessianValueFunction = [this](Index n, const Number* x, const Number objFactor, Index m, const Number* lambda,
+											Index numberElementsHessian, Number* values) {
+				costSum.hessian(objFactor, values);
+			};
+		}
+
+		RealTimeIteration createRealTimeIteration(const indexVector& constraintShiftMap) {
+			return RealTimeIteration(xLowerBounds, xUpperBounds, gBounds, gBounds, numberVector(numberVariables, 0),
+										gradientFunction, constraintFunction, jacobianValueFunction, hessianValueFunction,
+										sparsityStructure, pointDimension, kinematicDimension, constraintShiftMap);
+		}
+};
+
+TEST_F(realTimeIterationTest, OneStepSolvesLinearQuadraticProblem) {
+	auto realTimeIteration = createRealTimeIteration({});
+	const numberVector measuredKinematics = {0.2, -0.1};
+	ASSERT_TRUE(realTimeIteration.prepare());
+	ASSERT_EQ(SUCCESS, realTimeIteration.feedback(measuredKinematics).status);
+
+	numberVector lowerBounds = xLowerBounds;
+	numberVector upperBounds = xUpperBounds;
+	std::copy(measuredKinematics.begin(), measuredKinematics.end(), lowerBounds.begin());
+	std::copy(measuredKinematics.begin(), measuredKinematics.end(), upperBounds.begin());
+	const auto problem = detectLinearQuadratic(lowerBounds, upperBounds, gBounds, gBounds,
+												objectiveFunction, gradientFunction, constraintFunction, jacobianValueFunction,
+												sparsityStructure->jacobianRows, sparsityStructure->jacobianCols,
+												hessianValueFunction, sparsityStructure->hessianRows, sparsityStructure->hessianCols);
+	ASSERT_TRUE(problem.has_value());
+	const auto expected = solveLinearQuadratic(*problem);
+
+	const auto& solution = realTimeIteration.getSolution();
+	ASSERT_EQ(expected.solution.x.size(), solution.x.size());
+	for (unsigned index = 0; index < solution.x.size(); index++) {
+		EXPECT_NEAR(expected.solution.x[index], solution.x[index], 1e-9);
+	}
+}
+
+TEST_F(realTimeIterationTest, EveryTickIsFeasibleForItsMeasurement) {
+	const indexVector constraintShiftMap = mpc::getConstraintShiftMap(gBounds.size(), 0, 2 * worldDimension,
+																		numberOfPoints - 1);
+	auto realTimeIteration = createRealTimeIteration(constraintShiftMap);
+	numberVector measuredKinematics = {0, 0};
+
+	for (unsigned tick = 0; tick < 5; tick++) {
+		ASSERT_TRUE(realTimeIteration.prepare());
+		const auto result = realTimeIteration.feedback(measuredKinematics);
+		ASSERT_EQ(SUCCESS, result.status);
+		EXPECT_GE(result.preparationSeconds, 0);
+		EXPECT_GE(result.feedbackSeconds, 0);
+
+		const auto& solution = realTimeIteration.getSolution();
+		EXPECT_DOUBLE_EQ(measuredKinematics[0], solution.x[0]);
+		EXPECT_DOUBLE_EQ(measuredKinematics[1], solution.x[1]);
+		numberVector g(gBounds.size());
+		constraintFunction(numberVariables, solution.x.data(), g.size(), g.data());
+		for (const auto constraintValue: g) {
+			EXPECT_NEAR(0, constraintValue, 1e-8);
+		}
+
+		// The plant follows the plan with a small disturbance
+		measuredKinematics = {solution.x[pointDimension] + 0.01, solution.x[pointDimension + 1]};
+	}
+}
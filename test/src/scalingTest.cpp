@@ -0,0 +1,79 @@
+#include <gtest/gtest.h> 
+#include <gmock/gmock.h>
+#include "trajectoryOptimization/scaling.hpp"
+
+using namespace trajectoryOptimization::scaling;
+using namespace testing;
+
+TEST(scalingTest, VariableScalingFromBounds) {
+	const numberVector xLowerBounds = {-100, 0, -1e19, 2, -1e19};
+	const numberVector xUpperBounds = {50, 0.5, 4, 2, 1e19};
+	EXPECT_THAT(getVariableScalingFromBounds(xLowerBounds, xUpperBounds), ElementsAre(0.01, 2, 0.25, 1, 1));
+}
+
+TEST(scalingTest, VariableScalingFromMagnitudes) {
+	EXPECT_THAT(getVariableScalingFromMagnitudes(2, {10, 0.5}), ElementsAre(0.1, 2, 0.1, 2));
+}
+
+TEST(scalingTest, ConstraintScalingLimitsScaledGradient) {
+	// Row 0: 1000 and 1, row 1: 10 and 0.5
+	const indexVector jacobianRows = {0, 0, 1, 1};
+	const indexVector jacobianCols = {0, 1, 0, 1};
+	const numberVector jacobianValues = {1000, 1, 10, 0.5};
+	const numberVector xScaling = {1, 0.001};
+
+	const auto gScaling = getConstraintScalingFromJacobian(2, jacobianRows, jacobianCols, jacobianValues, xScaling);
+	EXPECT_DOUBLE_EQ(0.1, gScaling[0]);
+	EXPECT_DOUBLE_EQ(0.2, gScaling[1]);
+}
+
+TEST(scalingTest, ObjectiveScalingFromGradient) {
+	EXPECT_DOUBLE_EQ(0.5, getObjectiveScalingFromGradient({200, -1}, {1, 1}));
+	EXPECT_DOUBLE_EQ(1, getObjectiveScalingFromGradient({2, -1}, {1, 1}));
+}
+
+TEST(scalingTest, AutomaticScalingHandedToIpopt) {
+	const auto sparsityStructure = makeSparsityStructure({0, 0}, {0, 1}, {}, {});
+	const EvaluateGradientInPlaceFunction gradientFunction = [](Index n, const Number* x, Number* gradient) {
+		gradient[0] = 1000 * x[0];
+		gradient[1] = 1;
+	};
+	const GetJacobianValueInPlaceFunction jacobianValueFunction = [](Index n, const Number* x, Index m,
+																		Index numberElementsJacobian, Number* values) {
+		values[0] = 500;
+		values[1] = 1;
+	};
+	const auto scaling = computeAutomaticScaling({-10, -1}, {10, 1}, {1, 0}, gradientFunction, jacobianValueFunction,
+													*sparsityStructure, 1, {2, 1});
+	EXPECT_THAT(scaling.xScaling, ElementsAre(0.5, 1));
+	EXPECT_DOUBLE_EQ(0.05, scaling.objectiveScaling);
+	EXPECT_THAT(scaling.gScaling, ElementsAre(0.1));
+	EXPECT_THAT(describeScaling(scaling), StartsWith("objective 5.000000e-02, x [5.000000e-01, 1.000000e+00]"));
+
+	SmartPtr<TrajectoryOptimizer> trajectoryOptimizer =
+		new TrajectoryOptimizer({-10, -1}, {10, 1}, {0}, {0}, {1, 0},
+								[](Index n, const Number* x) { return 0.0; },
+								gradientFunction,
+								[](Index n, const Number* x, Index m, Number* g) {},
+								jacobianValueFunction,
+								[](Index n, const Number* x, const Number objFactor, Index m, const Number* lambda,
+									Index numberElementsHessian, Number* values) {},
+								[](SolverReturn status, Index n, const Number* x,
+									const Number* zLower, const Number* zUpper,
+									Index m, const Number* g, const Number* lambda,
+									Number objValue, const IpoptData* ipData,
+									IpoptCalculatedQuantities* ipCalculatedQuantities) {},
+								sparsityStructure);
+	trajectoryOptimizer->setScaling(scaling);
+
+	Number objectiveScaling;
+	bool useXScaling, useGScaling;
+	numberVector xScaling(2), gScaling(1);
+	trajectoryOptimizer->get_scaling_parameters(objectiveScaling, useXScaling, 2, xScaling.data(),
+												useGScaling, 1, gScaling.data());
+	EXPECT_DOUBLE_EQ(0.05, objectiveScaling);
+	EXPECT_TRUE(useXScaling);
+	EXPECT_TRUE(useGScaling);
+	EXPECT_THAT(xScaling, ElementsAre(0.5, 1));
+	EXPECT_THAT(gScaling, ElementsAre(0.1));
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <random>
+#include "trajectoryOptimization/solutionLibrary.hpp"
+
+using namespace trajectoryOptimization::solutionLibrary;
+using namespace testing;
+
+class solutionLibraryTest : public::testing::Test {
+	protected:
+		const std::string filename = ::testing::TempDir() + "solutionLibraryTest.index";
+
+		// One point of one position, one velocity and no control per solution
+		TrajectoryRecord makeRecord(const double position, const unsigned numberOfPoints = 1) {
+			TrajectoryRecord record = {1, 0, 0.1, {}, SUCCESS, position, {}};
+			for (unsigned timeIndex = 0; timeIndex < numberOfPoints; timeIndex++) {
+				record.solution.x.insert(record.solution.x.end(), {position, 0});
+			}
+			record.solution.zLower = numberVector(record.solution.x.size(), 1);
+			record.solution.zUpper = numberVector(record.solution.x.size(), 2);
+			record.solution.lambda = {position};
+			return record;
+		}
+};
+
+TEST_F(solutionLibraryTest, KeysConcatenateParameters) {
+	EXPECT_THAT(makeKey({1, 2}, {3}, {{4, 5}, {6}}), ElementsAre(1, 2, 3, 4, 5, 6));
+}
+
+TEST_F(solutionLibraryTest, NearestMatchesExhaustiveSearch) {
+	const unsigned keyDimension = 3;
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<double> distribution(-1, 1);
+	KdTree tree(keyDimension);
+	std::vector<numberVector> keys;
+	// Sorted keys make runtime insertions degenerate and force rebuilds
+	for (unsigned entry = 0; entry < 500; entry++) {
+		keys.push_back({entry * 0.01, distribution(generator), distribution(generator)});
+		tree.insert(keys.back().data());
+		if (entry == 250) {
+			tree.rebuild();
+		}
+	}
+
+	for (unsigned query = 0; query < 20; query++) {
+		const numberVector key = {distribution(generator) + 2.5, distribution(generator), distribution(generator)};
+		std::vector<std::pair<double, unsigned>> exhaustive;
+		for (unsigned entry = 0; entry < keys.size(); entry++) {
+			double squaredDistance = 0;
+			for (unsigned index = 0; index < keyDimension; index++) {
+				squaredDistance += std::pow(key[index] - keys[entry][index], 2);
+			}
+			exhaustive.push_back({squaredDistance, entry});
+		}
+		std::sort(exhaustive.begin(), exhaustive.end());
+
+		const auto neighbors = tree.nearest(key.data(), 5);
+		ASSERT_EQ(5u, neighbors.size());
+		for (unsigned rank = 0; rank < neighbors.size(); rank++) {
+			EXPECT_EQ(exhaustive[rank].second, neighbors[rank].entry);
+			EXPECT_DOUBLE_EQ(exhaustive[rank].first, neighbors[rank].squaredDistance);
+		}
+	}
+}
+
+TEST_F(solutionLibraryTest, FewerEntriesThanRequested) {
+	SolutionLibrary library(1);
+	EXPECT_TRUE(library.nearest({0}, 3).empty());
+	library.insert({2}, makeRecord(2));
+	library.insert({-1}, makeRecord(-1));
+	const auto neighbors = library.nearest({0}, 3);
+	ASSERT_EQ(2u, neighbors.size());
+	EXPECT_EQ(1u, neighbors[0].entry);
+	EXPECT_EQ(0u, neighbors[1].entry);
+}
+
+TEST_F(solutionLibraryTest, SaveAndLoadKeepIndexAndSolutions) {
+	SolutionLibrary library(2);
+	for (int entry = 0; entry < 20; entry++) {
+		library.insert({(double) entry, (double) -entry}, makeRecord(entry));
+	}
+	ASSERT_TRUE(library.save(filename));
+
+	SolutionLibrary loaded(1);
+	ASSERT_TRUE(loaded.load(filename));
+	EXPECT_EQ(2u, loaded.getKeyDimension());
+	ASSERT_EQ(20u, loaded.size());
+	EXPECT_THAT(loaded.getKey(7), ElementsAre(7, -7));
+	EXPECT_THAT(loaded.getRecord(7).solution.lambda, ElementsAre(7));
+	EXPECT_EQ(13u, loaded.nearest({13.2, -12.9}, 1)[0].entry);
+
+	loaded.insert({100, -100}, makeRecord(100));
+	EXPECT_EQ(20u, loaded.nearest({99, -99}, 1)[0].entry);
+
+	SolutionLibrary missing(2);
+	EXPECT_FALSE(missing.load(filename + ".missing"));
+	EXPECT_EQ(0u, missing.size());
+}
+
+TEST_F(solutionLibraryTest, WarmStartSkipsSolutionsOfOtherSizes) {
+	SmartPtr<TrajectoryOptimizer> trajectoryOptimizer =
+		new TrajectoryOptimizer(numberVector{-10, -10, -10, -10}, numberVector{10, 10, 10, 10}, numberVector{0}, numberVector{0},
+								numberVector{0, 0, 0, 0},
+								[](Index n, const Number* x) { return 0.0; },
+								[](Index n, const Number* x) { return numberVector(n, 0); },
+								[](Index n, const Number* x, Index m) { return numberVector{x[0]}; },
+								[](Index n, const Number* x, Index m, Index numberElementsJacobian) { return numberVector{1}; },
+								[](Index n, const Number* x, Number objFactor, Index m, const Number* lambda,
+									Index numberElementsHessian) { return numberVector{}; },
+								[](SolverReturn status, Index n, const Number* x, const Number* zLower,
+									const Number* zUpper, Index m, const Number* g, const Number* lambda,
+									Number objValue, const IpoptData* ipData,
+									IpoptCalculatedQuantities* ipCalculatedQuantities) {},
+								makeSparsityStructure({0}, {0}, {}, {}));
+
+	SolutionLibrary library(1);
+	EXPECT_FALSE(library.setWarmStart(*trajectoryOptimizer, {0}));
+	library.insert({0}, makeRecord(0, 3));
+	library.insert({1}, makeRecord(1, 2));
+	library.insert({5}, makeRecord(5, 2));
+
+	ASSERT_TRUE(library.setWarmStart(*trajectoryOptimizer, {0.2}));
+	const auto& startingPoint = trajectoryOptimizer->getStartingPoint();
+	EXPECT_THAT(startingPoint.x, ElementsAre(1, 0, 1, 0));
+	EXPECT_THAT(startingPoint.zLower, Each(1));
+	EXPECT_THAT(startingPoint.lambda, ElementsAre(1));
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <memory>
+#include <vector>
+#include "trajectoryOptimization/sparsity.hpp"
+
+using namespace testing;
+using namespace trajectoryOptimization::sparsity;
+
+TEST(sparsityTest, PatternIsRowMajorWithoutRepeats) {
+	const SparsityPattern pattern(3, 3, {2, 0, 1, 0, 2}, {1, 2, 0, 2, 0});
+	EXPECT_EQ(4u, pattern.size());
+	EXPECT_THAT(pattern.getRows(), ElementsAre(0, 1, 2, 2));
+	EXPECT_THAT(pattern.getCols(), ElementsAre(2, 0, 0, 1));
+	EXPECT_EQ(3, pattern.find(2, 1));
+	EXPECT_EQ(-1, pattern.find(1, 1));
+	EXPECT_EQ(pattern, SparsityPattern(3, 3, {0, 1, 2, 2}, {2, 0, 0, 1}));
+	EXPECT_NE(pattern, SparsityPattern(3, 4, {0, 1, 2, 2}, {2, 0, 0, 1}));
+}
+
+TEST(sparsityTest, CompressesRowsAndCols) {
+	const SparsityPattern pattern(3, 3, {0, 0, 2, 2}, {0, 2, 1, 2});
+
+	const auto compressedRows = pattern.getCompressedRows();
+	EXPECT_THAT(compressedRows.offsets, ElementsAre(0, 2, 2, 4));
+	EXPECT_THAT(compressedRows.indices, ElementsAre(0, 2, 1, 2));
+	EXPECT_THAT(compressedRows.entries, ElementsAre(0, 1, 2, 3));
+
+	const auto compressedCols = pattern.getCompressedCols();
+	EXPECT_THAT(compressedCols.offsets, ElementsAre(0, 1, 2, 4));
+	EXPECT_THAT(compressedCols.indices, ElementsAre(0, 2, 0, 2));
+	EXPECT_THAT(compressedCols.entries, ElementsAre(0, 2, 1, 3));
+}
+
+TEST(sparsityTest, StacksBlocksIntoOnePattern) {
+	const SparsityPattern upper(1, 3, {0, 0}, {0, 1});
+	const SparsityPattern lower(2, 3, {0, 1, 1}, {1, 1, 2});
+	const SparsityPattern stacked = unite(placeBlock(upper, 3, 3, 0, 0), placeBlock(lower, 3, 3, 1, 0));
+	EXPECT_THAT(stacked.getRows(), ElementsAre(0, 0, 1, 2, 2));
+	EXPECT_THAT(stacked.getCols(), ElementsAre(0, 1, 1, 1, 2));
+	EXPECT_THAT(getIndexMap(upper, stacked), ElementsAre(0, 1));
+	EXPECT_THAT(getIndexMap(lower, stacked, 1, 0), ElementsAre(2, 3, 4));
+}
+
+TEST(sparsityTest, UnitesManyOverlappingBlocksAtOnce) {
+	const SparsityPattern interval(1, 4, {0, 0, 0}, {0, 1, 2});
+	const SparsityPattern united = unite({placeBlock(interval, 2, 6, 1, 2),
+											placeBlock(interval, 2, 6, 0, 0),
+											placeBlock(interval, 2, 6, 1, 1)});
+	EXPECT_THAT(united.getRows(), ElementsAre(0, 0, 0, 1, 1, 1, 1));
+	EXPECT_THAT(united.getCols(), ElementsAre(0, 1, 2, 1, 2, 3, 4));
+	EXPECT_EQ(hashPattern(united), hashPattern(SparsityPattern(2, 6, united.getRows(), united.getCols())));
+	EXPECT_NE(hashPattern(united), hashPattern(placeBlock(interval, 2, 6, 0, 0)));
+}
+
+TEST(sparsityTest, MapsSymmetricEntriesIntoLowerTriangle) {
+	const std::vector<int> rows = {0, 0, 1, 1};
+	const std::vector<int> cols = {0, 1, 0, 1};
+	const SparsityPattern lowerTriangle = getLowerTriangle(SparsityPattern(2, 2, rows, cols));
+	EXPECT_THAT(lowerTriangle.getRows(), ElementsAre(0, 1, 1));
+	EXPECT_THAT(lowerTriangle.getCols(), ElementsAre(0, 0, 1));
+
+	const IndexMap indexMap = getIndexMap(rows, cols, lowerTriangle, 0, 0, true);
+	EXPECT_THAT(indexMap, ElementsAre(0, 1, 1, 2));
+	std::vector<double> values(lowerTriangle.size(), 0);
+	assemble(indexMap, std::vector<double>{1, 2, 3, 4}.data(), values.data());
+	EXPECT_THAT(values, ElementsAre(1, 5, 4));
+}
+
+TEST(sparsityTest, MultipliesAssembledMatrix) {
+	// [1 2 0]
+	// [0 0 3]
+	const auto pattern = std::make_shared<const SparsityPattern>(2, 3, std::vector<int>{0, 0, 1}, std::vector<int>{0, 1, 2});
+	SparseMatrix matrix(pattern);
+	matrix.add({0, 1, 2}, std::vector<double>{0.5, 1, 1.5}.data(), 2);
+	EXPECT_THAT(matrix.getValues(), ElementsAre(1, 2, 3));
+	EXPECT_THAT(matrix.multiply({1, 1, 1}), ElementsAre(3, 3));
+	EXPECT_THAT(matrix.multiplyTransposed({1, 2}), ElementsAre(1, 2, 6));
+
+	matrix.setZero();
+	EXPECT_THAT(matrix.getValues(), ElementsAre(0, 0, 0));
+}
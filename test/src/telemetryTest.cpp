@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <string>
+#include <unistd.h>
+#include "trajectoryOptimization/telemetry.hpp"
+
+using namespace trajectoryOptimization::telemetry;
+using namespace testing;
+
+class telemetryTest : public::testing::Test {
+	protected:
+		const std::string name = "/trajectoryOptimizationTelemetryTest" + std::to_string(getpid());
+
+		Sample makeSample(const int iteration) {
+			return {iteration, 0, 10.0 - iteration, 1.0 / (iteration + 1), 0, 0.1, 0, 0, 0, 0, 0};
+		}
+};
+
+TEST_F(telemetryTest, ReaderSeesSamplesInOrder) {
+	TelemetryWriter writer(name, 8);
+	ASSERT_TRUE(writer.isOpen());
+	TelemetryReader reader(name);
+	ASSERT_TRUE(reader.isOpen());
+
+	std::vector<Record> records;
+	EXPECT_EQ(0u, reader.poll(records));
+	writer.publish(makeSample(0));
+	writer.publish(makeSample(1));
+	EXPECT_EQ(2u, reader.poll(records));
+	writer.publish(makeSample(2));
+	EXPECT_EQ(1u, reader.poll(records));
+
+	ASSERT_EQ(3u, records.size());
+	for (int iteration = 0; iteration < 3; iteration++) {
+		EXPECT_EQ(iteration, records[iteration].sample.iteration);
+		EXPECT_DOUBLE_EQ(10.0 - iteration, records[iteration].sample.objectiveValue);
+		EXPECT_TRUE(records[iteration].trajectory.empty());
+	}
+	EXPECT_EQ(0u, reader.getLost());
+}
+
+TEST_F(telemetryTest, SlowReaderLosesOldestSamples) {
+	TelemetryWriter writer(name, 4);
+	TelemetryReader reader(name);
+	for (int iteration = 0; iteration < 10; iteration++) {
+		writer.publish(makeSample(iteration));
+	}
+
+	std::vector<Record> records;
+	EXPECT_EQ(4u, reader.poll(records));
+	EXPECT_EQ(6u, reader.getLost());
+	EXPECT_EQ(6, records.front().sample.iteration);
+	EXPECT_EQ(9, records.back().sample.iteration);
+}
+
+TEST_F(telemetryTest, TrajectoryIsDownsampled) {
+	// Five points of [position, velocity], three stored: points 0, 2 and 4
+	TelemetryWriter writer(name, 2, 3, 2);
+	TelemetryReader reader(name);
+	const std::vector<double> x = {0, 0, 1, 10, 2, 20, 3, 30, 4, 40};
+	writer.publish(makeSample(0), x.data(), 5);
+	writer.publish(makeSample(1));
+
+	std::vector<Record> records;
+	reader.poll(records);
+	ASSERT_EQ(2u, records.size());
+	EXPECT_EQ(3u, records[0].sample.numberOfStoredPoints);
+	EXPECT_THAT(records[0].trajectory, ElementsAre(0, 0, 2, 20, 4, 40));
+	EXPECT_EQ(0u, records[1].sample.numberOfStoredPoints);
+	EXPECT_TRUE(records[1].trajectory.empty());
+}
+
+TEST_F(telemetryTest, NoSegmentNoReader) {
+	TelemetryReader reader(name);
+	EXPECT_FALSE(reader.isOpen());
+	std::vector<Record> records;
+	EXPECT_EQ(0u, reader.poll(records));
+}
+
+TEST_F(telemetryTest, IntermediateCallbackPublishesIterate) {
+	SmartPtr<TrajectoryOptimizer> trajectoryOptimizer =
+		new TrajectoryOptimizer(numberVector{-10, -10}, numberVector{10, 10}, numberVector{}, numberVector{},
+								numberVector{1, 2},
+								[](Index n, const Number* x) { return x[0] * x[0] + x[1] * x[1]; },
+								[](Index n, const Number* x) { return numberVector{2 * x[0], 2 * x[1]}; },
+								[](Index n, const Number* x, Index m) { return numberVector{}; },
+								[](Index n, const Number* x, Index m, Index numberElementsJacobian) { return numberVector{}; },
+								[](Index n, const Number* x, Number objFactor, Index m, const Number* lambda,
+									Index numberElementsHessian) { return numberVector{}; },
+								[](SolverReturn status, Index n, const Number* x, const Number* zLower,
+									const Number* zUpper, Index m, const Number* g, const Number* lambda,
+									Number objValue, const IpoptData* ipData,
+									IpoptCalculatedQuantities* ipCalculatedQuantities) {},
+								makeSparsityStructure({}, {}, {}, {}));
+	const auto writer = std::make_shared<TelemetryWriter>(name, 4, 2, 1);
+	TelemetryReader reader(name);
+	trajectoryOptimizer->setIntermediateFunction(makeTelemetryFunction(writer, trajectoryOptimizer, 1));
+
+	const numberVector x = {3, 4};
+	numberVector gradient(2);
+	trajectoryOptimizer->eval_grad_f(2, x.data(), true, gradient.data());
+	EXPECT_TRUE(trajectoryOptimizer->intermediate_callback(RegularMode, 0, 25, 0, 6, 0.1, 0, 0, 1, 1, 0, nullptr, nullptr));
+
+	std::vector<Record> records;
+	ASSERT_EQ(1u, reader.poll(records));
+	EXPECT_DOUBLE_EQ(25, records[0].sample.objectiveValue);
+	EXPECT_DOUBLE_EQ(6, records[0].sample.dualInfeasibility);
+	EXPECT_THAT(records[0].trajectory, ElementsAre(3, 4));
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <fstream>
+#include <sstream>
+#include "trajectoryOptimization/trajectoryFile.hpp"
+
+using namespace trajectoryOptimization::trajectoryFile;
+using namespace testing;
+
+class trajectoryFileTest : public::testing::Test {
+	protected:
+		const std::string filename = ::testing::TempDir() + "trajectoryFileTest.traj";
+		// One position, two controls, two points
+		const TrajectoryRecord withMultipliers = {1, 2, 0.5, {}, SUCCESS, 1.25,
+													{{0, 1, 2, 3, 4, 5, 6, 7}, {0, 0, 0, 1, 0, 0, 0, 2}, {1, 0, 0, 0, 2, 0, 0, 0}, {-1, -2}}};
+		const TrajectoryRecord primalOnly = {1, 1, 0, {0.25, 0.75}, MAXITER_EXCEEDED, 3, {{0, 0, 1, 2, 2, 2, 4, 4, 3}, {}, {}, {}}};
+
+		void expectSame(const TrajectoryRecord& expected, const TrajectoryRecord& actual) {
+			EXPECT_EQ(expected.positionDimension, actual.positionDimension);
+			EXPECT_EQ(expected.controlDimension, actual.controlDimension);
+			EXPECT_EQ(expected.timeStepSize, actual.timeStepSize);
+			EXPECT_EQ(expected.timeStepSizes, actual.timeStepSizes);
+			EXPECT_EQ(expected.status, actual.status);
+			EXPECT_EQ(expected.objectiveValue, actual.objectiveValue);
+			EXPECT_EQ(expected.solution.x, actual.solution.x);
+			EXPECT_EQ(expected.solution.zLower, actual.solution.zLower);
+			EXPECT_EQ(expected.solution.zUpper, actual.solution.zUpper);
+			EXPECT_EQ(expected.solution.lambda, actual.solution.lambda);
+		}
+};
+
+TEST_F(trajectoryFileTest, RecordsRoundTrip) {
+	{
+		TrajectoryWriter writer(filename);
+		ASSERT_TRUE(writer.write(withMultipliers));
+		ASSERT_TRUE(writer.write(primalOnly));
+	}
+	const auto records = readFile(filename);
+	ASSERT_EQ(2u, records.size());
+	expectSame(withMultipliers, records[0]);
+	expectSame(primalOnly, records[1]);
+}
+
+TEST_F(trajectoryFileTest, AppendsToExistingFile) {
+	{
+		TrajectoryWriter writer(filename);
+		writer.write(withMultipliers);
+	}
+	{
+		TrajectoryWriter writer(filename, true);
+		writer.write(primalOnly);
+	}
+	const auto records = readFile(filename);
+	ASSERT_EQ(2u, records.size());
+	expectSame(primalOnly, records[1]);
+}
+
+TEST_F(trajectoryFileTest, CompactLayout) {
+	{
+		TrajectoryWriter writer(filename);
+		writer.write(withMultipliers);
+	}
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	// Header, x, zLower, zUpper and lambda
+	EXPECT_EQ(sizeof(RecordHeader) + (3 * 8 + 2) * sizeof(double), (size_t) file.tellg());
+}
+
+TEST_F(trajectoryFileTest, RejectsForeignData) {
+	std::stringstream stream;
+	stream << std::string(sizeof(RecordHeader) + 64, 'x');
+	TrajectoryRecord record;
+	EXPECT_FALSE(readRecord(stream, record));
+}
+
+TEST_F(trajectoryFileTest, CsvHasOneLinePerPoint) {
+	std::stringstream csv;
+	writeCsv(csv, {withMultipliers, primalOnly});
+	EXPECT_EQ("record,timeIndex,time,position0,velocity0,control0,control1\n"
+				"0,0,0,0,1,2,3\n"
+				"0,1,0.5,4,5,6,7\n"
+				"1,0,0,0,0,1,\n"
+				"1,1,0.25,2,2,2,\n"
+				"1,2,1,4,4,3,\n",
+				csv.str());
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include "trajectoryOptimization/trajectoryView.hpp"
+
+using namespace testing;
+using namespace trajectoryOptimization::trajectoryView;
+
+class trajectoryViewTest : public::testing::Test {
+	protected:
+		// Three knots of two positions, two velocities and one control
+		const unsigned numberOfPoints = 3;
+		const unsigned positionDimension = 2;
+		const unsigned controlDimension = 1;
+		std::vector<double> trajectory = std::vector<double>(15);
+
+		virtual void SetUp() {
+			std::iota(trajectory.begin(), trajectory.end(), 0);
+		}
+};
+
+TEST_F(trajectoryViewTest, SpansPointIntoKnot) {
+	const TrajectoryView view(trajectory.data(), numberOfPoints, positionDimension, controlDimension);
+	EXPECT_EQ(5u, view.getPointDimension());
+	EXPECT_EQ(15u, view.size());
+	EXPECT_THAT(view.point(1), ElementsAre(5, 6, 7, 8, 9));
+	EXPECT_THAT(view.position(1), ElementsAre(5, 6));
+	EXPECT_THAT(view.velocity(1), ElementsAre(7, 8));
+	EXPECT_THAT(view.control(1), ElementsAre(9));
+	EXPECT_EQ(trajectory.data() + 5, view.position(1).data());
+	EXPECT_EQ(13u, view.index(2, 3));
+}
+
+TEST_F(trajectoryViewTest, ComponentsStrideOverKnots) {
+	const TrajectoryView view(trajectory.data(), numberOfPoints, positionDimension, controlDimension);
+	EXPECT_THAT(view.positionComponent(1), ElementsAre(1, 6, 11));
+	EXPECT_THAT(view.velocityComponent(0), ElementsAre(2, 7, 12));
+	EXPECT_THAT(view.controlComponent(0), ElementsAre(4, 9, 14));
+
+	const auto control = view.controlComponent(0);
+	EXPECT_EQ(3, control.end() - control.begin());
+	EXPECT_DOUBLE_EQ(14, *std::max_element(control.begin(), control.end()));
+	EXPECT_DOUBLE_EQ(9, control.begin()[1]);
+}
+
+TEST_F(trajectoryViewTest, IteratesOverKnots) {
+	const TrajectoryView view(trajectory.data(), numberOfPoints, positionDimension, controlDimension);
+	unsigned expectedTimeIndex = 0;
+	for (const auto knot: view) {
+		EXPECT_EQ(expectedTimeIndex, knot.timeIndex);
+		EXPECT_DOUBLE_EQ(5 * expectedTimeIndex + 4, knot.control[0]);
+		expectedTimeIndex++;
+	}
+	EXPECT_EQ(numberOfPoints, expectedTimeIndex);
+}
+
+TEST_F(trajectoryViewTest, MutableViewWritesInPlace) {
+	const MutableTrajectoryView view(trajectory.data(), numberOfPoints, positionDimension, controlDimension);
+	for (double& control: view.controlComponent(0)) {
+		control = -1;
+	}
+	view.velocity(0)[1] = 100;
+	EXPECT_DOUBLE_EQ(-1, trajectory[9]);
+	EXPECT_DOUBLE_EQ(100, trajectory[3]);
+
+	const TrajectoryView readOnlyView = view;
+	EXPECT_THAT(readOnlyView.controlComponent(0), Each(-1));
+}
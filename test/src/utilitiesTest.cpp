@@ -1,11 +1,13 @@
 #include <gtest/gtest.h> 
 #include <gmock/gmock.h>
+#include <fstream>
 #include <vector>
 #include <range/v3/view.hpp>
 #include "trajectoryOptimization/utilities.hpp"
 ;
 using namespace testing;
 using namespace trajectoryOptimization::utilities;
+using namespace ranges;
 
 class utilitiesTest:public::Test{
 	protected:
@@ -77,6 +79,38 @@ TEST_F(utilitiesTest, getPointZeroPositionVelocityControl){
 	EXPECT_THAT(control, ElementsAre(5));
 }
 
+TEST_F(utilitiesTest, outputFilesSplitPointsWithFewerControls){
+	const std::string prefix = ::testing::TempDir() + "utilitiesTest_";
+	outputPositionVelocityControlToFiles(trajectoryPointer, 2, pointDimension, positionDimension,
+											(prefix + "position.txt").c_str(),
+											(prefix + "velocity.txt").c_str(),
+											(prefix + "control.txt").c_str());
+
+	const auto readFile = [](const std::string& filename) {
+		std::ifstream file(filename);
+		std::stringstream contents;
+		contents << file.rdbuf();
+		return contents.str();
+	};
+	EXPECT_EQ("0 0 \n1.5 2 \n", readFile(prefix + "position.txt"));
+	EXPECT_EQ("3 4 \n3.5 5 \n", readFile(prefix + "velocity.txt"));
+	EXPECT_EQ("5 \n1 \n", readFile(prefix + "control.txt"));
+}
+
+TEST_F(utilitiesTest, hermitePointIsExactForCubicsAndLinearAfter){
+	// s(t) = t^3 on [1, 3], slopes 3 and 27, the second value goes linearly from 0 to 4
+	const std::vector<double> now = {1, 0};
+	const std::vector<double> next = {27, 4};
+	const std::vector<double> nowSlope = {3};
+	const std::vector<double> nextSlope = {27};
+	const auto point = interpolateHermitePoint(now.data(), next.data(), nowSlope.data(), nextSlope.data(), 1, 2, 2, 0.25);
+	EXPECT_THAT(point, ElementsAre(DoubleNear(1.5 * 1.5 * 1.5, 1e-12), DoubleNear(1, 1e-12)));
+
+	const auto [interval, tau] = findInterval(getUniformKnotTimes(5, 2), 1.25);
+	EXPECT_EQ(2u, interval);
+	EXPECT_DOUBLE_EQ(0.5, tau);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();